@@ -3,8 +3,12 @@
 
 #include <benchmark/benchmark.h>
 
+#include "context_regular_mode_packed.h"
 #include "context_regular_mode_v220.h"
 
+#include <random>
+#include <vector>
+
 #pragma warning(disable : 26409) // Avoid calling new explicitly (triggered by BENCHMARK macro)
 #pragma warning(disable : 4746) // volatile access of 'reset_threshold' is subject to /volatile:<iso|ms> setting; (in ARM64 mode)
 
@@ -62,3 +66,95 @@ static void bm_regular_mode_get_golomb_coding_parameter(benchmark::State& state)
     }
 }
 BENCHMARK(bm_regular_mode_get_golomb_coding_parameter);
+
+
+namespace {
+
+struct context_access final
+{
+    size_t index;
+    int32_t error_value;
+};
+
+/// <summary>
+/// Creates the context accesses of a sample interleaved 8-bit image with component_count components:
+/// every pixel touches component_count (mostly different) contexts of the same array.
+/// </summary>
+std::vector<context_access> create_context_accesses(const size_t pixel_count, const size_t component_count)
+{
+    std::mt19937 generator(1);
+    std::binomial_distribution<int32_t> gradient_distribution(8, 0.5);
+    std::normal_distribution<double> error_distribution(0.0, 4.0);
+
+    std::vector<context_access> accesses;
+    accesses.reserve(pixel_count * component_count);
+    while (accesses.size() < pixel_count * component_count)
+    {
+        const int32_t qs{compute_context_id(gradient_distribution(generator) - 4, gradient_distribution(generator) - 4,
+                                            gradient_distribution(generator) - 4)};
+        if (qs == 0)
+            continue; // Run mode
+
+        accesses.push_back({static_cast<size_t>(std::abs(qs)), static_cast<int32_t>(error_distribution(generator))});
+    }
+
+    return accesses;
+}
+
+template<typename Context>
+void regular_mode_contexts_aos(benchmark::State& state)
+{
+    const auto accesses{create_context_accesses(512 * 512, static_cast<size_t>(state.range(0)))};
+    std::array<Context, 365> contexts;
+    contexts.fill(Context(256));
+
+    for (const auto _ : state)
+    {
+        int32_t sum{};
+        for (const auto& [index, error_value] : accesses)
+        {
+            Context& context{contexts[index]};
+            const int32_t k{context.compute_golomb_coding_parameter()};
+            sum += context.c() + context.get_error_correction(k) + k;
+            context.update_variables_and_bias(error_value, near_lossless, reset_threshold);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+} // namespace
+
+/// <summary>
+/// Benchmarks the regular mode context access pattern of the triplet (3) and quad (4) sample interleaved lines.
+/// Compares the array of structures layout (current), a structure of arrays and a 16-bit packed layout.
+/// </summary>
+static void bm_regular_mode_contexts_aos(benchmark::State& state)
+{
+    regular_mode_contexts_aos<regular_mode_context>(state);
+}
+BENCHMARK(bm_regular_mode_contexts_aos)->Arg(3)->Arg(4);
+
+static void bm_regular_mode_contexts_packed(benchmark::State& state)
+{
+    regular_mode_contexts_aos<regular_mode_context_packed>(state);
+}
+BENCHMARK(bm_regular_mode_contexts_packed)->Arg(3)->Arg(4);
+
+static void bm_regular_mode_contexts_soa(benchmark::State& state)
+{
+    const auto accesses{create_context_accesses(512 * 512, static_cast<size_t>(state.range(0)))};
+    regular_mode_contexts_soa contexts(256);
+
+    for (const auto _ : state)
+    {
+        int32_t sum{};
+        for (const auto& [index, error_value] : accesses)
+        {
+            const int32_t k{contexts.compute_golomb_coding_parameter(index)};
+            sum += contexts.c(index) + contexts.get_error_correction(index, k) + k;
+            contexts.update_variables_and_bias(index, error_value, near_lossless, reset_threshold);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+BENCHMARK(bm_regular_mode_contexts_soa)->Arg(3)->Arg(4);
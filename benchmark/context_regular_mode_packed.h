@@ -0,0 +1,210 @@
+// SPDX-FileCopyrightText: © 2026 Team CharLS
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "../src/regular_mode_context.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace charls {
+
+/// <summary>
+/// Experimental structure-of-arrays (SoA) layout of the 365 regular mode contexts.
+/// A, B, C and N are stored in separate arrays. C and N are not needed to compute k and are only touched by the update.
+/// </summary>
+class regular_mode_contexts_soa final
+{
+public:
+    explicit regular_mode_contexts_soa(const int32_t range) noexcept
+    {
+        a_.fill(initialization_value_for_a(range));
+        n_.fill(1);
+    }
+
+    [[nodiscard]]
+    FORCE_INLINE int32_t c(const size_t index) const noexcept
+    {
+        return c_[index];
+    }
+
+    [[nodiscard]]
+    FORCE_INLINE int32_t get_error_correction(const size_t index, const int32_t k) const noexcept
+    {
+        if (k != 0)
+            return 0;
+
+        return bit_wise_sign(2 * b_[index] + n_[index] - 1);
+    }
+
+    /// <summary>Code segment A.12 – Variables update. ISO 14495-1, page 22</summary>
+    FORCE_INLINE void update_variables_and_bias(const size_t index, const int32_t error_value, const int32_t near_lossless,
+                                                const int32_t reset_threshold)
+    {
+        int32_t a{a_[index] + std::abs(error_value)};
+        int32_t b{b_[index] + error_value * (2 * near_lossless + 1)};
+        int32_t n{n_[index]};
+
+        if (constexpr int limit{65536 * 256}; UNLIKELY(a >= limit || std::abs(b) >= limit))
+            impl::throw_jpegls_error(jpegls_errc::invalid_data);
+
+        if (UNLIKELY(n == reset_threshold))
+        {
+            a >>= 1;
+            b >>= 1;
+            n >>= 1;
+        }
+
+        ++n;
+        a_[index] = a;
+        n_[index] = n;
+
+        if (UNLIKELY(b + n <= 0))
+        {
+            b += n;
+            if (UNLIKELY(b <= -n))
+            {
+                b = -n + 1;
+            }
+            c_[index] -= static_cast<int32_t>(c_[index] > -128);
+        }
+        else if (UNLIKELY(b > 0))
+        {
+            b -= n;
+            if (UNLIKELY(b > 0))
+            {
+                b = 0;
+            }
+            c_[index] += static_cast<int32_t>(c_[index] < 127);
+        }
+        b_[index] = b;
+    }
+
+    [[nodiscard]]
+    FORCE_INLINE int32_t compute_golomb_coding_parameter(const size_t index) const
+    {
+        const int32_t a{a_[index]};
+        const int32_t n{n_[index]};
+
+        int32_t k{};
+        for (; n << k < a && k < max_k_value; ++k)
+        {
+        }
+
+        if (UNLIKELY(k == max_k_value))
+            impl::throw_jpegls_error(jpegls_errc::invalid_data);
+
+        return k;
+    }
+
+private:
+    std::array<int32_t, 365> a_{};
+    std::array<int32_t, 365> b_{};
+    std::array<int32_t, 365> c_{};
+    std::array<int32_t, 365> n_{};
+};
+
+
+/// <summary>
+/// Experimental 16-bit packed regular mode context: 8 bytes instead of 16, 8 contexts fit in a cache line.
+/// </summary>
+/// <remarks>
+/// Only valid when the ranges of the spec allow it: |B| < N <= RESET and -128 <= C <= 127 always fit,
+/// A stays below 2 * RESET * (RANGE / 2) which fits in 16 bits for 8-bit lossless with the default RESET of 64.
+/// </remarks>
+class regular_mode_context_packed final
+{
+public:
+    regular_mode_context_packed() = default;
+
+    explicit regular_mode_context_packed(const int32_t range) noexcept :
+        a_{static_cast<uint16_t>(initialization_value_for_a(range))}
+    {
+    }
+
+    [[nodiscard]]
+    FORCE_INLINE int32_t c() const noexcept
+    {
+        return c_;
+    }
+
+    [[nodiscard]]
+    FORCE_INLINE int32_t get_error_correction(const int32_t k) const noexcept
+    {
+        if (k != 0)
+            return 0;
+
+        return bit_wise_sign(2 * b_ + n_ - 1);
+    }
+
+    /// <summary>Code segment A.12 – Variables update. ISO 14495-1, page 22</summary>
+    FORCE_INLINE void update_variables_and_bias(const int32_t error_value, const int32_t near_lossless,
+                                                const int32_t reset_threshold)
+    {
+        int32_t a{a_ + std::abs(error_value)};
+        int32_t b{b_ + error_value * (2 * near_lossless + 1)};
+        int32_t n{n_};
+
+        if (constexpr int limit{65536}; UNLIKELY(a >= limit))
+            impl::throw_jpegls_error(jpegls_errc::invalid_data);
+
+        if (UNLIKELY(n == reset_threshold))
+        {
+            a >>= 1;
+            b >>= 1;
+            n >>= 1;
+        }
+
+        ++n;
+        a_ = static_cast<uint16_t>(a);
+        n_ = static_cast<uint16_t>(n);
+
+        if (UNLIKELY(b + n <= 0))
+        {
+            b += n;
+            if (UNLIKELY(b <= -n))
+            {
+                b = -n + 1;
+            }
+            c_ = static_cast<int16_t>(c_ - static_cast<int16_t>(c_ > -128));
+        }
+        else if (UNLIKELY(b > 0))
+        {
+            b -= n;
+            if (UNLIKELY(b > 0))
+            {
+                b = 0;
+            }
+            c_ = static_cast<int16_t>(c_ + static_cast<int16_t>(c_ < 127));
+        }
+        b_ = static_cast<int16_t>(b);
+    }
+
+    [[nodiscard]]
+    FORCE_INLINE int32_t compute_golomb_coding_parameter() const
+    {
+        const int32_t a{a_};
+        const int32_t n{n_};
+
+        int32_t k{};
+        for (; n << k < a && k < max_k_value; ++k)
+        {
+        }
+
+        if (UNLIKELY(k == max_k_value))
+            impl::throw_jpegls_error(jpegls_errc::invalid_data);
+
+        return k;
+    }
+
+private:
+    uint16_t a_{};
+    int16_t b_{};
+    int16_t c_{};
+    uint16_t n_{1};
+};
+
+static_assert(sizeof(regular_mode_context_packed) == 8);
+
+} // namespace charls
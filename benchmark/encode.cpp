@@ -0,0 +1,259 @@
+// SPDX-FileCopyrightText: © 2026 Team CharLS
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <benchmark/benchmark.h>
+
+#include "../include/charls/charls.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#pragma warning(disable : 26409) // Avoid calling new explicitly (triggered by BENCHMARK macro)
+
+using namespace charls;
+using std::byte;
+using std::vector;
+
+namespace {
+
+constexpr uint32_t width{2048};
+constexpr uint32_t height{1024};
+
+/// <summary>
+/// Creates a smooth image with noise, comparable to a photographic or medical image.
+/// </summary>
+vector<uint16_t> create_test_image(const int32_t bits_per_sample)
+{
+    std::mt19937 generator(1);
+    std::normal_distribution<double> noise(0.0, std::ldexp(6.0, bits_per_sample - 8));
+    const int32_t maximum_sample_value{(1 << bits_per_sample) - 1};
+
+    vector<uint16_t> image(static_cast<size_t>(width) * height);
+    for (uint32_t y{}; y != height; ++y)
+    {
+        for (uint32_t x{}; x != width; ++x)
+        {
+            const double value{(maximum_sample_value / 2.0) * (1.0 + (0.8 * std::sin(x * 0.01) * std::cos(y * 0.013))) +
+                               noise(generator)};
+            image[(static_cast<size_t>(y) * width) + x] =
+                static_cast<uint16_t>(std::clamp(static_cast<int32_t>(value), 0, maximum_sample_value));
+        }
+    }
+
+    return image;
+}
+
+vector<byte> create_source(const int32_t bits_per_sample, const int32_t component_count = 1)
+{
+    const vector<uint16_t> monochrome_image{create_test_image(bits_per_sample)};
+
+    // Sample interleaved components: every component is the monochrome image with a small offset.
+    vector<uint16_t> image(monochrome_image.size() * component_count);
+    const int32_t maximum_sample_value{(1 << bits_per_sample) - 1};
+    for (size_t i{}; i != image.size(); ++i)
+    {
+        const auto offset{static_cast<int32_t>(i % component_count) << (bits_per_sample - 4)};
+        image[i] = static_cast<uint16_t>(std::min(monochrome_image[i / component_count] + offset, maximum_sample_value));
+    }
+
+    if (bits_per_sample > 8)
+        return {reinterpret_cast<const byte*>(image.data()), reinterpret_cast<const byte*>(image.data() + image.size())};
+
+    vector<byte> source(image.size());
+    for (size_t i{}; i != image.size(); ++i)
+    {
+        source[i] = static_cast<byte>(image[i]);
+    }
+
+    return source;
+}
+
+} // namespace
+
+
+static void bm_encode(benchmark::State& state)
+{
+    const auto bits_per_sample{static_cast<int32_t>(state.range(0))};
+    const vector<byte> source{create_source(bits_per_sample)};
+    const frame_info frame{width, height, bits_per_sample, 1};
+
+    // Pre-allocate the destination outside the measurement loop.
+    vector<byte> destination(jpegls_encoder{}.frame_info(frame).estimated_destination_size());
+
+    for (const auto _ : state)
+    {
+        jpegls_encoder encoder;
+        encoder.frame_info(frame).destination(destination);
+        benchmark::DoNotOptimize(encoder.encode(source));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+}
+BENCHMARK(bm_encode)->Arg(8)->Arg(10)->Arg(12)->Arg(16);
+
+
+static void bm_encode_sample_interleaved(benchmark::State& state)
+{
+    const auto bits_per_sample{static_cast<int32_t>(state.range(0))};
+    const auto component_count{static_cast<int32_t>(state.range(1))};
+    const vector<byte> source{create_source(bits_per_sample, component_count)};
+    const frame_info frame{width, height, bits_per_sample, component_count};
+
+    vector<byte> destination(
+        jpegls_encoder{}.frame_info(frame).interleave_mode(interleave_mode::sample).estimated_destination_size());
+
+    for (const auto _ : state)
+    {
+        jpegls_encoder encoder;
+        encoder.frame_info(frame).interleave_mode(interleave_mode::sample).destination(destination);
+        benchmark::DoNotOptimize(encoder.encode(source));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+}
+BENCHMARK(bm_encode_sample_interleaved)
+    ->Args({8, 3})
+    ->Args({10, 3})
+    ->Args({12, 3})
+    ->Args({16, 3})
+    ->Args({10, 2})
+    ->Args({10, 4})
+    ->Args({12, 4});
+
+
+static void bm_decode_sample_interleaved(benchmark::State& state)
+{
+    const auto bits_per_sample{static_cast<int32_t>(state.range(0))};
+    const auto component_count{static_cast<int32_t>(state.range(1))};
+    const vector<byte> source{create_source(bits_per_sample, component_count)};
+
+    jpegls_encoder encoder;
+    encoder.frame_info({width, height, bits_per_sample, component_count}).interleave_mode(interleave_mode::sample);
+    vector<byte> encoded(encoder.estimated_destination_size());
+    encoder.destination(encoded);
+    encoded.resize(encoder.encode(source));
+
+    vector<byte> destination(source.size());
+    for (const auto _ : state)
+    {
+        jpegls_decoder decoder(encoded, true);
+        decoder.decode(destination);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+}
+BENCHMARK(bm_decode_sample_interleaved)
+    ->Args({8, 3})
+    ->Args({10, 3})
+    ->Args({12, 3})
+    ->Args({16, 3})
+    ->Args({10, 2})
+    ->Args({10, 4})
+    ->Args({12, 4});
+
+
+static void bm_encode_near_lossless(benchmark::State& state)
+{
+    const auto bits_per_sample{static_cast<int32_t>(state.range(0))};
+    const auto near_lossless{static_cast<int32_t>(state.range(1))};
+    const vector<byte> source{create_source(bits_per_sample)};
+    const frame_info frame{width, height, bits_per_sample, 1};
+
+    vector<byte> destination(jpegls_encoder{}.frame_info(frame).estimated_destination_size());
+
+    for (const auto _ : state)
+    {
+        jpegls_encoder encoder;
+        encoder.frame_info(frame).near_lossless(near_lossless).destination(destination);
+        benchmark::DoNotOptimize(encoder.encode(source));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+}
+BENCHMARK(bm_encode_near_lossless)
+    ->Args({8, 1})
+    ->Args({8, 3})
+    ->Args({16, 2})
+    ->Args({8, 4})
+    ->Args({10, 2})
+    ->Args({12, 3});
+
+
+static void bm_decode_near_lossless(benchmark::State& state)
+{
+    const auto bits_per_sample{static_cast<int32_t>(state.range(0))};
+    const auto near_lossless{static_cast<int32_t>(state.range(1))};
+    const vector<byte> source{create_source(bits_per_sample)};
+
+    jpegls_encoder encoder;
+    encoder.frame_info({width, height, bits_per_sample, 1}).near_lossless(near_lossless);
+    vector<byte> encoded(encoder.estimated_destination_size());
+    encoder.destination(encoded);
+    encoded.resize(encoder.encode(source));
+
+    vector<byte> destination(source.size());
+    for (const auto _ : state)
+    {
+        jpegls_decoder decoder(encoded, true);
+        decoder.decode(destination);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+}
+BENCHMARK(bm_decode_near_lossless)
+    ->Args({8, 1})
+    ->Args({8, 3})
+    ->Args({16, 2})
+    ->Args({8, 4})
+    ->Args({10, 2})
+    ->Args({12, 3});
+
+
+static void bm_encode_restart_intervals(benchmark::State& state)
+{
+    const auto thread_count{static_cast<uint32_t>(state.range(0))};
+    const vector<byte> source{create_source(16)};
+    const frame_info frame{width, height, 16, 1};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame).restart_interval(64).thread_count(thread_count);
+    vector<byte> destination(encoder.estimated_destination_size());
+
+    for (const auto _ : state)
+    {
+        encoder.rewind();
+        encoder.destination(destination);
+        benchmark::DoNotOptimize(encoder.encode(source));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+}
+BENCHMARK(bm_encode_restart_intervals)->Arg(1)->Arg(0);
+
+static void bm_encode_batch(benchmark::State& state)
+{
+    const auto thread_count{static_cast<uint32_t>(state.range(0))};
+    const vector<byte> source{create_source(8)};
+    constexpr size_t item_count{16};
+
+    jpegls_encoder encoder;
+    encoder.thread_count(thread_count);
+    vector<vector<byte>> destinations(item_count, vector<byte>(source.size() * 2));
+    vector<batch_item> items(item_count);
+    for (size_t i{}; i != item_count; ++i)
+    {
+        items[i] = {source.data(), source.size(), destinations[i].data(), destinations[i].size(), 0,
+                    {width, height, 8, 1}, 0, {}};
+    }
+
+    for (const auto _ : state)
+    {
+        encoder.encode_batch(items);
+        benchmark::DoNotOptimize(items[0].bytes_written);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size() * item_count));
+}
+BENCHMARK(bm_encode_batch)->Arg(1)->Arg(0);
@@ -5,76 +5,127 @@
 
 #include "../src/golomb_lut.hpp"
 #include "../src/jpegls_algorithm.hpp"
-#include "../src/conditional_static_cast.hpp"
+
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
 
 #pragma warning(disable : 26409) // Avoid calling new explicitly (triggered by BENCHMARK macro)
 
 using namespace charls;
+using std::vector;
+
+namespace {
 
-static std::pair<int32_t, int32_t> create_encoded_value(const int32_t k, const int32_t mapped_error) noexcept
+template<size_t BitCount>
+using golomb_lut_tables = std::array<golomb_code_match_table<BitCount>, max_k_value>;
+
+template<size_t BitCount, size_t... K>
+std::unique_ptr<golomb_lut_tables<BitCount>> create_golomb_lut(std::index_sequence<K...> /*k_values*/)
 {
-    const int32_t high_bits{mapped_error >> k};
-    return std::make_pair(high_bits + k + 1, (1 << k) | (mapped_error & ((1 << k) - 1)));
+    return std::make_unique<golomb_lut_tables<BitCount>>(
+        golomb_lut_tables<BitCount>{golomb_code_match_table<BitCount>(static_cast<int32_t>(K))...});
 }
 
-golomb_code_match_table::golomb_code_match_table(const int32_t k)
+template<size_t BitCount>
+std::unique_ptr<golomb_lut_tables<BitCount>> create_golomb_lut()
 {
-    for (int16_t error_value{};; ++error_value)
-    {
-        // Q is not used when k != 0
-        const int32_t mapped_error_value{map_error_value(error_value)};
-        const auto [code_length, table_value]{create_encoded_value(k, mapped_error_value)};
-        if (static_cast<size_t>(code_length) > byte_bit_count)
-            break;
-
-        const golomb_code_match code{error_value, code_length};
-        add_entry(static_cast<uint8_t>(table_value), code);
-    }
+    return create_golomb_lut<BitCount>(std::make_index_sequence<max_k_value>{});
+}
 
-    for (int16_t error_value{-1};; --error_value)
+struct golomb_code final
+{
+    int32_t k;
+    int32_t bit_count;
+    uint64_t bits; // The code, left aligned.
+};
+
+/// <summary>
+/// Creates the Golomb codes of a low-entropy 8-bit image: small k values and (mostly) small error values.
+/// </summary>
+vector<golomb_code> create_golomb_codes(const double error_deviation)
+{
+    std::mt19937 generator(1);
+    std::normal_distribution<double> error_distribution(0.0, error_deviation);
+    std::uniform_int_distribution<int32_t> k_distribution(0, 2);
+
+    vector<golomb_code> codes(size_t{1} << 16);
+    for (auto& code : codes)
     {
-        // Q is not used when k != 0
-        const int32_t mapped_error_value{map_error_value(error_value)};
-        const auto [code_length, table_value]{create_encoded_value(k, mapped_error_value)};
-        if (static_cast<size_t>(code_length) > byte_bit_count)
-            break;
-
-        const golomb_code_match code{error_value, code_length};
-        add_entry(static_cast<uint8_t>(table_value), code);
+        code.k = k_distribution(generator);
+
+        int32_t mapped_error_value;
+        do
+        {
+            // Skip the error values that require an escape code: these are rare and not relevant for the table size.
+            mapped_error_value = map_error_value(static_cast<int32_t>(error_distribution(generator)));
+        } while ((mapped_error_value >> code.k) >= 23);
+
+        code.bit_count = (mapped_error_value >> code.k) + code.k + 1;
+        const uint64_t value{(uint64_t{1} << code.k) | (static_cast<uint64_t>(mapped_error_value) & ((1U << code.k) - 1))};
+        code.bits = value << (64 - code.bit_count);
     }
+
+    return codes;
 }
 
-constexpr void golomb_code_match_table::add_entry(const uint8_t value, const golomb_code_match code) noexcept
+/// <summary>
+/// Benchmark to measure the time to resolve Golomb codes with a lookup table of BitCount bits.
+/// The wider tables resolve more codes with a single lookup, but have a larger cache footprint (2^BitCount * 4 bytes
+/// for every value of k): the slow path is emulated by counting the zero bits.
+/// </summary>
+template<size_t BitCount>
+void bm_golomb_lut_lookup(benchmark::State& state)
 {
-    ASSERT(static_cast<size_t>(code.bit_count) <= byte_bit_count);
+    const auto tables{create_golomb_lut<BitCount>()};
+    const vector<golomb_code> codes{create_golomb_codes(static_cast<double>(state.range(0)))};
 
-    for (size_t i{}; i < conditional_static_cast<size_t>(1U) << (byte_bit_count - code.bit_count); ++i)
+    size_t table_hit_count{};
+    for (const auto _ : state)
     {
-        const size_t index{(static_cast<size_t>(value) << (byte_bit_count - code.bit_count)) + i};
-        ASSERT(matches_[index].bit_count == 0);
-        matches_[index] = code;
+        int32_t sum{};
+        for (const auto& code : codes)
+        {
+            if (const golomb_code_match match{(*tables)[static_cast<size_t>(code.k)].get(code.bits >> (64 - BitCount))};
+                LIKELY(match.bit_count != 0))
+            {
+                sum += match.error_value;
+                ++table_hit_count;
+            }
+            else
+            {
+                const int32_t unary_code{countl_zero(code.bits)};
+                const uint64_t remainder{code.k == 0 ? 0 : (code.bits << (unary_code + 1)) >> (64 - code.k)};
+                sum += unmap_error_value((unary_code << code.k) + static_cast<int32_t>(remainder));
+            }
+        }
+        benchmark::DoNotOptimize(sum);
     }
+
+    state.counters["table_hits"] = benchmark::Counter(
+        static_cast<double>(table_hit_count) / static_cast<double>(codes.size() * state.iterations()));
 }
 
-std::array<golomb_code_match_table, max_k_value> golomb_lut2{
-    golomb_code_match_table(0),  golomb_code_match_table(1),  golomb_code_match_table(2),  golomb_code_match_table(3),
-    golomb_code_match_table(4),  golomb_code_match_table(5),  golomb_code_match_table(6),  golomb_code_match_table(7),
-    golomb_code_match_table(8),  golomb_code_match_table(9),  golomb_code_match_table(10), golomb_code_match_table(11),
-    golomb_code_match_table(12), golomb_code_match_table(13), golomb_code_match_table(14), golomb_code_match_table(15)};
+} // namespace
 
 
 /// <summary>
 /// Benchmark to measure how long it takes to initialize the golomb_code_match table at startup.
 /// Information is useful to decide if initialization should be done at startup or at compile time (constexpr)
 /// </summary>
+template<size_t BitCount>
 static void bm_initialize_golomb_lut(benchmark::State& state)
 {
     for (const auto _ : state)
     {
-        for (int i = 0; i < max_k_value; ++i)
-        {
-            golomb_lut2[static_cast<size_t>(i)] = golomb_code_match_table(i);
-        }
+        benchmark::DoNotOptimize(create_golomb_lut<BitCount>());
     }
 }
-BENCHMARK(bm_initialize_golomb_lut);
+BENCHMARK_TEMPLATE(bm_initialize_golomb_lut, 8);
+BENCHMARK_TEMPLATE(bm_initialize_golomb_lut, 11);
+BENCHMARK_TEMPLATE(bm_initialize_golomb_lut, 12);
+
+BENCHMARK_TEMPLATE(bm_golomb_lut_lookup, 8)->Arg(2)->Arg(8)->Arg(20);
+BENCHMARK_TEMPLATE(bm_golomb_lut_lookup, 11)->Arg(2)->Arg(8)->Arg(20);
+BENCHMARK_TEMPLATE(bm_golomb_lut_lookup, 12)->Arg(2)->Arg(8)->Arg(20);
@@ -14,8 +14,10 @@
 #define CHARLS_IN_OPT _In_opt_
 #define CHARLS_IN_Z _In_z_
 #define CHARLS_IN_READS_BYTES(size) _In_reads_bytes_(size)
+#define CHARLS_IN_OUT_UPDATES(size) _Inout_updates_(size)
 #define CHARLS_OUT _Out_
 #define CHARLS_OUT_OPT _Out_opt_
+#define CHARLS_OUT_WRITES(size) _Out_writes_(size)
 #define CHARLS_OUT_WRITES_BYTES(size) _Out_writes_bytes_(size)
 #define CHARLS_OUT_WRITES_Z(size_in_bytes) _Out_writes_z_(size_in_bytes)
 #define CHARLS_RETURN_TYPE_SUCCESS(expr) _Return_type_success_(expr)
@@ -35,8 +37,10 @@
 #define CHARLS_IN_OPT
 #define CHARLS_IN_Z
 #define CHARLS_IN_READS_BYTES(size)
+#define CHARLS_IN_OUT_UPDATES(size)
 #define CHARLS_OUT
 #define CHARLS_OUT_OPT
+#define CHARLS_OUT_WRITES(size)
 #define CHARLS_OUT_WRITES_BYTES(size)
 #define CHARLS_OUT_WRITES_Z(size_in_bytes)
 #define CHARLS_RETURN_TYPE_SUCCESS(expr)
@@ -24,6 +24,22 @@ typedef struct charls_jpegls_decoder charls_jpegls_decoder;
 CHARLS_CHECK_RETURN CHARLS_RET_MAY_BE_NULL CHARLS_API_IMPORT_EXPORT charls_jpegls_decoder*
     CHARLS_API_CALLING_CONVENTION charls_jpegls_decoder_create(CHARLS_C_VOID) CHARLS_NOEXCEPT;
 
+/// <summary>
+/// Creates a JPEG-LS decoder instance that allocates all its memory with the passed allocation functions.
+/// When finished with the instance destroy it with the function charls_jpegls_decoder_destroy.
+/// </summary>
+/// <remarks>
+/// The decoder instance itself, its internal buffers and the scan codecs are allocated with these functions.
+/// Multithreaded decoding may still use the global heap for thread bookkeeping.
+/// </remarks>
+/// <param name="allocate">Function that will be called to allocate memory.</param>
+/// <param name="deallocate">Function that will be called to release memory.</param>
+/// <param name="user_context">Free to use context information that will be passed to the allocation functions.</param>
+/// <returns>A reference to a new created decoder instance, or a null pointer when the creation fails.</returns>
+CHARLS_CHECK_RETURN CHARLS_RET_MAY_BE_NULL CHARLS_API_IMPORT_EXPORT charls_jpegls_decoder* CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_create_with_allocator(charls_allocate_handler allocate, charls_deallocate_handler deallocate,
+                                           void* user_context) CHARLS_NOEXCEPT;
+
 /// <summary>
 /// Destroys a JPEG-LS decoder instance created with charls_jpegls_decoder_create and releases all internal resources
 /// attached to it.
@@ -46,6 +62,26 @@ charls_jpegls_decoder_set_source_buffer(CHARLS_IN charls_jpegls_decoder* decoder
                                         CHARLS_IN_READS_BYTES(source_size_bytes) const void* source_buffer,
                                         size_t source_size_bytes) CHARLS_NOEXCEPT;
 
+/// <summary>
+/// Appends a chunk of the encoded JPEG-LS byte stream data to the source of the decoder (incremental decoding).
+/// The data is copied into a buffer owned by the decoder, the passed buffer doesn't need to remain valid.
+/// </summary>
+/// <remarks>
+/// Incremental decoding allows to decode a JPEG-LS byte stream while it is being received.
+/// The header functions return charls_jpegls_errc_need_more_data when not all header segments are available.
+/// Use charls_jpegls_decoder_decode_available_to_buffer to decode the lines that have been received.
+/// This function cannot be combined with charls_jpegls_decoder_set_source_buffer.
+/// </remarks>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <param name="source_buffer">Reference to the start of the source chunk.</param>
+/// <param name="source_size_bytes">Size of the source chunk in bytes.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_ATTRIBUTE_ACCESS((access(read_only, 2, 3)))
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_append_source_buffer(CHARLS_IN charls_jpegls_decoder* decoder,
+                                           CHARLS_IN_READS_BYTES(source_size_bytes) const void* source_buffer,
+                                           size_t source_size_bytes) CHARLS_NOEXCEPT;
+
 /// <summary>
 /// Tries to read the SPIFF header from the source buffer.
 /// If a SPIFF header exists its content will be put into the spiff_header parameter and header_found will be set to 1.
@@ -151,6 +187,31 @@ CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLI
 charls_jpegls_decoder_get_destination_size(CHARLS_IN const charls_jpegls_decoder* decoder, uint32_t stride,
                                            CHARLS_OUT size_t* destination_size_bytes) CHARLS_NOEXCEPT;
 
+/// <summary>
+/// Configures the maximum number of threads the decoder may use.
+/// Images encoded with multiple scans and scans that are divided in multiple restart intervals can be decoded with
+/// multiple threads. Other scans with interleave mode line or sample convert the decoded lines on a second thread.
+/// </summary>
+/// <remarks>
+/// The default is 1, which means that decoding is done on the calling thread.
+/// The number of threads that decode parts of the image concurrently is limited to the number of hardware threads.
+/// </remarks>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <param name="thread_count">Maximum number of threads to use, 0 means use all available hardware threads.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_set_thread_count(CHARLS_IN charls_jpegls_decoder* decoder, uint32_t thread_count) CHARLS_NOEXCEPT;
+
+/// <summary>
+/// Resets the decoder to its initial state, ready to decode the next JPEG-LS byte stream.
+/// Installed callbacks and the thread count will not be changed. Internal buffers are kept and reused when the next
+/// image has the same properties, which avoids memory allocations when many small images are decoded.
+/// </summary>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_reset(CHARLS_IN charls_jpegls_decoder* decoder) CHARLS_NOEXCEPT;
+
 /// <summary>
 /// Will decode the JPEG-LS byte stream from the source buffer into the destination buffer.
 /// </summary>
@@ -171,6 +232,109 @@ charls_jpegls_decoder_decode_to_buffer(CHARLS_IN charls_jpegls_decoder* decoder,
                                        CHARLS_OUT_WRITES_BYTES(destination_size_bytes) void* destination_buffer,
                                        size_t destination_size_bytes, uint32_t stride) CHARLS_NOEXCEPT;
 
+/// <summary>
+/// Decodes a batch of JPEG-LS byte streams, every image to its own destination buffer.
+/// The images are decoded concurrently when the thread count allows it; every thread reuses its internal codec and
+/// buffers for the images it decodes.
+/// </summary>
+/// <remarks>
+/// The source, destination and stride of every image are passed in its batch item. The frame info of the image, the
+/// result and the number of decoded bytes are stored in its item: the function only fails when the arguments are
+/// invalid. The decoder itself is not changed and its installed callbacks are not called.
+/// </remarks>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <param name="items">Array with the images to decode.</param>
+/// <param name="item_count">Number of elements in the items array.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_decode_batch(CHARLS_IN const charls_jpegls_decoder* decoder,
+                                   CHARLS_IN_OUT_UPDATES(item_count) charls_batch_item* items,
+                                   size_t item_count) CHARLS_NOEXCEPT;
+
+/// <summary>
+/// Decodes the lines of the image for which the encoded data has been appended (incremental decoding).
+/// </summary>
+/// <remarks>
+/// Function should be called after calling the functions charls_jpegls_decoder_append_source_buffer and
+/// charls_jpegls_decoder_read_header. It can be called again after more source data has been appended, with the same
+/// destination buffer: decoding continues at the first line that has not been decoded yet.
+/// </remarks>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <param name="destination_buffer">Byte array that holds the decoded lines when the function returns.</param>
+/// <param name="destination_size_bytes">
+/// Length of the array in bytes. If the array is too small the function will return an error.
+/// </param>
+/// <param name="stride">
+/// Number of bytes to the next line in the buffer, when zero, decoder will compute it.
+/// </param>
+/// <param name="decoded_line_count">
+/// Total number of lines that have been decoded. Images encoded with interleave mode none store each component in
+/// its own scan; the lines of all scans are counted.
+/// </param>
+/// <returns>
+/// Success when the complete image has been decoded, charls_jpegls_errc_need_more_data when more source data is
+/// needed or a failure code.
+/// </returns>
+CHARLS_ATTRIBUTE_ACCESS((access(write_only, 2, 3)))
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_decode_available_to_buffer(CHARLS_IN charls_jpegls_decoder* decoder,
+                                                 CHARLS_OUT_WRITES_BYTES(destination_size_bytes) void* destination_buffer,
+                                                 size_t destination_size_bytes, uint32_t stride,
+                                                 CHARLS_OUT uint32_t* decoded_line_count) CHARLS_NOEXCEPT;
+
+/// <summary>
+/// Will decode the JPEG-LS byte stream from the source buffer and pass the decoded lines in batches to a handler.
+/// </summary>
+/// <remarks>
+/// Function should be called after calling the function charls_jpegls_decoder_read_header.
+/// The lines are decoded into a buffer owned by the decoder that is reused for the next batch: only the memory for
+/// lines_per_call lines is needed instead of a buffer for the complete image.
+/// Images encoded with interleave mode none are passed one component at a time.
+/// The callback should return 0 if there are no errors.
+/// It can return a non-zero value to abort decoding with a callback_failed error code.
+/// </remarks>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <param name="lines_per_call">Maximum number of lines that will be passed in a single call to the handler.</param>
+/// <param name="handler">Function pointer to the callback function.</param>
+/// <param name="user_context">Free to use context data that will be provided to the callback function.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_decode_to_line_handler(CHARLS_IN charls_jpegls_decoder* decoder, uint32_t lines_per_call,
+                                             CHARLS_IN charls_at_decoded_lines_handler handler,
+                                             void* user_context) CHARLS_NOEXCEPT;
+
+/// <summary>
+/// Will decode a rectangle of the image from the JPEG-LS byte stream into the destination buffer.
+/// </summary>
+/// <remarks>
+/// Function should be called after calling the function charls_jpegls_decoder_read_header.
+/// The destination buffer receives only the pixels of the rectangle; images encoded with interleave mode none are
+/// stored as a plane of width x height samples per component.
+/// Decoding of a scan stops after the last line of the rectangle. When the image is encoded with restart intervals,
+/// decoding starts at the restart interval that holds the first line of the rectangle.
+/// The encoded data outside the decoded lines is not validated.
+/// </remarks>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <param name="x">The first column of the rectangle.</param>
+/// <param name="y">The first line of the rectangle.</param>
+/// <param name="width">The width of the rectangle in pixels.</param>
+/// <param name="height">The height of the rectangle in lines.</param>
+/// <param name="destination_buffer">
+/// Byte array that holds the decoded pixels of the rectangle when the function returns.
+/// </param>
+/// <param name="destination_size_bytes">
+/// Length of the array in bytes. If the array is too small the function will return an error.
+/// </param>
+/// <param name="stride">
+/// Number of bytes to the next line of the rectangle in the buffer, when zero, decoder will compute it.
+/// </param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_ATTRIBUTE_ACCESS((access(write_only, 6, 7)))
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_decode_rect(CHARLS_IN charls_jpegls_decoder* decoder, uint32_t x, uint32_t y, uint32_t width,
+                                  uint32_t height, CHARLS_OUT_WRITES_BYTES(destination_size_bytes) void* destination_buffer,
+                                  size_t destination_size_bytes, uint32_t stride) CHARLS_NOEXCEPT;
+
 /// <summary>
 /// Will install a function that will be called when a comment (COM) segment is found.
 /// </summary>
@@ -24,6 +24,22 @@ typedef struct charls_jpegls_encoder charls_jpegls_encoder;
 CHARLS_CHECK_RETURN CHARLS_RET_MAY_BE_NULL CHARLS_API_IMPORT_EXPORT charls_jpegls_encoder*
     CHARLS_API_CALLING_CONVENTION charls_jpegls_encoder_create(CHARLS_C_VOID) CHARLS_NOEXCEPT;
 
+/// <summary>
+/// Creates a JPEG-LS encoder instance that allocates all its memory with the passed allocation functions.
+/// When finished with the instance destroy it with the function charls_jpegls_encoder_destroy.
+/// </summary>
+/// <remarks>
+/// The encoder instance itself, its internal buffers and the scan codecs are allocated with these functions.
+/// Multithreaded encoding may still use the global heap for thread bookkeeping.
+/// </remarks>
+/// <param name="allocate">Function that will be called to allocate memory.</param>
+/// <param name="deallocate">Function that will be called to release memory.</param>
+/// <param name="user_context">Free to use context information that will be passed to the allocation functions.</param>
+/// <returns>A reference to a new created encoder instance, or a null pointer when the creation fails.</returns>
+CHARLS_CHECK_RETURN CHARLS_RET_MAY_BE_NULL CHARLS_API_IMPORT_EXPORT charls_jpegls_encoder* CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_create_with_allocator(charls_allocate_handler allocate, charls_deallocate_handler deallocate,
+                                           void* user_context) CHARLS_NOEXCEPT;
+
 /// <summary>
 /// Destroys a JPEG-LS encoder instance created with charls_jpegls_encoder_create and releases all internal resources
 /// attached to it.
@@ -99,6 +115,35 @@ CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLI
 charls_jpegls_encoder_set_color_transformation(CHARLS_IN charls_jpegls_encoder* encoder,
                                                charls_color_transformation color_transformation) CHARLS_NOEXCEPT;
 
+/// <summary>
+/// Configures the restart interval the encoder should use. The default is 0, which means no restart intervals.
+/// When set, the encoder writes a Define Restart Interval (DRI) segment and inserts a restart (RSTm) marker after every
+/// restart interval lines. The coding state is reset at the start of every restart interval, which makes every interval
+/// independently decodable.
+/// </summary>
+/// <param name="encoder">Reference to the encoder instance.</param>
+/// <param name="restart_interval">
+/// The number of lines in a restart interval. 0 disables the use of restart intervals.
+/// </param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_set_restart_interval(CHARLS_IN charls_jpegls_encoder* encoder,
+                                           uint32_t restart_interval) CHARLS_NOEXCEPT;
+
+/// <summary>
+/// Configures the maximum number of threads the encoder may use. The default is 1, which means that encoding is done
+/// on the calling thread. When the interleave mode is none, the scans of the components are encoded concurrently.
+/// When the interleave mode is line or sample, the source lines are converted on a second thread.
+/// When a restart interval is configured, the restart intervals of a scan are encoded concurrently.
+/// The number of threads that encode parts of the image concurrently is limited to the number of hardware threads.
+/// The encoded bit stream is identical to the one created with 1 thread.
+/// </summary>
+/// <param name="encoder">Reference to the encoder instance.</param>
+/// <param name="thread_count">Maximum number of threads to use, 0 means use all available hardware threads.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_set_thread_count(CHARLS_IN charls_jpegls_encoder* encoder, uint32_t thread_count) CHARLS_NOEXCEPT;
+
 /// <summary>
 /// Configures the mapping table ID the encoder should reference when encoding a component.
 /// The referenced mapping table can be included in the stream or provided in another JPEG-LS abbreviated format stream.
@@ -123,6 +168,19 @@ CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLI
 charls_jpegls_encoder_get_estimated_destination_size(CHARLS_IN const charls_jpegls_encoder* encoder,
                                                      CHARLS_OUT size_t* size_in_bytes) CHARLS_NOEXCEPT;
 
+/// <summary>
+/// Returns the size in bytes, that the encoder expects are needed to hold the encoded tiles of the image.
+/// </summary>
+/// <param name="encoder">Reference to the encoder instance.</param>
+/// <param name="tile_width">Width of a tile in pixels.</param>
+/// <param name="tile_height">Height of a tile in pixels.</param>
+/// <param name="size_in_bytes">Reference to the size that will be set when the function returns.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_get_estimated_tiles_destination_size(CHARLS_IN const charls_jpegls_encoder* encoder,
+                                                           uint32_t tile_width, uint32_t tile_height,
+                                                           CHARLS_OUT size_t* size_in_bytes) CHARLS_NOEXCEPT;
+
 /// <summary>
 /// Set the reference to the destination buffer that will contain the encoded JPEG-LS byte stream data after encoding.
 /// This buffer needs to remain valid during the encoding process.
@@ -137,6 +195,22 @@ charls_jpegls_encoder_set_destination_buffer(CHARLS_IN charls_jpegls_encoder* en
                                              CHARLS_OUT_WRITES_BYTES(destination_size_bytes) void* destination_buffer,
                                              size_t destination_size_bytes) CHARLS_NOEXCEPT;
 
+/// <summary>
+/// Set the handler that will receive the encoded JPEG-LS byte stream data in blocks during encoding.
+/// This is an alternative for a destination buffer: the encoder only needs a small internal buffer, which makes it
+/// possible to write the encoded data directly to a file or socket.
+/// </summary>
+/// <remarks>
+/// The handler can return a non-zero value to abort the encoding process, this will be returned as callback_failed.
+/// </remarks>
+/// <param name="encoder">Reference to the encoder instance.</param>
+/// <param name="handler">Function pointer to the encoded data handler.</param>
+/// <param name="user_context">Free to use context information that will be passed to the handler.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_set_destination_handler(CHARLS_IN charls_jpegls_encoder* encoder,
+                                              charls_at_encoded_data_handler handler, void* user_context) CHARLS_NOEXCEPT;
+
 /// <summary>
 /// Writes a standard SPIFF header to the destination. The additional values are computed from the current encoder settings.
 /// A SPIFF header is optional, but recommended for standalone JPEG-LS files.
@@ -286,6 +360,82 @@ charls_jpegls_encoder_encode_components_from_buffer(CHARLS_IN charls_jpegls_enco
                                                     size_t source_size_bytes, int32_t source_component_count,
                                                     uint32_t stride) CHARLS_NOEXCEPT;
 
+/// <summary>
+/// Encodes the next lines of the source image data to the destination.
+/// The encoded bytes are written progressively: bytes_written reports the bytes that are available after each call.
+/// It should be called until all lines of all components are encoded. For interleave mode none, all lines of the first
+/// component are expected first, followed by the lines of the next component. Batches may span component boundaries.
+/// </summary>
+/// <param name="encoder">Reference to the encoder instance.</param>
+/// <param name="source_buffer">Byte array that holds the lines that need to be encoded.</param>
+/// <param name="source_size_bytes">Length of the array in bytes.</param>
+/// <param name="line_count">The number of lines in the source buffer.</param>
+/// <param name="stride">
+/// The number of bytes from one row of pixels in memory to the next row of pixels in memory.
+/// Stride is sometimes called pitch. If padding bytes are present, the stride is wider than the width of the image.
+/// </param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_ATTRIBUTE_ACCESS((access(read_only, 2, 3)))
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_encode_lines_from_buffer(CHARLS_IN charls_jpegls_encoder* encoder,
+                                               CHARLS_IN_READS_BYTES(source_size_bytes) const void* source_buffer,
+                                               size_t source_size_bytes, uint32_t line_count,
+                                               uint32_t stride) CHARLS_NOEXCEPT;
+
+/// <summary>
+/// Encodes the source image as a grid of tiles of tile_width x tile_height pixels. Every tile is encoded as an
+/// independent JPEG-LS byte stream with the configured parameters, which makes random access into large images possible.
+/// The byte streams are written after each other to the destination buffer; the tiles are encoded concurrently when
+/// the thread count allows it.
+/// </summary>
+/// <remarks>
+/// The tiles are stored in row-major order. The tiles at the right and bottom edge can be smaller than the tile size.
+/// SPIFF headers, comments, application data and mapping tables are not written to the tiles.
+/// A destination buffer is required, a destination handler is not supported.
+/// </remarks>
+/// <param name="encoder">Reference to the encoder instance.</param>
+/// <param name="source_buffer">Byte array that holds the image data of the complete frame.</param>
+/// <param name="source_size_bytes">Length of the array in bytes.</param>
+/// <param name="stride">
+/// The number of bytes from one row of pixels in memory to the next row of pixels in memory.
+/// Stride is sometimes called pitch. If padding bytes are present, the stride is wider than the width of the image.
+/// </param>
+/// <param name="tile_width">Width of a tile in pixels.</param>
+/// <param name="tile_height">Height of a tile in pixels.</param>
+/// <param name="tiles">Array that will receive the position of every tile and of its byte stream.</param>
+/// <param name="tile_count">
+/// Number of elements in the tiles array, needs to be at least ceil(width / tile_width) * ceil(height / tile_height).
+/// </param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_ATTRIBUTE_ACCESS((access(read_only, 2, 3)))
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_encode_tiles_from_buffer(CHARLS_IN charls_jpegls_encoder* encoder,
+                                               CHARLS_IN_READS_BYTES(source_size_bytes) const void* source_buffer,
+                                               size_t source_size_bytes, uint32_t stride, uint32_t tile_width,
+                                               uint32_t tile_height, CHARLS_OUT_WRITES(tile_count) charls_tile_info* tiles,
+                                               size_t tile_count) CHARLS_NOEXCEPT;
+
+/// <summary>
+/// Encodes a batch of images, every image as a complete JPEG-LS byte stream in its own destination buffer.
+/// The images are encoded concurrently when the thread count allows it; every thread reuses its internal codec and
+/// buffers for the images it encodes.
+/// </summary>
+/// <remarks>
+/// The frame info, source and destination of every image are passed in its batch item. The other coding parameters
+/// (interleave mode, near-lossless, restart interval, color transformation, encoding options and preset coding
+/// parameters) are taken from the encoder, which itself is not changed. SPIFF headers, comments, application data and
+/// mapping tables are not written. The result of every image is stored in the error and bytes_written fields of its
+/// item: the function only fails when the arguments are invalid.
+/// </remarks>
+/// <param name="encoder">Reference to the encoder instance.</param>
+/// <param name="items">Array with the images to encode.</param>
+/// <param name="item_count">Number of elements in the items array.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_encode_batch(CHARLS_IN const charls_jpegls_encoder* encoder,
+                                   CHARLS_IN_OUT_UPDATES(item_count) charls_batch_item* items,
+                                   size_t item_count) CHARLS_NOEXCEPT;
+
 /// <summary>
 /// Creates a JPEG-LS stream in the abbreviated format that only contain mapping tables (See JPEG-LS standard, C.4).
 /// These mapping tables must have been written to the stream first with the method
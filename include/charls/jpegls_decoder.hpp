@@ -54,6 +54,18 @@ public:
 
     jpegls_decoder() = default;
 
+    /// <summary>
+    /// Constructs a jpegls_decoder instance that allocates all its memory with the passed allocation functions.
+    /// </summary>
+    /// <param name="allocate">Function that will be called to allocate memory.</param>
+    /// <param name="deallocate">Function that will be called to release memory.</param>
+    /// <param name="user_context">Free to use context information that will be passed to the allocation functions.</param>
+    /// <exception cref="std::bad_alloc">Thrown when memory for the decoder could not be allocated.</exception>
+    jpegls_decoder(const allocate_handler allocate, const deallocate_handler deallocate, void* user_context = nullptr) :
+        decoder_{create_decoder(allocate, deallocate, user_context), &destroy_decoder}
+    {
+    }
+
     /// <summary>
     /// Constructs a jpegls_decoder instance.
     /// The passed container needs to remain valid until the stream is fully decoded.
@@ -123,6 +135,65 @@ public:
         return source(source_container.data(), source_container.size() * sizeof(ContainerValueType));
     }
 
+    /// <summary>
+    /// Appends a chunk of the encoded JPEG-LS byte stream data to the source (incremental decoding).
+    /// The data is copied, the passed buffer doesn't need to remain valid.
+    /// read_header(ec) reports jpegls_errc::need_more_data when not all header segments are available.
+    /// </summary>
+    /// <param name="source_buffer">Reference to the start of the source chunk.</param>
+    /// <param name="source_size_bytes">Size of the source chunk in bytes.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    CHARLS_ATTRIBUTE_ACCESS((access(read_only, 2, 3)))
+    jpegls_decoder& append_source(CHARLS_IN_READS_BYTES(source_size_bytes) const void* source_buffer,
+                                  const size_t source_size_bytes)
+    {
+        check_jpegls_errc(charls_jpegls_decoder_append_source_buffer(decoder(), source_buffer, source_size_bytes));
+        return *this;
+    }
+
+    /// <summary>
+    /// Appends a chunk of the encoded JPEG-LS byte stream data to the source (incremental decoding).
+    /// </summary>
+    /// <param name="source_container">
+    /// STL like container that provides the functions data() and size() and the type value_type.
+    /// </param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    template<typename Container, typename ContainerValueType = typename Container::value_type>
+    jpegls_decoder& append_source(const Container& source_container)
+    {
+        return append_source(source_container.data(), source_container.size() * sizeof(ContainerValueType));
+    }
+
+    /// <summary>
+    /// Configures the maximum number of threads the decoder may use.
+    /// Images encoded with multiple scans and scans that are divided in multiple restart intervals can be decoded with
+    /// multiple threads. Other scans with interleave mode line or sample convert the decoded lines on a second thread.
+    /// The number of threads that decode parts of the image concurrently is limited to the number of hardware threads.
+    /// </summary>
+    /// <param name="thread_count">Maximum number of threads to use, 0 means use all available hardware threads.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    jpegls_decoder& thread_count(const uint32_t thread_count)
+    {
+        check_jpegls_errc(charls_jpegls_decoder_set_thread_count(decoder(), thread_count));
+        return *this;
+    }
+
+    /// <summary>
+    /// Resets the decoder to its initial state, ready to decode the next JPEG-LS byte stream.
+    /// Installed callbacks and the thread count are kept. Internal buffers are reused when the next image has the same
+    /// properties.
+    /// </summary>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    jpegls_decoder& reset()
+    {
+        check_jpegls_errc(charls_jpegls_decoder_reset(decoder()));
+        spiff_header_has_value_ = false;
+        spiff_header_ = {};
+        frame_info_ = {};
+        decoded_line_count_ = 0;
+        return *this;
+    }
+
     /// <summary>
     /// Tries to read the SPIFF header from the JPEG-LS stream.
     /// If a SPIFF header exists it will be returned otherwise the struct will be filled with default values.
@@ -340,6 +411,146 @@ public:
         decode(destination_container.data(), destination_container.size() * sizeof(ContainerValueType), stride);
     }
 
+    /// <summary>
+    /// Will decode the JPEG-LS byte stream set with source and pass the decoded lines in batches to a handler.
+    /// The lines are decoded into a small buffer that is reused for every batch, which avoids the need for a
+    /// destination buffer for the complete image. Images encoded with interleave mode none are passed one component
+    /// at a time.
+    /// </summary>
+    /// <remarks>
+    /// The handler can throw an exception to abort the decoding process.
+    /// This abort will be reported as a callback_failed error code.
+    /// </remarks>
+    /// <param name="lines_handler">
+    /// Function object that is called with the lines, their size in bytes, the index of the first component of the
+    /// scan, the index of the first line and the number of lines.
+    /// </param>
+    /// <param name="lines_per_call">Maximum number of lines that will be passed in a single call.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    void decode(std::function<void(const void* lines, size_t size, uint32_t component_index, uint32_t first_line,
+                                   uint32_t line_count)>
+                    lines_handler,
+                const uint32_t lines_per_call = 1)
+    {
+        check_jpegls_errc(charls_jpegls_decoder_decode_to_line_handler(decoder(), lines_per_call,
+                                                                       &at_decoded_lines_callback, &lines_handler));
+    }
+
+    /// <summary>
+    /// Will decode a rectangle of the image into the destination buffer. Decoding stops after the last line of the
+    /// rectangle and, when restart intervals are present, starts at the restart interval that holds its first line.
+    /// </summary>
+    /// <param name="x">The first column of the rectangle.</param>
+    /// <param name="y">The first line of the rectangle.</param>
+    /// <param name="width">The width of the rectangle in pixels.</param>
+    /// <param name="height">The height of the rectangle in lines.</param>
+    /// <param name="destination_buffer">
+    /// Byte array that holds the decoded pixels of the rectangle when the function returns.
+    /// </param>
+    /// <param name="destination_size_bytes">Length of the destination buffer in bytes.</param>
+    /// <param name="stride">Number of bytes to the next line in the buffer, when zero, decoder will compute it.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    CHARLS_ATTRIBUTE_ACCESS((access(write_only, 6, 7)))
+    void decode_rect(const uint32_t x, const uint32_t y, const uint32_t width, const uint32_t height,
+                     CHARLS_OUT_WRITES_BYTES(destination_size_bytes) void* destination_buffer,
+                     const size_t destination_size_bytes, const uint32_t stride = 0)
+    {
+        check_jpegls_errc(charls_jpegls_decoder_decode_rect(decoder(), x, y, width, height, destination_buffer,
+                                                            destination_size_bytes, stride));
+    }
+
+    /// <summary>
+    /// Will decode a rectangle of the image into the destination container.
+    /// </summary>
+    /// <param name="x">The first column of the rectangle.</param>
+    /// <param name="y">The first line of the rectangle.</param>
+    /// <param name="width">The width of the rectangle in pixels.</param>
+    /// <param name="height">The height of the rectangle in lines.</param>
+    /// <param name="destination_container">
+    /// STL like container that provides the functions data() and size() and the type value_type.
+    /// </param>
+    /// <param name="stride">Number of bytes to the next line in the buffer, when zero, decoder will compute it.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    template<typename Container, typename ContainerValueType = typename Container::value_type>
+    void decode_rect(const uint32_t x, const uint32_t y, const uint32_t width, const uint32_t height,
+                     CHARLS_OUT Container& destination_container, const uint32_t stride = 0)
+    {
+        decode_rect(x, y, width, height, destination_container.data(),
+                    destination_container.size() * sizeof(ContainerValueType), stride);
+    }
+
+    /// <summary>
+    /// Decodes a batch of JPEG-LS byte streams, every image to its own destination buffer.
+    /// The frame info, the result and the number of decoded bytes of every image are stored in its item.
+    /// </summary>
+    /// <param name="items">Array with the images to decode.</param>
+    /// <param name="item_count">Number of elements in the items array.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    void decode_batch(CHARLS_IN_OUT_UPDATES(item_count) batch_item* items, const size_t item_count) const
+    {
+        check_jpegls_errc(charls_jpegls_decoder_decode_batch(decoder(), items, item_count));
+    }
+
+    /// <summary>
+    /// Decodes a batch of JPEG-LS byte streams, every image to its own destination buffer.
+    /// </summary>
+    /// <param name="items">STL like container with the images to decode.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    template<typename Container>
+    void decode_batch(Container& items) const
+    {
+        decode_batch(items.data(), items.size());
+    }
+
+    /// <summary>
+    /// Decodes the lines for which the encoded data has been appended with append_source (incremental decoding).
+    /// Call again with the same destination buffer after more data has been appended.
+    /// </summary>
+    /// <param name="destination_buffer">Byte array that holds the decoded lines when the function returns.</param>
+    /// <param name="destination_size_bytes">Length of the destination buffer in bytes.</param>
+    /// <param name="stride">Number of bytes to the next line in the buffer, when zero, decoder will compute it.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    /// <returns>True when the complete image has been decoded, false when more source data is needed.</returns>
+    CHARLS_ATTRIBUTE_ACCESS((access(write_only, 2, 3)))
+    bool decode_available(CHARLS_OUT_WRITES_BYTES(destination_size_bytes) void* destination_buffer,
+                          const size_t destination_size_bytes, const uint32_t stride = 0)
+    {
+        const jpegls_errc error{charls_jpegls_decoder_decode_available_to_buffer(
+            decoder(), destination_buffer, destination_size_bytes, stride, &decoded_line_count_)};
+        if (error == jpegls_errc::need_more_data)
+            return false;
+
+        check_jpegls_errc(error);
+        return true;
+    }
+
+    /// <summary>
+    /// Decodes the lines for which the encoded data has been appended with append_source (incremental decoding).
+    /// </summary>
+    /// <param name="destination_container">
+    /// STL like container that provides the functions data() and size() and the type value_type.
+    /// </param>
+    /// <param name="stride">Number of bytes to the next line in the buffer, when zero, decoder will compute it.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    /// <returns>True when the complete image has been decoded, false when more source data is needed.</returns>
+    template<typename Container, typename ContainerValueType = typename Container::value_type>
+    bool decode_available(CHARLS_OUT Container& destination_container, const uint32_t stride = 0)
+    {
+        return decode_available(destination_container.data(), destination_container.size() * sizeof(ContainerValueType),
+                                stride);
+    }
+
+    /// <summary>
+    /// Returns the number of lines that have been decoded by decode_available.
+    /// For images with multiple scans (interleave mode none), the lines of all scans are counted.
+    /// </summary>
+    /// <returns>The number of decoded lines.</returns>
+    [[nodiscard]]
+    uint32_t decoded_line_count() const noexcept
+    {
+        return decoded_line_count_;
+    }
+
     /// <summary>
     /// Will decode the JPEG-LS byte stream set with source and return a container with the decoded data.
     /// </summary>
@@ -533,11 +744,40 @@ private:
         return decoder;
     }
 
+    [[nodiscard]]
+    static charls_jpegls_decoder* create_decoder(const allocate_handler allocate, const deallocate_handler deallocate,
+                                                 void* user_context)
+    {
+        charls_jpegls_decoder* decoder{charls_jpegls_decoder_create_with_allocator(allocate, deallocate, user_context)};
+        if (!decoder)
+            throw std::bad_alloc();
+
+        return decoder;
+    }
+
     static void destroy_decoder(CHARLS_IN_OPT const charls_jpegls_decoder* decoder) noexcept
     {
         charls_jpegls_decoder_destroy(decoder);
     }
 
+    static int32_t CHARLS_API_CALLING_CONVENTION at_decoded_lines_callback(const void* lines, const size_t size,
+                                                                           const uint32_t component_index,
+                                                                           const uint32_t first_line,
+                                                                           const uint32_t line_count,
+                                                                           void* user_context) noexcept
+    {
+        try
+        {
+            (*static_cast<std::function<void(const void*, size_t, uint32_t, uint32_t, uint32_t)>*>(user_context))(
+                lines, size, component_index, first_line, line_count);
+            return 0;
+        }
+        catch (...)
+        {
+            return 1; // will trigger jpegls_errc::callback_failed.
+        }
+    }
+
     static int32_t CHARLS_API_CALLING_CONVENTION at_comment_callback(const void* data, const size_t size,
                                                                      void* user_context) noexcept
     {
@@ -572,6 +812,7 @@ private:
     bool spiff_header_has_value_{};
     charls::spiff_header spiff_header_{};
     charls::frame_info frame_info_{};
+    uint32_t decoded_line_count_{};
     std::function<void(const void*, size_t)> comment_handler_;
     std::function<void(int32_t, const void*, size_t)> application_data_handler_;
 };
@@ -8,7 +8,9 @@
 
 #ifndef CHARLS_BUILD_AS_CPP_MODULE
 #include <cstring>
+#include <functional>
 #include <memory>
+#include <utility>
 #endif
 
 CHARLS_EXPORT
@@ -47,6 +49,20 @@ public:
         return destination;
     }
 
+    jpegls_encoder() = default;
+
+    /// <summary>
+    /// Constructs a jpegls_encoder instance that allocates all its memory with the passed allocation functions.
+    /// </summary>
+    /// <param name="allocate">Function that will be called to allocate memory.</param>
+    /// <param name="deallocate">Function that will be called to release memory.</param>
+    /// <param name="user_context">Free to use context information that will be passed to the allocation functions.</param>
+    /// <exception cref="std::bad_alloc">Thrown when memory for the encoder could not be allocated.</exception>
+    jpegls_encoder(const allocate_handler allocate, const deallocate_handler deallocate, void* user_context = nullptr) :
+        encoder_{create_encoder(allocate, deallocate, user_context), &destroy_encoder}
+    {
+    }
+
     /// <summary>
     /// Configures the frame that needs to be encoded.
     /// This information will be written to the Start of Frame (SOF) segment during the encode phase.
@@ -119,6 +135,31 @@ public:
         return *this;
     }
 
+    /// <summary>
+    /// Configures the restart interval the encoder should use. The default is 0, which means no restart intervals.
+    /// When set, a restart (RSTm) marker is inserted after every restart interval lines and the coding state is reset.
+    /// </summary>
+    /// <param name="restart_interval">The number of lines in a restart interval. 0 disables restart intervals.</param>
+    jpegls_encoder& restart_interval(const uint32_t restart_interval)
+    {
+        check_jpegls_errc(charls_jpegls_encoder_set_restart_interval(encoder(), restart_interval));
+        return *this;
+    }
+
+    /// <summary>
+    /// Configures the maximum number of threads the encoder may use. The default is 1.
+    /// When the interleave mode is none, the scans of the components are encoded concurrently.
+    /// When the interleave mode is line or sample, the source lines are converted on a second thread.
+    /// When a restart interval is configured, the restart intervals of a scan are encoded concurrently.
+    /// The number of threads that encode parts of the image concurrently is limited to the number of hardware threads.
+    /// </summary>
+    /// <param name="thread_count">Maximum number of threads to use, 0 means use all available hardware threads.</param>
+    jpegls_encoder& thread_count(const uint32_t thread_count)
+    {
+        check_jpegls_errc(charls_jpegls_encoder_set_thread_count(encoder(), thread_count));
+        return *this;
+    }
+
     /// <summary>
     /// Configures the mapping table ID the encoder should reference when encoding a component.
     /// The referenced mapping table can be included in the stream or provided in another JPEG-LS abbreviated format stream.
@@ -146,6 +187,21 @@ public:
         return size_in_bytes;
     }
 
+    /// <summary>
+    /// Returns the size in bytes, that the encoder expects are needed to hold the encoded tiles of the image.
+    /// </summary>
+    /// <param name="tile_width">Width of a tile in pixels.</param>
+    /// <param name="tile_height">Height of a tile in pixels.</param>
+    /// <returns>The estimated size in bytes needed to hold the encoded tiles.</returns>
+    [[nodiscard]]
+    size_t estimated_tiles_destination_size(const uint32_t tile_width, const uint32_t tile_height) const
+    {
+        size_t size_in_bytes;
+        check_jpegls_errc(
+            charls_jpegls_encoder_get_estimated_tiles_destination_size(encoder(), tile_width, tile_height, &size_in_bytes));
+        return size_in_bytes;
+    }
+
     /// <summary>
     /// Set the reference to the destination buffer that will contain the encoded JPEG-LS byte stream data after encoding.
     /// This buffer needs to remain valid during the encoding process.
@@ -177,6 +233,24 @@ public:
     template<typename Container, typename T = typename Container::value_type>
     jpegls_encoder& destination(const Container& destination_container) = delete;
 
+    /// <summary>
+    /// Set the function that will receive the encoded JPEG-LS byte stream data in blocks during encoding.
+    /// The encoder then only needs a small internal buffer, which makes it possible to stream the encoded data.
+    /// </summary>
+    /// <remarks>
+    /// The callback can throw an exception to abort the encoding process.
+    /// This abort will be returned as a callback_failed error code.
+    /// </remarks>
+    /// <param name="encoded_data_handler">Function object to the encoded data handler.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    jpegls_encoder& destination(std::function<void(const void* data, size_t size)> encoded_data_handler)
+    {
+        encoded_data_handler_ = std::move(encoded_data_handler);
+        check_jpegls_errc(charls_jpegls_encoder_set_destination_handler(
+            encoder(), encoded_data_handler_ ? &at_encoded_data_callback : nullptr, this));
+        return *this;
+    }
+
     /// <summary>
     /// Writes a standard SPIFF header to the destination. The additional values are computed from the current encoder
     /// settings.
@@ -387,6 +461,111 @@ public:
                                  source_component_count, stride);
     }
 
+    /// <summary>
+    /// Encodes the next lines of the source image data to the destination.
+    /// The encoded bytes are written progressively, which allows to encode an image while its lines become available.
+    /// It should be called until all lines of all components are encoded.
+    /// </summary>
+    /// <param name="source_buffer">Byte array that holds the lines that need to be encoded.</param>
+    /// <param name="source_size_bytes">Length of the array in bytes.</param>
+    /// <param name="line_count">The number of lines in the buffer.</param>
+    /// <param name="stride">
+    /// The number of bytes from one row of pixels in memory to the next row of pixels in memory.
+    /// Stride is sometimes called pitch. If padding bytes are present, the stride is wider than the width of the image.
+    /// </param>
+    /// <returns>The number of bytes written to the destination.</returns>
+    size_t encode_lines(CHARLS_IN_READS_BYTES(source_size_bytes) const void* source_buffer, const size_t source_size_bytes,
+                        const uint32_t line_count, const uint32_t stride = 0)
+    {
+        check_jpegls_errc(
+            charls_jpegls_encoder_encode_lines_from_buffer(encoder(), source_buffer, source_size_bytes, line_count, stride));
+        return bytes_written();
+    }
+
+    /// <summary>
+    /// Encodes the next lines of the passed STL like container with the source image data to the destination.
+    /// </summary>
+    /// <param name="source_container">Container that holds the lines that need to be encoded.</param>
+    /// <param name="line_count">The number of lines in the container.</param>
+    /// <param name="stride">
+    /// The number of bytes from one row of pixels in memory to the next row of pixels in memory.
+    /// Stride is sometimes called pitch. If padding bytes are present, the stride is wider than the width of the image.
+    /// </param>
+    /// <returns>The number of bytes written to the destination.</returns>
+    template<typename Container, typename ContainerValueType = typename Container::value_type>
+    size_t encode_lines(const Container& source_container, const uint32_t line_count, const uint32_t stride = 0)
+    {
+        return encode_lines(source_container.data(), source_container.size() * sizeof(ContainerValueType), line_count,
+                            stride);
+    }
+
+    /// <summary>
+    /// Encodes the image as a grid of tiles of tile_width x tile_height pixels. Every tile is encoded as an independent
+    /// JPEG-LS byte stream, the byte streams are written after each other to the destination.
+    /// </summary>
+    /// <param name="source_buffer">Byte array that holds the image data of the complete frame.</param>
+    /// <param name="source_size_bytes">Length of the array in bytes.</param>
+    /// <param name="tile_width">Width of a tile in pixels.</param>
+    /// <param name="tile_height">Height of a tile in pixels.</param>
+    /// <param name="tiles">Array that will receive the position of every tile and of its byte stream.</param>
+    /// <param name="tile_count">Number of elements in the tiles array.</param>
+    /// <param name="stride">
+    /// The number of bytes from one row of pixels in memory to the next row of pixels in memory.
+    /// Stride is sometimes called pitch. If padding bytes are present, the stride is wider than the width of the image.
+    /// </param>
+    /// <returns>The number of bytes written to the destination.</returns>
+    CHARLS_ATTRIBUTE_ACCESS((access(read_only, 2, 3)))
+    size_t encode_tiles(CHARLS_IN_READS_BYTES(source_size_bytes) const void* source_buffer, const size_t source_size_bytes,
+                        const uint32_t tile_width, const uint32_t tile_height,
+                        CHARLS_OUT_WRITES(tile_count) tile_info* tiles, const size_t tile_count, const uint32_t stride = 0)
+    {
+        check_jpegls_errc(charls_jpegls_encoder_encode_tiles_from_buffer(encoder(), source_buffer, source_size_bytes, stride,
+                                                                         tile_width, tile_height, tiles, tile_count));
+        return bytes_written();
+    }
+
+    /// <summary>
+    /// Encodes the passed STL like container with the image data as a grid of independent JPEG-LS byte streams.
+    /// </summary>
+    /// <param name="source_container">Container that holds the image data of the complete frame.</param>
+    /// <param name="tile_width">Width of a tile in pixels.</param>
+    /// <param name="tile_height">Height of a tile in pixels.</param>
+    /// <param name="tiles">Container that will receive the position of every tile and of its byte stream.</param>
+    /// <param name="stride">
+    /// The number of bytes from one row of pixels in memory to the next row of pixels in memory.
+    /// Stride is sometimes called pitch. If padding bytes are present, the stride is wider than the width of the image.
+    /// </param>
+    /// <returns>The number of bytes written to the destination.</returns>
+    template<typename Container, typename TileContainer, typename ContainerValueType = typename Container::value_type>
+    size_t encode_tiles(const Container& source_container, const uint32_t tile_width, const uint32_t tile_height,
+                        TileContainer& tiles, const uint32_t stride = 0)
+    {
+        return encode_tiles(source_container.data(), source_container.size() * sizeof(ContainerValueType), tile_width,
+                            tile_height, tiles.data(), tiles.size(), stride);
+    }
+
+    /// <summary>
+    /// Encodes a batch of images, every image as a complete JPEG-LS byte stream in its own destination buffer.
+    /// The coding parameters, except the frame info, are taken from this encoder.
+    /// The result of every image is stored in the error and bytes_written fields of its item.
+    /// </summary>
+    /// <param name="items">Array with the images to encode.</param>
+    /// <param name="item_count">Number of elements in the items array.</param>
+    void encode_batch(CHARLS_IN_OUT_UPDATES(item_count) batch_item* items, const size_t item_count) const
+    {
+        check_jpegls_errc(charls_jpegls_encoder_encode_batch(encoder(), items, item_count));
+    }
+
+    /// <summary>
+    /// Encodes a batch of images, every image as a complete JPEG-LS byte stream in its own destination buffer.
+    /// </summary>
+    /// <param name="items">STL like container with the images to encode.</param>
+    template<typename Container>
+    void encode_batch(Container& items) const
+    {
+        encode_batch(items.data(), items.size());
+    }
+
     /// <summary>
     /// Creates a JPEG-LS stream in abbreviated format that only contain mapping tables (See JPEG-LS standard, C.4).
     /// These tables should have been written to the stream first with the method write_mapping_table.
@@ -441,13 +620,39 @@ private:
         return encoder;
     }
 
+    [[nodiscard]]
+    static charls_jpegls_encoder* create_encoder(const allocate_handler allocate, const deallocate_handler deallocate,
+                                                 void* user_context)
+    {
+        charls_jpegls_encoder* encoder{charls_jpegls_encoder_create_with_allocator(allocate, deallocate, user_context)};
+        if (!encoder)
+            throw std::bad_alloc();
+
+        return encoder;
+    }
+
     static void destroy_encoder(CHARLS_IN_OPT const charls_jpegls_encoder* encoder) noexcept
     {
         charls_jpegls_encoder_destroy(encoder);
     }
 
+    static int32_t CHARLS_API_CALLING_CONVENTION at_encoded_data_callback(const void* data, const size_t size,
+                                                                          void* user_context) noexcept
+    {
+        try
+        {
+            static_cast<jpegls_encoder*>(user_context)->encoded_data_handler_(data, size);
+            return 0;
+        }
+        catch (...)
+        {
+            return 1; // will trigger jpegls_errc::callback_failed.
+        }
+    }
+
     std::unique_ptr<charls_jpegls_encoder, void (*)(const charls_jpegls_encoder*)> encoder_{create_encoder(),
                                                                                             &destroy_encoder};
+    std::function<void(const void*, size_t)> encoded_data_handler_;
 };
 
 } // namespace charls
@@ -1034,6 +1034,90 @@ struct charls_mapping_table_info CHARLS_FINAL
 };
 
 
+/// <summary>
+/// Defines the position of a tile in the source image and of its JPEG-LS byte stream in the destination.
+/// </summary>
+struct charls_tile_info CHARLS_FINAL
+{
+    /// <summary>
+    /// Column of the top-left pixel of the tile in the source image.
+    /// </summary>
+    CHARLS_STD uint32_t x;
+
+    /// <summary>
+    /// Row of the top-left pixel of the tile in the source image.
+    /// </summary>
+    CHARLS_STD uint32_t y;
+
+    /// <summary>
+    /// Width of the tile, tiles at the right edge of the image can be smaller than the requested tile width.
+    /// </summary>
+    CHARLS_STD uint32_t width;
+
+    /// <summary>
+    /// Height of the tile, tiles at the bottom edge of the image can be smaller than the requested tile height.
+    /// </summary>
+    CHARLS_STD uint32_t height;
+
+    /// <summary>
+    /// Offset in bytes of the JPEG-LS byte stream of the tile in the destination.
+    /// </summary>
+    CHARLS_STD size_t offset;
+
+    /// <summary>
+    /// Size in bytes of the JPEG-LS byte stream of the tile.
+    /// </summary>
+    CHARLS_STD size_t size;
+};
+
+
+/// <summary>
+/// Defines an image of a batch encode or decode operation and receives the result of its operation.
+/// </summary>
+struct charls_batch_item CHARLS_FINAL
+{
+    /// <summary>
+    /// Source buffer: the pixels of the image (encode) or the JPEG-LS byte stream (decode).
+    /// </summary>
+    const void* source;
+
+    /// <summary>
+    /// Size in bytes of the source buffer.
+    /// </summary>
+    CHARLS_STD size_t source_size;
+
+    /// <summary>
+    /// Destination buffer: receives the JPEG-LS byte stream (encode) or the pixels of the image (decode).
+    /// </summary>
+    void* destination;
+
+    /// <summary>
+    /// Size in bytes of the destination buffer.
+    /// </summary>
+    CHARLS_STD size_t destination_size;
+
+    /// <summary>
+    /// Number of bytes from one line of pixels to the next, 0 means the lines are stored without padding.
+    /// </summary>
+    CHARLS_STD uint32_t stride;
+
+    /// <summary>
+    /// Information about the image: set by the caller (encode) or by the operation (decode).
+    /// </summary>
+    struct charls_frame_info frame_info;
+
+    /// <summary>
+    /// Receives the number of bytes written to the destination buffer.
+    /// </summary>
+    CHARLS_STD size_t bytes_written;
+
+    /// <summary>
+    /// Receives the result of the operation of this item: success or a failure code.
+    /// </summary>
+    charls_jpegls_errc error;
+};
+
+
 #ifdef __cplusplus
 
 /// <summary>
@@ -1062,6 +1146,60 @@ using charls_at_application_data_handler = std::int32_t(CHARLS_API_CALLING_CONVE
                                                                                         const void* data, std::size_t size,
                                                                                         void* user_context);
 
+/// <summary>
+/// Function definition for a callback handler that will be called when a batch of lines has been decoded.
+/// </summary>
+/// <remarks>
+/// </remarks>
+/// <param name="lines">Reference to the decoded lines, the lines are stored without padding bytes.</param>
+/// <param name="size">Size in bytes of the decoded lines.</param>
+/// <param name="component_index">Index of the first component in the scan the lines belong to.</param>
+/// <param name="first_line">Index of the first line.</param>
+/// <param name="line_count">Number of lines.</param>
+/// <param name="user_context">Free to use context information that can be set during the installation of the
+/// handler.</param>
+using charls_at_decoded_lines_handler = std::int32_t(CHARLS_API_CALLING_CONVENTION*)(const void* lines, std::size_t size,
+                                                                                    std::uint32_t component_index,
+                                                                                    std::uint32_t first_line,
+                                                                                    std::uint32_t line_count,
+                                                                                    void* user_context);
+
+/// <summary>
+/// Function definition for a callback handler that will be called when a block of encoded bytes is available.
+/// </summary>
+/// <remarks>
+/// </remarks>
+/// <param name="data">Reference to the encoded bytes.</param>
+/// <param name="size">Size in bytes of the encoded bytes.</param>
+/// <param name="user_context">Free to use context information that can be set during the installation of the
+/// handler.</param>
+using charls_at_encoded_data_handler = std::int32_t(CHARLS_API_CALLING_CONVENTION*)(const void* data, std::size_t size,
+                                                                                   void* user_context);
+
+/// <summary>
+/// Function definition for a callback handler that will be called to allocate memory.
+/// </summary>
+/// <remarks>
+/// The requested alignment is never larger than the alignment guaranteed by the default operator new.
+/// </remarks>
+/// <param name="size">Size in bytes of the memory block.</param>
+/// <param name="alignment">Required alignment in bytes of the memory block.</param>
+/// <param name="user_context">Free to use context information that can be set during the creation of the
+/// decoder or encoder.</param>
+/// <returns>Pointer to the allocated memory block or nullptr when the memory could not be allocated.</returns>
+using charls_allocate_handler = void*(CHARLS_API_CALLING_CONVENTION*)(std::size_t size, std::size_t alignment,
+                                                                     void* user_context);
+
+/// <summary>
+/// Function definition for a callback handler that will be called to release memory allocated by the allocate handler.
+/// </summary>
+/// <param name="pointer">Pointer to the memory block.</param>
+/// <param name="size">Size in bytes of the memory block, identical to the size passed to the allocate handler.</param>
+/// <param name="user_context">Free to use context information that can be set during the creation of the
+/// decoder or encoder.</param>
+using charls_deallocate_handler = void(CHARLS_API_CALLING_CONVENTION*)(void* pointer, std::size_t size,
+                                                                      void* user_context);
+
 CHARLS_EXPORT
 namespace charls {
 
@@ -1069,8 +1207,14 @@ using spiff_header = charls_spiff_header;
 using frame_info = charls_frame_info;
 using jpegls_pc_parameters = charls_jpegls_pc_parameters;
 using mapping_table_info = charls_mapping_table_info;
+using tile_info = charls_tile_info;
+using batch_item = charls_batch_item;
 using at_comment_handler = charls_at_comment_handler;
 using at_application_data_handler = charls_at_application_data_handler;
+using at_decoded_lines_handler = charls_at_decoded_lines_handler;
+using at_encoded_data_handler = charls_at_encoded_data_handler;
+using allocate_handler = charls_allocate_handler;
+using deallocate_handler = charls_deallocate_handler;
 
 static_assert(sizeof(spiff_header) == 40, "size of struct is incorrect, check padding settings");
 static_assert(sizeof(frame_info) == 16, "size of struct is incorrect, check padding settings");
@@ -1085,10 +1229,20 @@ typedef int32_t(CHARLS_API_CALLING_CONVENTION* charls_at_comment_handler)(const
 typedef int32_t(CHARLS_API_CALLING_CONVENTION* charls_at_application_data_handler)(int32_t application_data_id,
                                                                                    const void* data, size_t size,
                                                                                    void* user_context);
+typedef int32_t(CHARLS_API_CALLING_CONVENTION* charls_at_decoded_lines_handler)(const void* lines, size_t size,
+                                                                                uint32_t component_index,
+                                                                                uint32_t first_line, uint32_t line_count,
+                                                                                void* user_context);
+typedef int32_t(CHARLS_API_CALLING_CONVENTION* charls_at_encoded_data_handler)(const void* data, size_t size,
+                                                                               void* user_context);
+typedef void*(CHARLS_API_CALLING_CONVENTION* charls_allocate_handler)(size_t size, size_t alignment, void* user_context);
+typedef void(CHARLS_API_CALLING_CONVENTION* charls_deallocate_handler)(void* pointer, size_t size, void* user_context);
 
 typedef struct charls_spiff_header charls_spiff_header;
 typedef struct charls_frame_info charls_frame_info;
 typedef struct charls_jpegls_pc_parameters charls_jpegls_pc_parameters;
 typedef struct charls_mapping_table_info charls_mapping_table_info;
+typedef struct charls_tile_info charls_tile_info;
+typedef struct charls_batch_item charls_batch_item;
 
 #endif
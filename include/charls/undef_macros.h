@@ -15,8 +15,10 @@
 #undef CHARLS_IN_OPT
 #undef CHARLS_IN_Z
 #undef CHARLS_IN_READS_BYTES
+#undef CHARLS_IN_OUT_UPDATES
 #undef CHARLS_OUT
 #undef CHARLS_OUT_OPT
+#undef CHARLS_OUT_WRITES
 #undef CHARLS_OUT_WRITES_BYTES
 #undef CHARLS_OUT_WRITES_Z
 #undef CHARLS_RETURN_TYPE_SUCCESS
@@ -6,12 +6,15 @@
 #include "charls/charls_jpegls_decoder.h"
 
 #include "constants.hpp"
+#include "jpeg_marker_scanner.hpp"
 #include "jpeg_stream_reader.hpp"
+#include "jpegls_algorithm.hpp"
 #include "make_scan_codec.hpp"
+#include "memory_allocator.hpp"
+#include "parallel.hpp"
 #include "scan_decoder.hpp"
 #include "util.hpp"
 
-#include <memory>
 #include <new>
 
 using namespace charls;
@@ -20,6 +23,16 @@ using std::byte;
 
 struct charls_jpegls_decoder final
 {
+    explicit charls_jpegls_decoder(const charls::memory_resource& resource) noexcept : memory_resource_{resource}
+    {
+    }
+
+    [[nodiscard]]
+    const charls::memory_resource& memory() const noexcept
+    {
+        return memory_resource_;
+    }
+
     void source(const span<const byte> source)
     {
         check_argument(source);
@@ -29,9 +42,61 @@ struct charls_jpegls_decoder final
         state_ = state::source_set;
     }
 
+    void append_source(const span<const byte> source)
+    {
+        check_argument(source);
+        check_operation(state_ == state::initial || (incremental_ && state_ < state::completed));
+
+        const byte* previous_source_begin{source_buffer_.data()};
+        if (source_buffer_.capacity() - source_buffer_.size() < source.size())
+        {
+            // Segments that have already been read (mapping tables) reference the current buffer: keep it alive.
+            memory_vector<byte> buffer{source_buffer_.get_allocator()};
+            buffer.reserve(std::max(source_buffer_.size() * 2, source_buffer_.size() + source.size()));
+            buffer.insert(buffer.end(), source_buffer_.begin(), source_buffer_.end());
+            retired_source_buffers_.push_back(std::move(source_buffer_));
+            source_buffer_ = std::move(buffer);
+        }
+        source_buffer_.insert(source_buffer_.end(), source.begin(), source.end());
+
+        if (state_ == state::initial)
+        {
+            reader_.source({source_buffer_.data(), source_buffer_.size()});
+            incremental_ = true;
+            state_ = state::source_set;
+            return;
+        }
+
+        reader_.extend_source(previous_source_begin, {source_buffer_.data(), source_buffer_.size()});
+        if (scan_decoder_)
+        {
+            scan_decoder_->extend_source(reader_.remaining_source());
+        }
+    }
+
+    /// <summary>
+    /// Resets the decoder to decode a new source. Installed callbacks, the thread count and the scan decoder
+    /// (which is reused when the next image has the same parameters) are kept.
+    /// </summary>
+    void reset() noexcept
+    {
+        state_ = state::initial;
+        reader_.rewind();
+        incremental_ = false;
+        source_buffer_.clear();
+        retired_source_buffers_.clear();
+        scan_decoder_ = nullptr;
+        scan_header_read_ = true;
+        decoded_component_count_ = 0;
+        scan_destination_offset_ = 0;
+        scan_line_ = 0;
+        decoded_line_count_ = 0;
+    }
+
     bool read_header(CHARLS_OUT spiff_header* spiff_header)
     {
         check_operation(state_ == state::source_set);
+        check_header_available();
 
         bool spiff_header_found{};
         reader_.read_header(spiff_header, &spiff_header_found);
@@ -43,6 +108,7 @@ struct charls_jpegls_decoder final
     void read_header()
     {
         check_operation(state_ >= state::source_set && state_ < state::header_read);
+        check_header_available();
 
         if (state_ != state::spiff_header_not_found)
         {
@@ -174,25 +240,95 @@ struct charls_jpegls_decoder final
         reader_.get_mapping_table_data(mapping_table_index, table_data);
     }
 
+    void thread_count(const uint32_t thread_count) noexcept
+    {
+        thread_count_ = thread_count;
+    }
+
     void decode(span<byte> destination, const size_t stride)
     {
         check_argument(destination);
-        check_operation(state_ == state::header_read);
+        check_operation(state_ == state::header_read && decoded_line_count_ == 0);
 
         for (size_t component{};;)
         {
-            const size_t scan_stride{check_stride_and_destination_size(destination.size(), stride)};
+            size_t scan_stride;
+            if (thread_count_ != 1 && component + reader_.scan_component_count() < reader_.component_count())
+            {
+                scan_stride = decode_scans_parallel(destination, stride, component);
+            }
+            else
+            {
+                scan_stride = check_stride_and_destination_size(destination.size(), stride);
+
+                const scan next_scan{current_scan(destination.data(), scan_stride)};
+                const size_t bytes_read{thread_count_ == 1 ? decode_scan(next_scan) : decode_scan(next_scan, thread_count_)};
+                reader_.advance_position(bytes_read);
+                component += reader_.scan_component_count();
+            }
+
+            if (component == reader_.component_count())
+                break;
+
+            destination = destination.subspan(scan_stride * frame_info().height);
+            reader_.read_next_start_of_scan();
+        }
+
+        reader_.read_end_of_image();
+        state_ = state::completed;
+    }
+
+    /// <summary>
+    /// Decodes every item of the batch as a complete JPEG-LS byte stream. Every thread reuses its decoder (and with it
+    /// the scan decoder and its buffers) for the items it decodes.
+    /// </summary>
+    void decode_batch(const span<charls_batch_item> items) const
+    {
+        check_argument(items);
 
-            const auto decoder{make_scan_codec<scan_decoder>(
-                reader_.scan_frame_info(), reader_.get_validated_preset_coding_parameters(), reader_.parameters())};
-            const size_t bytes_read{decoder->decode_scan(reader_.remaining_source(), destination.data(), scan_stride)};
-            reader_.advance_position(bytes_read);
+        parallel_for_with_state(
+            items.size(), resolve_thread_count(thread_count_), [this] { return charls_jpegls_decoder{memory_resource_}; },
+            [&items](charls_jpegls_decoder& item_decoder, const size_t index) {
+                decode_batch_item(item_decoder, items[index]);
+            });
+    }
+
+    /// <summary>
+    /// Decodes the image in batches of lines_per_call lines into a small reusable buffer and passes every batch to
+    /// the handler. The memory usage is proportional to the width of the image instead of the complete image.
+    /// </summary>
+    void decode_to_line_handler(const uint32_t lines_per_call, const callback_function<at_decoded_lines_handler> handler)
+    {
+        check_argument(lines_per_call > 0 && handler.handler);
+        check_operation(state_ == state::header_read && decoded_line_count_ == 0);
 
+        memory_vector<byte> lines{memory_allocator<byte>{memory_resource_}};
+        for (size_t component{};;)
+        {
+            const uint32_t height{frame_info().height};
+            const size_t stride{calculate_minimum_stride()};
+            lines.resize(stride * std::min(lines_per_call, height));
+
+            auto& decoder{scan_decoder_cache_.get(reader_.scan_frame_info(),
+                                                  reader_.get_validated_preset_coding_parameters(), reader_.parameters())};
+            decoder.start_scan(reader_.remaining_source());
+            for (uint32_t line{}; line < height;)
+            {
+                const uint32_t line_count{std::min(lines_per_call, height - line)};
+                decoder.decode_lines(lines.data(), stride, line_count);
+                if (UNLIKELY(static_cast<bool>(handler.handler(lines.data(), stride * line_count,
+                                                               static_cast<uint32_t>(component), line, line_count,
+                                                               handler.user_context))))
+                    throw_jpegls_error(jpegls_errc::callback_failed);
+
+                line += line_count;
+            }
+
+            reader_.advance_position(decoder.end_scan());
             component += reader_.scan_component_count();
             if (component == reader_.component_count())
                 break;
 
-            destination = destination.subspan(scan_stride * frame_info().height);
             reader_.read_next_start_of_scan();
         }
 
@@ -200,7 +336,157 @@ struct charls_jpegls_decoder final
         state_ = state::completed;
     }
 
+    /// <summary>
+    /// Decodes only the lines and columns of a rectangle of the image. Decoding of a scan stops after the last line of
+    /// the rectangle; when the scan has restart intervals, decoding starts at the restart interval that holds the
+    /// first line of the rectangle. The scans of the other components are located with a marker search.
+    /// </summary>
+    void decode_rect(span<byte> destination, const size_t stride, const uint32_t x, const uint32_t y,
+                     const uint32_t width, const uint32_t height)
+    {
+        check_argument(destination);
+        check_operation(state_ == state::header_read && decoded_line_count_ == 0);
+        check_argument(width != 0 && height != 0 && x < frame_info().width && width <= frame_info().width - x &&
+                       y < frame_info().height && height <= frame_info().height - y);
+
+        memory_vector<byte> line{memory_allocator<byte>{memory_resource_}};
+        for (size_t component{};;)
+        {
+            const size_t rect_stride{check_stride_and_destination_size(destination.size(), stride, width, height)};
+            const size_t pixel_size{calculate_minimum_stride(1)};
+            const uint32_t restart_interval{reader_.parameters().restart_interval};
+
+            span<const byte> source{reader_.remaining_source()};
+            uint32_t first_line{};
+            size_t first_interval{};
+            if (restart_interval != 0 && y >= restart_interval)
+            {
+                // Skip the restart intervals before the rectangle without decoding them.
+                if (const auto interval_offsets{find_restart_interval_offsets(source, (y / restart_interval) + 1)};
+                    !interval_offsets.empty())
+                {
+                    first_interval = interval_offsets.size() - 1;
+                    first_line = static_cast<uint32_t>(first_interval * restart_interval);
+                    source = source.subspan(interval_offsets.back());
+                }
+            }
+
+            auto& decoder{scan_decoder_cache_.get(reader_.scan_frame_info(),
+                                                  reader_.get_validated_preset_coding_parameters(), reader_.parameters())};
+            decoder.start_scan(source);
+            decoder.restart_interval_index(first_interval);
+
+            const bool complete_lines{x == 0 && width == frame_info().width};
+            line.resize(calculate_minimum_stride());
+            for (uint32_t current_line{first_line}; current_line != y + height; ++current_line)
+            {
+                if (current_line >= y && complete_lines)
+                {
+                    decoder.decode_lines(destination.data() + ((current_line - y) * rect_stride), rect_stride,
+                                         y + height - current_line);
+                    break;
+                }
+
+                decoder.decode_lines(line.data(), line.size(), 1);
+                if (current_line >= y)
+                {
+                    std::copy_n(line.data() + (x * pixel_size), width * pixel_size,
+                                destination.data() + ((current_line - y) * rect_stride));
+                }
+            }
+
+            component += reader_.scan_component_count();
+            if (component == reader_.component_count())
+                break;
+
+            const size_t scan_size{find_end_of_scan(reader_.remaining_source(), restart_interval != 0)};
+            if (UNLIKELY(scan_size == reader_.remaining_source().size()))
+                throw_jpegls_error(jpegls_errc::need_more_data);
+
+            reader_.advance_position(scan_size);
+            destination = destination.subspan(rect_stride * height);
+            reader_.read_next_start_of_scan();
+        }
+
+        state_ = state::completed;
+    }
+
+    /// <summary>
+    /// Decodes the lines for which all encoded data has been appended. Returns true when the complete image
+    /// has been decoded. Must be called again with the same destination after more source data has been appended.
+    /// </summary>
+    bool decode_available(const span<byte> destination, const size_t stride)
+    {
+        check_argument(destination);
+        check_operation(state_ == state::header_read && incremental_);
+
+        for (;;)
+        {
+            if (!scan_header_read_)
+            {
+                if (!contains_complete_marker_segments(reader_.remaining_source()))
+                    return false;
+
+                if (decoded_component_count_ == reader_.component_count())
+                {
+                    reader_.read_end_of_image();
+                    state_ = state::completed;
+                    return true;
+                }
+
+                reader_.read_next_start_of_scan();
+                scan_header_read_ = true;
+            }
+
+            check_argument(destination.size() >= scan_destination_offset_, jpegls_errc::invalid_argument_size);
+            const size_t scan_stride{
+                check_stride_and_destination_size(destination.size() - scan_destination_offset_, stride)};
+
+            const uint32_t line_count{decodable_line_count()};
+            if (line_count == 0)
+                return false;
+
+            if (!scan_decoder_)
+            {
+                scan_decoder_ = &scan_decoder_cache_.get(reader_.scan_frame_info(),
+                                                         reader_.get_validated_preset_coding_parameters(),
+                                                         reader_.parameters());
+                scan_decoder_->start_scan(reader_.remaining_source());
+            }
+
+            scan_decoder_->decode_lines(destination.data() + scan_destination_offset_ + (scan_line_ * scan_stride),
+                                        scan_stride, line_count);
+            scan_line_ += line_count;
+            decoded_line_count_ += line_count;
+            if (scan_line_ != frame_info().height)
+                continue;
+
+            reader_.advance_position(scan_decoder_->end_scan());
+            scan_decoder_ = nullptr;
+            scan_line_ = 0;
+            scan_destination_offset_ += scan_stride * frame_info().height;
+            decoded_component_count_ += reader_.scan_component_count();
+            scan_header_read_ = false;
+        }
+    }
+
+    [[nodiscard]]
+    uint32_t decoded_line_count() const noexcept
+    {
+        return decoded_line_count_;
+    }
+
 private:
+    struct scan final
+    {
+        charls::frame_info frame_info;
+        jpegls_pc_parameters pc_parameters;
+        coding_parameters parameters;
+        span<const byte> source;
+        byte* destination;
+        size_t stride;
+    };
+
     [[nodiscard]]
     const charls::frame_info& frame_info() const noexcept
     {
@@ -208,9 +494,184 @@ struct charls_jpegls_decoder final
     }
 
     [[nodiscard]]
-    size_t check_stride_and_destination_size(const size_t destination_length, size_t stride) const
+    scan current_scan(byte* destination, const size_t stride) const
+    {
+        return {reader_.scan_frame_info(),
+                reader_.get_validated_preset_coding_parameters(),
+                reader_.parameters(),
+                reader_.remaining_source(),
+                destination,
+                stride};
+    }
+
+    static void decode_batch_item(charls_jpegls_decoder& item_decoder, charls_batch_item& item)
     {
-        const size_t minimum_stride{calculate_minimum_stride()};
+        try
+        {
+            item_decoder.reset();
+            item_decoder.source({static_cast<const byte*>(item.source), item.source_size});
+            item_decoder.read_header();
+            item.frame_info = item_decoder.frame_info_checked();
+            item_decoder.decode({static_cast<byte*>(item.destination), item.destination_size}, item.stride);
+            item.bytes_written = item_decoder.get_destination_size(item.stride);
+            item.error = jpegls_errc::success;
+        }
+        catch (...)
+        {
+            item.bytes_written = 0;
+            item.error = to_jpegls_errc();
+        }
+    }
+
+    /// <summary>
+    /// Decodes the next scans of an image that is encoded with multiple scans concurrently.
+    /// A marker pre-pass locates the end of the entropy coded data of every scan (the entropy coded data cannot
+    /// contain unescaped markers), which makes it possible to read all scan headers before decoding.
+    /// When the end of a scan cannot be found, the scans up to and including that scan are decoded first.
+    /// Returns the stride of the last decoded scan; destination will point to the destination of that scan.
+    /// </summary>
+    [[nodiscard]]
+    size_t decode_scans_parallel(span<byte>& destination, const size_t stride, size_t& component)
+    {
+        std::vector<scan> scans;
+        std::vector<size_t> scan_sizes;
+        std::exception_ptr read_exception;
+        for (;;)
+        {
+            scans.push_back(current_scan(destination.data(), check_stride_and_destination_size(destination.size(), stride)));
+
+            component += reader_.scan_component_count();
+            if (component == reader_.component_count())
+                break;
+
+            const size_t scan_size{find_end_of_scan(reader_.remaining_source(), reader_.parameters().restart_interval != 0)};
+            if (scan_size == reader_.remaining_source().size())
+                break;
+
+            try
+            {
+                scan_sizes.push_back(scan_size);
+                reader_.advance_position(scan_size);
+                destination = destination.subspan(scans.back().stride * frame_info().height);
+                reader_.read_next_start_of_scan();
+            }
+            catch (...)
+            {
+                // Decoding errors of the preceding scans need to be reported first.
+                read_exception = std::current_exception();
+                scan_sizes.pop_back();
+                break;
+            }
+        }
+
+        // Divide the available threads over the scans; remaining threads are used to decode restart intervals.
+        const uint32_t thread_count{resolve_thread_count(thread_count_)};
+        const auto scan_thread_count{std::max(static_cast<uint32_t>(thread_count / scans.size()), 1U)};
+        size_t last_scan_bytes_read{};
+        parallel_for(scans.size(), thread_count, [&](const size_t index) {
+            const size_t bytes_read{decode_scan(scans[index], scan_thread_count)};
+            if (index == scan_sizes.size())
+            {
+                last_scan_bytes_read = bytes_read;
+            }
+            else if (UNLIKELY(bytes_read != scan_sizes[index]))
+            {
+                throw_jpegls_error(jpegls_errc::invalid_data);
+            }
+        });
+
+        if (read_exception)
+            std::rethrow_exception(read_exception);
+
+        reader_.advance_position(last_scan_bytes_read);
+        return scans.back().stride;
+    }
+
+    /// <summary>
+    /// Decodes a scan on the calling thread with the scan decoder of the previous scan, when it can be reused.
+    /// </summary>
+    [[nodiscard]]
+    size_t decode_scan(const scan& current)
+    {
+        return scan_decoder_cache_.get(current.frame_info, current.pc_parameters, current.parameters)
+            .decode_scan(current.source, current.destination, current.stride);
+    }
+
+    [[nodiscard]]
+    size_t decode_scan(const scan& current, const uint32_t thread_count) const
+    {
+        if (thread_count != 1 && current.parameters.restart_interval != 0 &&
+            current.parameters.restart_interval < current.frame_info.height)
+        {
+            const size_t interval_count{(current.frame_info.height + current.parameters.restart_interval - 1) /
+                                        current.parameters.restart_interval};
+            if (const auto interval_offsets{find_restart_interval_offsets(current.source, interval_count)};
+                !interval_offsets.empty())
+                return decode_restart_intervals(current, interval_offsets, thread_count);
+        }
+
+        const auto decoder{
+            make_scan_codec<scan_decoder>(current.frame_info, current.pc_parameters, current.parameters, memory_resource_)};
+
+        // Copy the decoded lines of an interleaved scan to the destination on a second thread.
+        decoder->use_conversion_thread(current.parameters.interleave_mode != interleave_mode::none &&
+                                       resolve_thread_count(thread_count) > 1);
+        return decoder->decode_scan(current.source, current.destination, current.stride);
+    }
+
+    /// <summary>
+    /// Decodes the restart intervals of a scan concurrently. The intervals are divided in groups of consecutive
+    /// intervals; every group is decoded by its own scan decoder into a disjoint stripe of the destination.
+    /// </summary>
+    [[nodiscard]]
+    size_t decode_restart_intervals(const scan& current, const std::vector<size_t>& interval_offsets,
+                                    uint32_t thread_count) const
+    {
+        const size_t interval_count{interval_offsets.size()};
+        thread_count = resolve_thread_count(thread_count);
+        const size_t group_count{std::min(interval_count, static_cast<size_t>(thread_count))};
+        const uint32_t restart_interval{current.parameters.restart_interval};
+        size_t bytes_read{};
+
+        parallel_for(group_count, thread_count, [&](const size_t group) {
+            const size_t first_interval{group * interval_count / group_count};
+            const size_t end_interval{(group + 1) * interval_count / group_count};
+            const bool last_group{end_interval == interval_count};
+
+            const auto first_line{static_cast<uint32_t>(first_interval * restart_interval)};
+            charls::frame_info group_frame_info{current.frame_info};
+            group_frame_info.height = last_group ? current.frame_info.height - first_line
+                                                 : static_cast<uint32_t>((end_interval - first_interval) * restart_interval);
+
+            const size_t source_begin{interval_offsets[first_interval]};
+            const size_t source_end{last_group ? current.source.size() : interval_offsets[end_interval]};
+
+            const auto decoder{make_scan_codec<scan_decoder>(group_frame_info, current.pc_parameters,
+                                                             current.parameters, memory_resource_)};
+            decoder->restart_interval_index(first_interval);
+            const size_t group_bytes_read{
+                decoder->decode_scan({current.source.data() + source_begin, source_end - source_begin},
+                                     current.destination + (first_line * current.stride), current.stride)};
+            if (last_group)
+            {
+                bytes_read = source_begin + group_bytes_read;
+            }
+        });
+
+        return bytes_read;
+    }
+
+    [[nodiscard]]
+    size_t check_stride_and_destination_size(const size_t destination_length, const size_t stride) const
+    {
+        return check_stride_and_destination_size(destination_length, stride, frame_info().width, frame_info().height);
+    }
+
+    [[nodiscard]]
+    size_t check_stride_and_destination_size(const size_t destination_length, size_t stride, const uint32_t width,
+                                             const uint32_t height) const
+    {
+        const size_t minimum_stride{calculate_minimum_stride(width)};
 
         if (stride == auto_calculate_stride)
         {
@@ -223,7 +684,6 @@ struct charls_jpegls_decoder final
         }
 
         const size_t not_used_bytes_at_end{stride - minimum_stride};
-        const uint32_t height{reader_.frame_info().height};
         const size_t minimum_destination_scan_length{reader_.scan_interleave_mode() == interleave_mode::none
                                                          ? (stride * reader_.scan_component_count() * height) -
                                                                not_used_bytes_at_end
@@ -237,11 +697,72 @@ struct charls_jpegls_decoder final
 
     [[nodiscard]]
     size_t calculate_minimum_stride() const noexcept
+    {
+        return calculate_minimum_stride(frame_info().width);
+    }
+
+    [[nodiscard]]
+    size_t calculate_minimum_stride(const uint32_t width) const noexcept
     {
         const size_t components_in_plane_count{reader_.scan_interleave_mode() == interleave_mode::none
                                                    ? 1U
                                                    : static_cast<size_t>(reader_.scan_component_count())};
-        return components_in_plane_count * frame_info().width * bit_to_byte_count(frame_info().bits_per_sample);
+        return components_in_plane_count * width * bit_to_byte_count(frame_info().bits_per_sample);
+    }
+
+    void check_header_available() const
+    {
+        if (incremental_ && !contains_complete_marker_segments({source_buffer_.data(), source_buffer_.size()}))
+            throw_jpegls_error(jpegls_errc::need_more_data);
+    }
+
+    /// <summary>
+    /// Computes how many lines of the current scan can be decoded with the source data appended so far.
+    /// A line is only decoded when the worst-case encoded size of a line is available or when the end of the
+    /// restart interval (or scan) has been received, as the scan decoder cannot be suspended inside a line.
+    /// </summary>
+    [[nodiscard]]
+    uint32_t decodable_line_count() const noexcept
+    {
+        const uint32_t height{frame_info().height};
+        const uint32_t restart_interval{reader_.parameters().restart_interval == 0 ? height
+                                                                                   : reader_.parameters().restart_interval};
+        span<const byte> available{reader_.remaining_source()};
+        if (scan_decoder_)
+        {
+            available = available.subspan(scan_decoder_->read_position());
+        }
+
+        if (scan_line_ != 0 && scan_line_ % restart_interval == 0)
+        {
+            // The complete RSTm marker must be available before the next restart interval can be decoded.
+            const size_t marker_position{find_end_of_scan(available, false)};
+            if (marker_position == available.size())
+                return 0;
+
+            size_t marker_code_position{marker_position + 1};
+            while (available.data()[marker_code_position] == jpeg_marker_start_byte)
+            {
+                ++marker_code_position;
+            }
+            available = available.subspan(marker_code_position + 1);
+        }
+
+        const uint32_t line_count{std::min(height - scan_line_, restart_interval - (scan_line_ % restart_interval))};
+
+        // The last available byte may not be used, as it can be the start of a marker.
+        const size_t maximum_line_size{compute_maximum_encoded_line_size(
+            frame_info().width, reader_.scan_component_count(), frame_info().bits_per_sample)};
+        // The last line of a scan can only be decoded when the end of the scan is available, as it will be verified.
+        const bool last_line_of_scan{scan_line_ + line_count == height};
+        if (!last_line_of_scan && available.size() > maximum_line_size * line_count + 1)
+            return line_count;
+
+        if (find_end_of_scan(available, false) != available.size())
+            return line_count; // All encoded data of the restart interval (or scan) is available.
+
+        const size_t bounded_line_count{available.size() < 2 ? 0 : (available.size() - 2) / maximum_line_size};
+        return static_cast<uint32_t>(std::min(bounded_line_count, static_cast<size_t>(line_count) - 1));
     }
 
     void check_state_header_read() const
@@ -269,8 +790,22 @@ struct charls_jpegls_decoder final
         completed
     };
 
+    charls::memory_resource memory_resource_;
     state state_{};
-    jpeg_stream_reader reader_;
+    uint32_t thread_count_{1};
+    jpeg_stream_reader reader_{memory_resource_};
+    scan_codec_cache<scan_decoder> scan_decoder_cache_{memory_resource_};
+
+    // Incremental decoding: the appended source data and the position of decoding.
+    bool incremental_{};
+    memory_vector<byte> source_buffer_{memory_allocator<byte>{memory_resource_}};
+    memory_vector<memory_vector<byte>> retired_source_buffers_{memory_allocator<memory_vector<byte>>{memory_resource_}};
+    scan_decoder* scan_decoder_{};
+    bool scan_header_read_{true};
+    size_t decoded_component_count_{};
+    size_t scan_destination_offset_{};
+    uint32_t scan_line_{};
+    uint32_t decoded_line_count_{};
 };
 
 
@@ -278,16 +813,35 @@ extern "C" {
 
 USE_DECL_ANNOTATIONS charls_jpegls_decoder* CHARLS_API_CALLING_CONVENTION charls_jpegls_decoder_create() noexcept
 {
-    MSVC_WARNING_SUPPRESS_NEXT_LINE(26402 26409)     // don't use new and delete + scoped object and move
-    return new (std::nothrow) charls_jpegls_decoder; // NOLINT(cppcoreguidelines-owning-memory)
+    const auto& resource{default_memory_resource()};
+    return charls_jpegls_decoder_create_with_allocator(resource.allocate, resource.deallocate, resource.user_context);
+}
+
+
+USE_DECL_ANNOTATIONS charls_jpegls_decoder* CHARLS_API_CALLING_CONVENTION charls_jpegls_decoder_create_with_allocator(
+    const charls_allocate_handler allocate, const charls_deallocate_handler deallocate, void* user_context) noexcept
+{
+    if (!allocate || !deallocate)
+        return nullptr;
+
+    void* memory{allocate(sizeof(charls_jpegls_decoder), alignof(charls_jpegls_decoder), user_context)};
+    if (!memory)
+        return nullptr;
+
+    return new (memory) charls_jpegls_decoder({allocate, deallocate, user_context});
 }
 
 
 USE_DECL_ANNOTATIONS void CHARLS_API_CALLING_CONVENTION
 charls_jpegls_decoder_destroy(const charls_jpegls_decoder* decoder) noexcept
 {
-    MSVC_WARNING_SUPPRESS_NEXT_LINE(26401 26409) // don't use new and delete + non-owner.
-    delete decoder;                              // NOLINT(cppcoreguidelines-owning-memory)
+    if (!decoder)
+        return;
+
+    // The decoder owns the memory resource: copy it before the decoder is destroyed.
+    const charls::memory_resource resource{decoder->memory()};
+    decoder->~charls_jpegls_decoder();
+    resource.deallocate_bytes(const_cast<charls_jpegls_decoder*>(decoder), sizeof(charls_jpegls_decoder));
 }
 
 
@@ -304,6 +858,19 @@ catch (...)
 }
 
 
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_decoder_append_source_buffer(
+    charls_jpegls_decoder* decoder, const void* source_buffer, const size_t source_size_bytes) noexcept
+try
+{
+    check_pointer(decoder)->append_source({static_cast<const byte*>(source_buffer), source_size_bytes});
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
 USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_decoder_read_spiff_header(
     charls_jpegls_decoder* const decoder, charls_spiff_header* spiff_header, int32_t* header_found) noexcept
 try
@@ -409,6 +976,32 @@ catch (...)
 }
 
 
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_set_thread_count(charls_jpegls_decoder* decoder, const uint32_t thread_count) noexcept
+try
+{
+    check_pointer(decoder)->thread_count(thread_count);
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_reset(charls_jpegls_decoder* decoder) noexcept
+try
+{
+    check_pointer(decoder)->reset();
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
 USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
 charls_jpegls_decoder_decode_to_buffer(charls_jpegls_decoder* decoder, void* destination_buffer,
                                        const size_t destination_size_bytes, const uint32_t stride) noexcept
@@ -423,6 +1016,65 @@ catch (...)
 }
 
 
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_decoder_decode_available_to_buffer(
+    charls_jpegls_decoder* decoder, void* destination_buffer, const size_t destination_size_bytes, const uint32_t stride,
+    uint32_t* decoded_line_count) noexcept
+try
+{
+    uint32_t& line_count{*check_pointer(decoded_line_count)};
+    const bool completed{check_pointer(decoder)->decode_available(
+        {static_cast<byte*>(destination_buffer), destination_size_bytes}, stride)};
+    line_count = decoder->decoded_line_count();
+    return completed ? jpegls_errc::success : jpegls_errc::need_more_data;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_decoder_decode_to_line_handler(
+    charls_jpegls_decoder* decoder, const uint32_t lines_per_call, const charls_at_decoded_lines_handler handler,
+    void* user_context) noexcept
+try
+{
+    check_pointer(decoder)->decode_to_line_handler(lines_per_call, {handler, user_context});
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_decoder_decode_rect(
+    charls_jpegls_decoder* decoder, const uint32_t x, const uint32_t y, const uint32_t width, const uint32_t height,
+    void* destination_buffer, const size_t destination_size_bytes, const uint32_t stride) noexcept
+try
+{
+    check_pointer(decoder)->decode_rect({static_cast<byte*>(destination_buffer), destination_size_bytes}, stride, x, y,
+                                        width, height);
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_decoder_decode_batch(
+    const charls_jpegls_decoder* decoder, charls_batch_item* items, const size_t item_count) noexcept
+try
+{
+    check_pointer(decoder)->decode_batch({items, item_count});
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
 USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_decoder_at_comment(
     charls_jpegls_decoder* decoder, const charls_at_comment_handler handler, void* user_context) noexcept
 try
@@ -8,8 +8,11 @@
 
 #include "color_transform.hpp"
 #include "jpeg_stream_writer.hpp"
+#include "jpegls_algorithm.hpp"
 #include "jpegls_preset_coding_parameters.hpp"
 #include "make_scan_codec.hpp"
+#include "memory_allocator.hpp"
+#include "parallel.hpp"
 #include "scan_encoder.hpp"
 #include "util.hpp"
 
@@ -31,6 +34,16 @@ constexpr bool has_option(const encoding_options options, const encoding_options
 
 struct charls_jpegls_encoder final
 {
+    explicit charls_jpegls_encoder(const charls::memory_resource& resource) noexcept : memory_resource_{resource}
+    {
+    }
+
+    [[nodiscard]]
+    const charls::memory_resource& memory() const noexcept
+    {
+        return memory_resource_;
+    }
+
     void destination(const span<byte> destination)
     {
         check_argument(destination);
@@ -52,6 +65,15 @@ struct charls_jpegls_encoder final
         frame_info_ = frame_info;
     }
 
+    void destination(const callback_function<at_encoded_data_handler> encoded_data_handler)
+    {
+        check_argument(encoded_data_handler.handler != nullptr);
+        check_operation(state_ <= state::destination_set);
+
+        writer_.destination(encoded_data_handler);
+        state_ = state::destination_set;
+    }
+
     void interleave_mode(const interleave_mode interleave_mode)
     {
         check_interleave_mode(interleave_mode, jpegls_errc::invalid_argument_interleave_mode);
@@ -92,6 +114,17 @@ struct charls_jpegls_encoder final
         color_transformation_ = color_transformation;
     }
 
+    void restart_interval(const uint32_t restart_interval) noexcept
+    {
+        // Note: all values are valid, the JPEG-LS standard supports restart intervals up to 2^32 - 1 lines.
+        restart_interval_ = restart_interval;
+    }
+
+    void thread_count(const uint32_t thread_count) noexcept
+    {
+        thread_count_ = thread_count;
+    }
+
     void set_mapping_table_id(const int32_t component_index, const int32_t table_id)
     {
         check_argument_range(minimum_component_index, maximum_component_index, component_index);
@@ -110,9 +143,37 @@ struct charls_jpegls_encoder final
 
         // For the worst case: add 6.25% + extra bytes for the headers.
         size = add_sat(size, (size / 16U) + 1024 + spiff_header_size_in_bytes);
+
+        size = add_sat(size, checked_mul(restart_markers_size(), static_cast<size_t>(frame_info_.component_count)));
+
+        if (encode_scans_in_parallel(frame_info_.component_count))
+        {
+            // Every scan is encoded in its own part of the destination, which also reserves space for its SOS segment.
+            size = add_sat(size, static_cast<size_t>(frame_info_.component_count) *
+                                     single_component_start_of_scan_segment_size);
+        }
+
+        if (encode_restart_intervals_in_parallel())
+        {
+            // Every part of a scan that is encoded concurrently reserves space for the RSTm marker that follows it.
+            size = add_sat(size, checked_mul(static_cast<size_t>(resolve_thread_count(thread_count_)),
+                                             static_cast<size_t>(frame_info_.component_count) * restart_marker_size));
+        }
+
         return size;
     }
 
+    [[nodiscard]]
+    size_t estimated_tiles_destination_size(const uint32_t tile_width, const uint32_t tile_height) const
+    {
+        check_operation(is_frame_info_configured());
+        check_argument(tile_width != 0 && tile_height != 0);
+
+        return checked_mul(tile_count(tile_width, tile_height),
+                           estimated_tile_size(std::min(tile_width, frame_info_.width),
+                                               std::min(tile_height, frame_info_.height)));
+    }
+
     void write_spiff_header(const spiff_header& spiff_header)
     {
         check_argument_range(minimum_height, maximum_height, spiff_header.height, jpegls_errc::invalid_argument_height);
@@ -187,39 +248,28 @@ struct charls_jpegls_encoder final
     void encode_components(span<const byte> source, const int32_t source_component_count, const size_t stride)
     {
         check_argument(source);
-        check_state_can_write();
-        check_operation(is_frame_info_configured());
-        check_interleave_mode_against_component_count();
-        const int32_t maximum_bit_sample_value{calculate_maximum_bit_sample_value(frame_info_.bits_per_sample)};
-        check_near_lossless_maximum(maximum_bit_sample_value);
+        const int32_t maximum_bit_sample_value{check_encode_parameters()};
         const size_t scan_stride{check_stride_and_source_size(source.size(), stride, source_component_count)};
-
-        if (UNLIKELY(!is_valid(user_preset_coding_parameters_, maximum_bit_sample_value, near_lossless_,
-                               &preset_coding_parameters_)))
-            throw_jpegls_error(jpegls_errc::invalid_argument_jpegls_pc_parameters);
-
-        if (encoded_component_count_ == 0)
-        {
-            transition_to_tables_and_miscellaneous_state();
-            write_color_transform_segment();
-            write_start_of_frame_segment();
-            write_jpegls_preset_parameters_segment(maximum_bit_sample_value);
-        }
+        write_segments_before_scan(maximum_bit_sample_value);
 
         if (interleave_mode_ == interleave_mode::none)
         {
-            const size_t byte_count_component{scan_stride * frame_info_.height};
-            for (int32_t component{};;)
+            if (!encode_scans_in_parallel(source_component_count) ||
+                !try_encode_component_scans_parallel(source, scan_stride, source_component_count))
             {
-                writer_.write_start_of_scan_segment(1, near_lossless_, interleave_mode_);
-                encode_scan(source.data(), scan_stride, 1);
-
-                ++component;
-                if (component == source_component_count)
-                    break;
-
-                // Synchronize the source stream (encode_scan works on a local copy)
-                source = source.subspan(byte_count_component);
+                const size_t byte_count_component{scan_stride * frame_info_.height};
+                for (int32_t component{};;)
+                {
+                    writer_.write_start_of_scan_segment(1, near_lossless_, interleave_mode_);
+                    encode_scan(source.data(), scan_stride, 1);
+
+                    ++component;
+                    if (component == source_component_count)
+                        break;
+
+                    // Synchronize the source stream (encode_scan works on a local copy)
+                    source = source.subspan(byte_count_component);
+                }
             }
         }
         else
@@ -235,6 +285,90 @@ struct charls_jpegls_encoder final
         }
     }
 
+    /// <summary>
+    /// Encodes the next line_count lines of the image. The lines of a scan are encoded directly to the destination,
+    /// which makes it possible to encode an image while its lines become available.
+    /// Images with interleave mode none expect all lines of the first component, followed by the next component.
+    /// </summary>
+    void encode_lines(span<const byte> source, uint32_t line_count, const size_t stride)
+    {
+        check_argument(source);
+
+        const int32_t scan_component_count{interleave_mode_ == interleave_mode::none
+                                               ? 1
+                                               : frame_info_.component_count - encoded_component_count_};
+        if (!scan_encoder_)
+        {
+            const int32_t maximum_bit_sample_value{check_encode_parameters()};
+            const size_t scan_stride{check_stride_and_line_count(source.size(), stride, line_count, scan_component_count)};
+            write_segments_before_scan(maximum_bit_sample_value);
+            start_scan(scan_component_count);
+            encode_lines(source.data(), scan_stride, line_count, scan_component_count);
+            return;
+        }
+
+        encode_lines(source.data(), check_stride_and_line_count(source.size(), stride, line_count, scan_component_count),
+                     line_count, scan_component_count);
+    }
+
+    /// <summary>
+    /// Encodes the image as a grid of tiles, every tile as an independent JPEG-LS byte stream in the destination.
+    /// </summary>
+    void encode_tiles(const span<const byte> source, const size_t stride, const uint32_t tile_width,
+                      const uint32_t tile_height, const span<charls_tile_info> tiles)
+    {
+        check_argument(source);
+        check_argument(tiles);
+        check_argument(tile_width != 0 && tile_height != 0);
+        check_operation(state_ == state::destination_set && !writer_.has_encoded_data_handler());
+        check_operation(is_frame_info_configured());
+        check_interleave_mode_against_component_count();
+        const size_t source_stride{check_stride_and_source_size(source.size(), stride, frame_info_.component_count)};
+
+        const size_t count{tile_count(tile_width, tile_height)};
+        check_argument(tiles.size() >= count, jpegls_errc::invalid_argument_size);
+
+        const uint32_t tile_column_count{(frame_info_.width + tile_width - 1) / tile_width};
+        for (size_t i{}; i != count; ++i)
+        {
+            auto& tile{tiles[i]};
+            tile.x = static_cast<uint32_t>(i % tile_column_count) * tile_width;
+            tile.y = static_cast<uint32_t>(i / tile_column_count) * tile_height;
+            tile.width = std::min(tile_width, frame_info_.width - tile.x);
+            tile.height = std::min(tile_height, frame_info_.height - tile.y);
+        }
+
+        const span<charls_tile_info> encoded_tiles{tiles.data(), count};
+        if (resolve_thread_count(thread_count_) == 1 || !try_encode_tiles_parallel(source, source_stride, encoded_tiles))
+        {
+            charls_jpegls_encoder tile_encoder{memory_resource_};
+            copy_coding_parameters_to(tile_encoder);
+            for (auto& tile : encoded_tiles)
+            {
+                tile.offset = writer_.bytes_written();
+                tile.size = encode_tile(tile_encoder, source, source_stride, tile, writer_.remaining_destination());
+                writer_.advance_position(tile.size);
+            }
+        }
+
+        state_ = state::completed;
+    }
+
+    /// <summary>
+    /// Encodes every item of the batch as a complete JPEG-LS byte stream with the coding parameters of this encoder.
+    /// Every thread reuses its encoder (and with it the scan encoder and its buffers) for the items it encodes.
+    /// </summary>
+    void encode_batch(const span<charls_batch_item> items) const
+    {
+        check_argument(items);
+
+        parallel_for_with_state(
+            items.size(), resolve_thread_count(thread_count_), [this] { return charls_jpegls_encoder{memory_resource_}; },
+            [this, &items](charls_jpegls_encoder& item_encoder, const size_t index) {
+                encode_batch_item(item_encoder, items[index]);
+            });
+    }
+
     void create_abbreviated_format()
     {
         check_operation(state_ == state::tables_and_miscellaneous);
@@ -255,6 +389,10 @@ struct charls_jpegls_encoder final
         writer_.rewind();
         state_ = state::destination_set;
         encoded_component_count_ = 0;
+        written_restart_interval_ = 0;
+        scan_encoder_ = nullptr;
+        scan_byte_count_ = 0;
+        scan_line_ = 0;
     }
 
 private:
@@ -273,6 +411,176 @@ struct charls_jpegls_encoder final
         return frame_info_.width != 0;
     }
 
+    /// <summary>
+    /// Validates the parameters that are needed to encode a scan and returns the maximum sample value.
+    /// </summary>
+    [[nodiscard]]
+    int32_t check_encode_parameters() const
+    {
+        check_state_can_write();
+        check_operation(is_frame_info_configured());
+        check_interleave_mode_against_component_count();
+        const int32_t maximum_bit_sample_value{calculate_maximum_bit_sample_value(frame_info_.bits_per_sample)};
+        check_near_lossless_maximum(maximum_bit_sample_value);
+        return maximum_bit_sample_value;
+    }
+
+    void write_segments_before_scan(const int32_t maximum_bit_sample_value)
+    {
+        if (UNLIKELY(!is_valid(user_preset_coding_parameters_, maximum_bit_sample_value, near_lossless_,
+                               &preset_coding_parameters_)))
+            throw_jpegls_error(jpegls_errc::invalid_argument_jpegls_pc_parameters);
+
+        if (encoded_component_count_ == 0)
+        {
+            transition_to_tables_and_miscellaneous_state();
+            write_color_transform_segment();
+            write_start_of_frame_segment();
+            write_jpegls_preset_parameters_segment(maximum_bit_sample_value);
+        }
+
+        write_define_restart_interval_segment();
+    }
+
+    void start_scan(const int32_t component_count)
+    {
+        writer_.write_start_of_scan_segment(component_count, near_lossless_, interleave_mode_);
+        start_scan_encoder(component_count);
+    }
+
+    void start_scan_encoder(const int32_t component_count, const bool conversion_thread = false)
+    {
+        scan_encoder_ = &scan_encoder_cache_.get(
+            {frame_info_.width, frame_info_.height, frame_info_.bits_per_sample, component_count}, preset_coding_parameters_,
+            {near_lossless_, restart_interval_, interleave_mode_, color_transformation_});
+        scan_encoder_->use_conversion_thread(conversion_thread);
+        scan_encoder_->start_scan(writer_.remaining_destination());
+    }
+
+    /// <summary>
+    /// Returns true when the source lines of an interleaved scan can be copied to the line buffer of the scan encoder
+    /// on a second thread. Not used when the encoded bytes are passed to a handler, as the lines are then encoded in
+    /// many small batches.
+    /// </summary>
+    [[nodiscard]]
+    bool use_conversion_thread() const noexcept
+    {
+        return interleave_mode_ != interleave_mode::none && resolve_thread_count(thread_count_) > 1 &&
+               !writer_.has_encoded_data_handler();
+    }
+
+    /// <summary>
+    /// Encodes lines with the scan encoder. When the encoded bytes are passed to a handler, the lines are encoded in
+    /// batches that are guaranteed to fit in the buffer of the writer, which is flushed when needed.
+    /// </summary>
+    void encode_scan_lines(const byte* source, const size_t stride, uint32_t line_count, const int32_t component_count)
+    {
+        if (writer_.has_encoded_data_handler())
+        {
+            constexpr size_t end_of_interval_size{16}; // Room to complete the scan or to write a RSTm marker.
+            const size_t maximum_line_size{
+                compute_maximum_encoded_line_size(frame_info_.width, component_count, frame_info_.bits_per_sample) +
+                end_of_interval_size};
+            while (line_count != 0)
+            {
+                size_t fitting_line_count{scan_encoder_->remaining_destination_size() / maximum_line_size};
+                if (fitting_line_count == 0)
+                {
+                    commit_scan_bytes();
+                    writer_.flush_encoded_data(maximum_line_size);
+                    scan_encoder_->continue_in(writer_.remaining_destination());
+                    fitting_line_count = scan_encoder_->remaining_destination_size() / maximum_line_size;
+                }
+
+                const uint32_t batch_line_count{
+                    static_cast<uint32_t>(std::min(fitting_line_count, static_cast<size_t>(line_count)))};
+                scan_encoder_->encode_lines(source, stride, batch_line_count);
+                source += batch_line_count * stride;
+                line_count -= batch_line_count;
+            }
+        }
+        else
+        {
+            scan_encoder_->encode_lines(source, stride, line_count);
+        }
+
+        commit_scan_bytes();
+    }
+
+    /// <summary>
+    /// Synchronizes the position of the writer with the bytes written by the scan encoder.
+    /// </summary>
+    void commit_scan_bytes() noexcept
+    {
+        writer_.advance_position(scan_encoder_->bytes_written() - scan_byte_count_);
+        scan_byte_count_ = scan_encoder_->bytes_written();
+    }
+
+    void finish_scan()
+    {
+        const size_t scan_length{scan_encoder_->finish_scan()};
+        writer_.advance_position(scan_length - scan_byte_count_);
+        scan_encoder_ = nullptr;
+        scan_byte_count_ = 0;
+    }
+
+    void encode_lines(const byte* source, const size_t stride, uint32_t line_count, const int32_t scan_component_count)
+    {
+        for (;;)
+        {
+            const uint32_t scan_line_count{std::min(line_count, frame_info_.height - scan_line_)};
+            encode_scan_lines(source, stride, scan_line_count, scan_component_count);
+            scan_line_ += scan_line_count;
+            line_count -= scan_line_count;
+            if (scan_line_ != frame_info_.height)
+                return;
+
+            finish_scan();
+            scan_line_ = 0;
+            encoded_component_count_ += scan_component_count;
+            if (encoded_component_count_ == frame_info_.component_count)
+            {
+                write_end_of_image();
+                return;
+            }
+
+            if (line_count == 0)
+                return;
+
+            // Only possible for interleave mode none: the remaining lines belong to the next component.
+            source += static_cast<size_t>(scan_line_count) * stride;
+            write_define_restart_interval_segment();
+            start_scan(scan_component_count);
+        }
+    }
+
+    [[nodiscard]]
+    size_t check_stride_and_line_count(const size_t source_size, size_t stride, const uint32_t line_count,
+                                       const int32_t scan_component_count) const
+    {
+        const size_t minimum_stride{calculate_minimum_stride(scan_component_count)};
+        if (stride == auto_calculate_stride)
+        {
+            stride = minimum_stride;
+        }
+        else
+        {
+            if (UNLIKELY(stride < minimum_stride))
+                throw_jpegls_error(jpegls_errc::invalid_argument_stride);
+        }
+
+        const size_t remaining_scan_count{interleave_mode_ == interleave_mode::none
+                                              ? static_cast<size_t>(frame_info_.component_count - encoded_component_count_)
+                                              : 1U};
+        const size_t remaining_line_count{(remaining_scan_count * frame_info_.height) - scan_line_};
+        check_argument(line_count != 0 && line_count <= remaining_line_count);
+
+        if (UNLIKELY(source_size < checked_mul(stride, static_cast<size_t>(line_count)) - (stride - minimum_stride)))
+            throw_jpegls_error(jpegls_errc::invalid_argument_size);
+
+        return stride;
+    }
+
     void write_spiff_header_core(const spiff_header& spiff_header)
     {
         check_operation(state_ == state::destination_set);
@@ -283,16 +591,320 @@ struct charls_jpegls_encoder final
     }
 
     void encode_scan(const byte* source, const size_t stride, const int32_t component_count)
+    {
+        if (encode_restart_intervals_in_parallel() &&
+            try_encode_restart_intervals_parallel(source, stride, component_count))
+            return;
+
+        start_scan_encoder(component_count, use_conversion_thread());
+        encode_scan_lines(source, stride, frame_info_.height, component_count);
+        finish_scan();
+    }
+
+    [[nodiscard]]
+    size_t encode_scan(const byte* source, const size_t stride, const int32_t component_count,
+                       const span<byte> destination) const
     {
         const charls::frame_info frame_info{frame_info_.width, frame_info_.height, frame_info_.bits_per_sample,
                                             component_count};
 
-        const auto encoder{make_scan_codec<scan_encoder>(frame_info, preset_coding_parameters_,
-                                                         {near_lossless_, 0, interleave_mode_, color_transformation_})};
-        const size_t bytes_written{encoder->encode_scan(source, stride, writer_.remaining_destination())};
+        const auto encoder{make_scan_codec<scan_encoder>(
+            frame_info, preset_coding_parameters_,
+            {near_lossless_, restart_interval_, interleave_mode_, color_transformation_}, memory_resource_)};
+        return encoder->encode_scan(source, stride, destination);
+    }
 
-        // Synchronize the destination encapsulated in the writer (encode_scan works on a local copy)
-        writer_.advance_position(bytes_written);
+    [[nodiscard]]
+    bool encode_scans_in_parallel(const int32_t component_count) const noexcept
+    {
+        return resolve_thread_count(thread_count_) > 1 && interleave_mode_ == interleave_mode::none &&
+               component_count > 1 && !writer_.has_encoded_data_handler();
+    }
+
+    /// <summary>
+    /// Encodes the scans of the components concurrently. Every scan is first encoded into its own part of the
+    /// destination; the parts are then moved (in order) behind their SOS segments.
+    /// Returns false when there is not enough space to do this: the scans then need to be encoded sequentially.
+    /// </summary>
+    [[nodiscard]]
+    bool try_encode_component_scans_parallel(const span<const byte> source, const size_t stride,
+                                             const int32_t component_count)
+    {
+        const size_t scan_capacity{estimated_scan_size()};
+        const size_t part_size{single_component_start_of_scan_segment_size + scan_capacity};
+        const span<byte> destination{writer_.remaining_destination()};
+        if (destination.size() / static_cast<size_t>(component_count) < part_size)
+            return false;
+
+        const auto scan_data{[&destination, part_size](const size_t component) noexcept {
+            return destination.data() + (component * part_size) + single_component_start_of_scan_segment_size;
+        }};
+
+        const size_t byte_count_component{stride * frame_info_.height};
+        std::vector<size_t> scan_sizes(static_cast<size_t>(component_count));
+        try
+        {
+            parallel_for(scan_sizes.size(), resolve_thread_count(thread_count_), [&](const size_t component) {
+                scan_sizes[component] = encode_scan(source.data() + (component * byte_count_component), stride, 1,
+                                                    {scan_data(component), scan_capacity});
+            });
+        }
+        catch (const jpegls_error& error)
+        {
+            if (error.code() == jpegls_errc::destination_too_small)
+                return false; // A scan didn't fit in its part, the complete destination may still be large enough.
+
+            throw;
+        }
+
+        for (size_t component{}; component != scan_sizes.size(); ++component)
+        {
+            writer_.write_start_of_scan_segment(1, near_lossless_, interleave_mode_);
+            memmove(writer_.remaining_destination().data(), scan_data(component), scan_sizes[component]);
+            writer_.advance_position(scan_sizes[component]);
+        }
+
+        return true;
+    }
+
+    [[nodiscard]]
+    bool encode_restart_intervals_in_parallel() const noexcept
+    {
+        return restart_interval_ != 0 && restart_interval_ < frame_info_.height &&
+               resolve_thread_count(thread_count_) > 1 && !writer_.has_encoded_data_handler();
+    }
+
+    /// <summary>
+    /// Encodes the restart intervals of a scan concurrently. The intervals are divided in groups of consecutive
+    /// intervals; every group is encoded by its own scan encoder into its own part of the destination, with the RSTm
+    /// markers numbered as in the complete scan. The parts are then moved (in order) behind each other, separated by
+    /// the RSTm marker that completes the last interval of the previous part.
+    /// Returns false when there is not enough space to do this: the scan then needs to be encoded sequentially.
+    /// </summary>
+    [[nodiscard]]
+    bool try_encode_restart_intervals_parallel(const byte* source, const size_t stride, const int32_t component_count)
+    {
+        const size_t interval_count{(static_cast<size_t>(frame_info_.height) + restart_interval_ - 1) / restart_interval_};
+        const uint32_t thread_count{resolve_thread_count(thread_count_)};
+        const size_t part_count{std::min(interval_count, static_cast<size_t>(thread_count))};
+        const auto first_line{[this, interval_count, part_count](const size_t part) noexcept {
+            return static_cast<uint32_t>(
+                std::min(part * interval_count / part_count * restart_interval_, static_cast<size_t>(frame_info_.height)));
+        }};
+
+        // Every part reserves space for the RSTm marker that follows it.
+        std::vector<size_t> part_offsets(part_count + 1);
+        for (size_t part{}; part != part_count; ++part)
+        {
+            part_offsets[part + 1] = add_sat(
+                part_offsets[part],
+                estimated_scan_size(first_line(part + 1) - first_line(part), component_count) + restart_marker_size);
+        }
+
+        const span<byte> destination{writer_.remaining_destination()};
+        if (destination.size() < part_offsets.back())
+            return false;
+
+        std::vector<size_t> part_sizes(part_count);
+        try
+        {
+            parallel_for(part_count, thread_count, [&](const size_t part) {
+                const uint32_t line_count{first_line(part + 1) - first_line(part)};
+                const auto encoder{make_scan_codec<scan_encoder>(
+                    {frame_info_.width, line_count, frame_info_.bits_per_sample, component_count},
+                    preset_coding_parameters_, {near_lossless_, restart_interval_, interleave_mode_, color_transformation_},
+                    memory_resource_)};
+                encoder->start_scan({destination.data() + part_offsets[part],
+                                     part_offsets[part + 1] - part_offsets[part] - restart_marker_size},
+                                    first_line(part) / restart_interval_);
+                encoder->encode_lines(source + (first_line(part) * stride), stride, line_count);
+                part_sizes[part] = encoder->finish_scan();
+            });
+        }
+        catch (const jpegls_error& error)
+        {
+            if (error.code() == jpegls_errc::destination_too_small)
+                return false; // A part didn't fit, the complete destination may still be large enough.
+
+            throw;
+        }
+
+        for (size_t part{};; ++part)
+        {
+            memmove(writer_.remaining_destination().data(), destination.data() + part_offsets[part], part_sizes[part]);
+            writer_.advance_position(part_sizes[part]);
+            if (part + 1 == part_count)
+                return true;
+
+            writer_.write_restart_marker((first_line(part + 1) / restart_interval_) - 1);
+        }
+    }
+
+    [[nodiscard]]
+    size_t tile_count(const uint32_t tile_width, const uint32_t tile_height) const noexcept
+    {
+        return static_cast<size_t>((frame_info_.width + tile_width - 1) / tile_width) *
+               ((frame_info_.height + tile_height - 1) / tile_height);
+    }
+
+    [[nodiscard]]
+    size_t estimated_tile_size(const uint32_t width, const uint32_t height) const
+    {
+        charls_jpegls_encoder tile_encoder{memory_resource_};
+        copy_coding_parameters_to(tile_encoder);
+        tile_encoder.frame_info({width, height, frame_info_.bits_per_sample, frame_info_.component_count});
+        return tile_encoder.estimated_destination_size();
+    }
+
+    void encode_batch_item(charls_jpegls_encoder& item_encoder, charls_batch_item& item) const
+    {
+        try
+        {
+            copy_coding_parameters_to(item_encoder);
+            item_encoder.rewind();
+            item_encoder.frame_info(item.frame_info);
+            item_encoder.destination({static_cast<byte*>(item.destination), item.destination_size});
+            item_encoder.encode({static_cast<const byte*>(item.source), item.source_size}, item.stride);
+            item.bytes_written = item_encoder.bytes_written();
+            item.error = jpegls_errc::success;
+        }
+        catch (...)
+        {
+            item.bytes_written = 0;
+            item.error = to_jpegls_errc();
+        }
+    }
+
+    void copy_coding_parameters_to(charls_jpegls_encoder& tile_encoder) const
+    {
+        tile_encoder.near_lossless_ = near_lossless_;
+        tile_encoder.restart_interval_ = restart_interval_;
+        tile_encoder.interleave_mode_ = interleave_mode_;
+        tile_encoder.color_transformation_ = color_transformation_;
+        tile_encoder.encoding_options_ = encoding_options_;
+        tile_encoder.user_preset_coding_parameters_ = user_preset_coding_parameters_;
+        writer_.copy_mapping_table_ids_to(tile_encoder.writer_);
+    }
+
+    /// <summary>
+    /// Encodes a tile with the tile encoder as a complete JPEG-LS byte stream. The tile encoder keeps its scan
+    /// encoder, which is reused for the next tile with the same size.
+    /// </summary>
+    [[nodiscard]]
+    size_t encode_tile(charls_jpegls_encoder& tile_encoder, const span<const byte> source, const size_t stride,
+                       const charls_tile_info& tile, const span<byte> destination) const
+    {
+        tile_encoder.rewind();
+        tile_encoder.destination(destination);
+        tile_encoder.frame_info({tile.width, tile.height, frame_info_.bits_per_sample, frame_info_.component_count});
+
+        const size_t bytes_per_sample{bit_to_byte_count(frame_info_.bits_per_sample)};
+        if (interleave_mode_ == interleave_mode::none)
+        {
+            const size_t byte_count_component{stride * frame_info_.height};
+            for (int32_t component{}; component != frame_info_.component_count; ++component)
+            {
+                const size_t offset{(static_cast<size_t>(component) * byte_count_component) + (tile.y * stride) +
+                                    (tile.x * bytes_per_sample)};
+                tile_encoder.encode_components(source.subspan(offset), 1, stride);
+            }
+        }
+        else
+        {
+            const size_t offset{(tile.y * stride) +
+                                (tile.x * bytes_per_sample * static_cast<size_t>(frame_info_.component_count))};
+            tile_encoder.encode(source.subspan(offset), stride);
+        }
+
+        return tile_encoder.bytes_written();
+    }
+
+    /// <summary>
+    /// Encodes the tiles concurrently. The tiles are divided in groups of consecutive tiles, every group is encoded
+    /// by its own tile encoder. Every tile is first encoded into its own part of the destination; the parts are then
+    /// moved (in order) to the start of the destination.
+    /// Returns false when there is not enough space to do this: the tiles then need to be encoded sequentially.
+    /// </summary>
+    [[nodiscard]]
+    bool try_encode_tiles_parallel(const span<const byte> source, const size_t stride, const span<charls_tile_info> tiles)
+    {
+        // The first tile has the maximum tile size.
+        const size_t part_size{estimated_tile_size(tiles[0].width, tiles[0].height)};
+        const span<byte> destination{writer_.remaining_destination()};
+        if (destination.size() / tiles.size() < part_size)
+            return false;
+
+        const uint32_t thread_count{resolve_thread_count(thread_count_)};
+        const size_t group_count{std::min(tiles.size(), static_cast<size_t>(thread_count))};
+        try
+        {
+            parallel_for(group_count, thread_count, [&](const size_t group) {
+                charls_jpegls_encoder tile_encoder{memory_resource_};
+                copy_coding_parameters_to(tile_encoder);
+
+                const size_t end_tile{(group + 1) * tiles.size() / group_count};
+                for (size_t i{group * tiles.size() / group_count}; i != end_tile; ++i)
+                {
+                    tiles[i].size = encode_tile(tile_encoder, source, stride, tiles[i],
+                                                {destination.data() + (i * part_size), part_size});
+                }
+            });
+        }
+        catch (const jpegls_error& error)
+        {
+            if (error.code() == jpegls_errc::destination_too_small)
+                return false; // A tile didn't fit in its part, the complete destination may still be large enough.
+
+            throw;
+        }
+
+        for (size_t i{}; i != tiles.size(); ++i)
+        {
+            tiles[i].offset = writer_.bytes_written();
+            memmove(writer_.remaining_destination().data(), destination.data() + (i * part_size), tiles[i].size);
+            writer_.advance_position(tiles[i].size);
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    /// Returns the estimated size of the encoded data of a single component scan.
+    /// </summary>
+    [[nodiscard]]
+    size_t estimated_scan_size() const
+    {
+        return estimated_scan_size(frame_info_.height, 1);
+    }
+
+    /// <summary>
+    /// Returns the estimated size of the encoded data of line_count lines of a scan, including their RSTm markers.
+    /// </summary>
+    [[nodiscard]]
+    size_t estimated_scan_size(const uint32_t line_count, const int32_t component_count) const
+    {
+        size_t size{checked_mul(checked_mul(checked_mul(frame_info_.width, line_count),
+                                            static_cast<size_t>(component_count)),
+                                bit_to_byte_count(frame_info_.bits_per_sample))};
+        size = add_sat(size, size / 16U);
+        return add_sat(size, restart_markers_size(line_count));
+    }
+
+    [[nodiscard]]
+    size_t restart_markers_size() const noexcept
+    {
+        return restart_markers_size(frame_info_.height);
+    }
+
+    [[nodiscard]]
+    size_t restart_markers_size(const uint32_t line_count) const noexcept
+    {
+        if (restart_interval_ == 0)
+            return 0;
+
+        // Every restart interval ends with byte alignment (+ 1 possible extra byte) and a 2 byte RSTm marker.
+        constexpr size_t restart_marker_overhead{4};
+        return ((line_count / restart_interval_) + 1) * restart_marker_overhead;
     }
 
     [[nodiscard]]
@@ -332,7 +944,8 @@ struct charls_jpegls_encoder final
 
     void check_state_can_write() const
     {
-        check_operation(state_ >= state::destination_set && state_ < state::completed);
+        // Segments cannot be written while a scan is encoded line by line.
+        check_operation(state_ >= state::destination_set && state_ < state::completed && !scan_encoder_);
     }
 
     void check_interleave_mode_against_component_count() const
@@ -417,6 +1030,16 @@ struct charls_jpegls_encoder final
         }
     }
 
+    void write_define_restart_interval_segment()
+    {
+        // A DRI segment remains active for all succeeding scans: only write it when the restart interval changes.
+        if (restart_interval_ == written_restart_interval_)
+            return;
+
+        writer_.write_define_restart_interval_segment(restart_interval_);
+        written_restart_interval_ = restart_interval_;
+    }
+
     void write_end_of_image()
     {
         writer_.write_end_of_image(has_option(encoding_options::even_destination_size));
@@ -429,32 +1052,62 @@ struct charls_jpegls_encoder final
         return ::has_option(encoding_options_, option_to_test);
     }
 
+    charls::memory_resource memory_resource_;
     charls_frame_info frame_info_{};
     int32_t near_lossless_{};
     int32_t encoded_component_count_{};
+    uint32_t restart_interval_{};
+    uint32_t written_restart_interval_{};
+    uint32_t thread_count_{1};
     charls::interleave_mode interleave_mode_{};
     charls::color_transformation color_transformation_{};
     charls::encoding_options encoding_options_{};
     state state_{};
-    jpeg_stream_writer writer_;
+    jpeg_stream_writer writer_{memory_resource_};
     jpegls_pc_parameters user_preset_coding_parameters_{};
     jpegls_pc_parameters preset_coding_parameters_{};
+
+    scan_codec_cache<scan_encoder> scan_encoder_cache_{memory_resource_};
+
+    // The encoder of the current scan, the number of its bytes the writer has advanced over and the encoded lines.
+    scan_encoder* scan_encoder_{};
+    size_t scan_byte_count_{};
+    uint32_t scan_line_{};
 };
 
 extern "C" {
 
 USE_DECL_ANNOTATIONS charls_jpegls_encoder* CHARLS_API_CALLING_CONVENTION charls_jpegls_encoder_create() noexcept
 {
-    MSVC_WARNING_SUPPRESS_NEXT_LINE(26402 26409)     // don't use new and delete + scoped object and move
-    return new (std::nothrow) charls_jpegls_encoder; // NOLINT(cppcoreguidelines-owning-memory)
+    const auto& resource{default_memory_resource()};
+    return charls_jpegls_encoder_create_with_allocator(resource.allocate, resource.deallocate, resource.user_context);
+}
+
+
+USE_DECL_ANNOTATIONS charls_jpegls_encoder* CHARLS_API_CALLING_CONVENTION charls_jpegls_encoder_create_with_allocator(
+    const charls_allocate_handler allocate, const charls_deallocate_handler deallocate, void* user_context) noexcept
+{
+    if (!allocate || !deallocate)
+        return nullptr;
+
+    void* memory{allocate(sizeof(charls_jpegls_encoder), alignof(charls_jpegls_encoder), user_context)};
+    if (!memory)
+        return nullptr;
+
+    return new (memory) charls_jpegls_encoder({allocate, deallocate, user_context});
 }
 
 
 USE_DECL_ANNOTATIONS void CHARLS_API_CALLING_CONVENTION
 charls_jpegls_encoder_destroy(const charls_jpegls_encoder* encoder) noexcept
 {
-    MSVC_WARNING_SUPPRESS_NEXT_LINE(26401 26409) // don't use new and delete + non-owner.
-    delete encoder;                              // NOLINT(cppcoreguidelines-owning-memory)
+    if (!encoder)
+        return;
+
+    // The encoder owns the memory resource: copy it before the encoder is destroyed.
+    const charls::memory_resource resource{encoder->memory()};
+    encoder->~charls_jpegls_encoder();
+    resource.deallocate_bytes(const_cast<charls_jpegls_encoder*>(encoder), sizeof(charls_jpegls_encoder));
 }
 
 
@@ -471,6 +1124,19 @@ catch (...)
 }
 
 
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_encoder_set_destination_handler(
+    charls_jpegls_encoder* encoder, const charls_at_encoded_data_handler handler, void* user_context) noexcept
+try
+{
+    check_pointer(encoder)->destination(callback_function<at_encoded_data_handler>{handler, user_context});
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
 USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
 charls_jpegls_encoder_set_frame_info(charls_jpegls_encoder* encoder, const charls_frame_info* frame_info) noexcept
 try
@@ -549,6 +1215,32 @@ catch (...)
 }
 
 
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_set_restart_interval(charls_jpegls_encoder* encoder, const uint32_t restart_interval) noexcept
+try
+{
+    check_pointer(encoder)->restart_interval(restart_interval);
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_set_thread_count(charls_jpegls_encoder* encoder, const uint32_t thread_count) noexcept
+try
+{
+    check_pointer(encoder)->thread_count(thread_count);
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
 USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_encoder_set_mapping_table_id(
     charls_jpegls_encoder* encoder, const int32_t component_index, const int32_t table_id) noexcept
 try
@@ -575,6 +1267,20 @@ catch (...)
 }
 
 
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_encoder_get_estimated_tiles_destination_size(
+    const charls_jpegls_encoder* encoder, const uint32_t tile_width, const uint32_t tile_height,
+    size_t* size_in_bytes) noexcept
+try
+{
+    *check_pointer(size_in_bytes) = check_pointer(encoder)->estimated_tiles_destination_size(tile_width, tile_height);
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
 USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
 charls_jpegls_encoder_write_spiff_header(charls_jpegls_encoder* encoder, const charls_spiff_header* spiff_header) noexcept
 try
@@ -703,6 +1409,48 @@ catch (...)
 }
 
 
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_encoder_encode_lines_from_buffer(
+    charls_jpegls_encoder* encoder, const void* source_buffer, const size_t source_size_bytes, const uint32_t line_count,
+    const uint32_t stride) noexcept
+try
+{
+    check_pointer(encoder)->encode_lines({static_cast<const byte*>(source_buffer), source_size_bytes}, line_count, stride);
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_encoder_encode_tiles_from_buffer(
+    charls_jpegls_encoder* encoder, const void* source_buffer, const size_t source_size_bytes, const uint32_t stride,
+    const uint32_t tile_width, const uint32_t tile_height, charls_tile_info* tiles, const size_t tile_count) noexcept
+try
+{
+    check_pointer(encoder)->encode_tiles({static_cast<const byte*>(source_buffer), source_size_bytes}, stride, tile_width,
+                                         tile_height, {tiles, tile_count});
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_encoder_encode_batch(
+    const charls_jpegls_encoder* encoder, charls_batch_item* items, const size_t item_count) noexcept
+try
+{
+    check_pointer(encoder)->encode_batch({items, item_count});
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
 USE_DECL_ANNOTATIONS charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
 charls_jpegls_encoder_create_abbreviated_format(charls_jpegls_encoder* encoder) noexcept
 try
@@ -44,6 +44,12 @@ inline constexpr uint8_t spiff_end_of_directory_entry_type{1};
 // The size of a SPIFF header when serialized to a JPEG byte stream.
 inline constexpr size_t spiff_header_size_in_bytes{34};
 
+// The size of a start of scan (SOS) segment for a scan with 1 component when serialized to a JPEG byte stream.
+inline constexpr size_t single_component_start_of_scan_segment_size{10};
+
+// The size of a restart (RSTm) marker when serialized to a JPEG byte stream.
+inline constexpr size_t restart_marker_size{2};
+
 // The maximum size of the data bytes that fit in a spiff entry.
 inline constexpr size_t spiff_entry_max_data_size{65528};
 
@@ -56,6 +62,10 @@ inline constexpr size_t segment_length_size{sizeof(uint16_t)};
 // The maximum size of the data bytes that fit in a segment.
 inline constexpr size_t segment_max_data_size{std::numeric_limits<uint16_t>::max() - segment_length_size};
 
+// The initial size of the buffer that is used when the encoded bytes are passed to a handler.
+// The buffer is enlarged when a segment or an encoded line doesn't fit.
+inline constexpr size_t encoded_data_buffer_size{size_t{64} * 1024};
+
 // Number of bits in an int32_t data type.
 inline constexpr size_t int32_t_bit_count{sizeof(int32_t) * 8};
 
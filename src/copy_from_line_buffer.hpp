@@ -16,6 +16,13 @@ namespace charls {
 
 using copy_from_line_buffer_fn = void (*)(const void* source, void* destination, size_t pixel_count) noexcept;
 
+/// <summary>
+/// Returns a SIMD implementation for 8-bit samples that is supported by the CPU, or nullptr when none is available.
+/// </summary>
+[[nodiscard]]
+copy_from_line_buffer_fn get_simd_copy_from_line_buffer_function(interleave_mode interleave_mode, int32_t component_count,
+                                                                  color_transformation color_transformation) noexcept;
+
 template<typename SampleType>
 class copy_from_line_buffer final
 {
@@ -24,6 +31,13 @@ public:
     static copy_from_line_buffer_fn get_copy_function(const interleave_mode interleave_mode, const int32_t component_count,
                                                       const color_transformation color_transformation) noexcept
     {
+        if constexpr (std::is_same_v<sample_type, uint8_t>)
+        {
+            if (const auto simd_function{
+                    get_simd_copy_from_line_buffer_function(interleave_mode, component_count, color_transformation)})
+                return simd_function;
+        }
+
         switch (interleave_mode)
         {
         case interleave_mode::none:
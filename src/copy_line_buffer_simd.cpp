@@ -0,0 +1,571 @@
+// SPDX-FileCopyrightText: © 2026 Team CharLS
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "pch.hpp"
+
+#include "copy_from_line_buffer.hpp"
+#include "copy_to_line_buffer.hpp"
+#include "cpu_features.hpp"
+
+// SIMD implementations of the line buffer conversions of 8-bit images with 3 components (RGB). These conversions
+// (de)interleave the components and apply the HP1, HP2 and HP3 color transforms.
+// All color transforms are defined modulo 256, which makes it possible to compute them with 8-bit lanes:
+// the output is identical to the scalar implementations.
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define CHARLS_SIMD_SSE41
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define CHARLS_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace charls {
+
+#if defined(CHARLS_SIMD_SSE41) || defined(CHARLS_SIMD_NEON)
+
+namespace {
+
+#ifdef CHARLS_SIMD_SSE41
+
+// SSE4.1 is not part of the x86-64 baseline: the kernels are compiled for it and only selected when the CPU supports it.
+#ifdef __GNUC__
+#define SIMD_TARGET __attribute__((target("sse4.1")))
+#else
+#define SIMD_TARGET
+#endif
+
+using simd_vector = __m128i;
+
+[[nodiscard]]
+bool simd_supported() noexcept
+{
+    return cpu_supports_sse41();
+}
+
+using shuffle_mask = std::array<int8_t, 16>;
+using shuffle_masks = std::array<std::array<shuffle_mask, 3>, 3>;
+
+/// <summary>
+/// Computes the pshufb masks that gather component c of 16 RGB pixels from the 16 byte block b (of 3 blocks).
+/// </summary>
+constexpr shuffle_masks make_deinterleave_masks() noexcept
+{
+    shuffle_masks masks{};
+    for (int component{}; component != 3; ++component)
+    {
+        for (int block{}; block != 3; ++block)
+        {
+            for (int i{}; i != 16; ++i)
+            {
+                const int index{(3 * i) + component};
+                masks[component][block][i] = static_cast<int8_t>(index / 16 == block ? index % 16 : -128);
+            }
+        }
+    }
+
+    return masks;
+}
+
+/// <summary>
+/// Computes the pshufb masks that scatter component c of 16 RGB pixels into the 16 byte block b (of 3 blocks).
+/// </summary>
+constexpr shuffle_masks make_interleave_masks() noexcept
+{
+    shuffle_masks masks{};
+    for (int component{}; component != 3; ++component)
+    {
+        for (int block{}; block != 3; ++block)
+        {
+            for (int i{}; i != 16; ++i)
+            {
+                const int position{(16 * block) + i};
+                masks[component][block][i] = static_cast<int8_t>(position % 3 == component ? position / 3 : -128);
+            }
+        }
+    }
+
+    return masks;
+}
+
+constexpr shuffle_masks deinterleave_masks{make_deinterleave_masks()};
+constexpr shuffle_masks interleave_masks{make_interleave_masks()};
+
+SIMD_TARGET FORCE_INLINE inline simd_vector load(const uint8_t* source) noexcept
+{
+    return _mm_loadu_si128(static_cast<const __m128i*>(static_cast<const void*>(source)));
+}
+
+SIMD_TARGET FORCE_INLINE inline void store(uint8_t* destination, const simd_vector value) noexcept
+{
+    _mm_storeu_si128(static_cast<__m128i*>(static_cast<void*>(destination)), value);
+}
+
+SIMD_TARGET FORCE_INLINE inline simd_vector load(const shuffle_mask& mask) noexcept
+{
+    return _mm_loadu_si128(static_cast<const __m128i*>(static_cast<const void*>(mask.data())));
+}
+
+SIMD_TARGET FORCE_INLINE inline simd_vector shuffle_blocks(const simd_vector block0, const simd_vector block1,
+                                                           const simd_vector block2,
+                                                           const std::array<shuffle_mask, 3>& masks) noexcept
+{
+    return _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(block0, load(masks[0])), _mm_shuffle_epi8(block1, load(masks[1]))),
+                        _mm_shuffle_epi8(block2, load(masks[2])));
+}
+
+SIMD_TARGET FORCE_INLINE inline simd_vector broadcast(const uint8_t value) noexcept
+{
+    return _mm_set1_epi8(static_cast<char>(value));
+}
+
+SIMD_TARGET FORCE_INLINE inline simd_vector add(const simd_vector a, const simd_vector b) noexcept
+{
+    return _mm_add_epi8(a, b);
+}
+
+SIMD_TARGET FORCE_INLINE inline simd_vector subtract(const simd_vector a, const simd_vector b) noexcept
+{
+    return _mm_sub_epi8(a, b);
+}
+
+SIMD_TARGET FORCE_INLINE inline simd_vector bitwise_and(const simd_vector a, const simd_vector b) noexcept
+{
+    return _mm_and_si128(a, b);
+}
+
+/// <summary>Adds 128 modulo 256, which is equal to flipping the most significant bit.</summary>
+SIMD_TARGET FORCE_INLINE inline simd_vector add_bias(const simd_vector a) noexcept
+{
+    return _mm_xor_si128(a, broadcast(0x80));
+}
+
+/// <summary>Computes (a + b) / 2 without overflow; pavgb rounds up, which is corrected with the lowest bit.</summary>
+SIMD_TARGET FORCE_INLINE inline simd_vector floor_average(const simd_vector a, const simd_vector b) noexcept
+{
+    return _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), broadcast(1)));
+}
+
+SIMD_TARGET FORCE_INLINE inline simd_vector shift_right_1(const simd_vector a) noexcept
+{
+    return _mm_and_si128(_mm_srli_epi16(a, 1), broadcast(0x7F));
+}
+
+#else
+
+#define SIMD_TARGET
+
+using simd_vector = uint8x16_t;
+
+[[nodiscard]]
+constexpr bool simd_supported() noexcept
+{
+    return true; // NEON is part of the ARMv8 baseline.
+}
+
+FORCE_INLINE inline simd_vector load(const uint8_t* source) noexcept
+{
+    return vld1q_u8(source);
+}
+
+FORCE_INLINE inline void store(uint8_t* destination, const simd_vector value) noexcept
+{
+    vst1q_u8(destination, value);
+}
+
+FORCE_INLINE inline simd_vector broadcast(const uint8_t value) noexcept
+{
+    return vdupq_n_u8(value);
+}
+
+FORCE_INLINE inline simd_vector add(const simd_vector a, const simd_vector b) noexcept
+{
+    return vaddq_u8(a, b);
+}
+
+FORCE_INLINE inline simd_vector subtract(const simd_vector a, const simd_vector b) noexcept
+{
+    return vsubq_u8(a, b);
+}
+
+FORCE_INLINE inline simd_vector bitwise_and(const simd_vector a, const simd_vector b) noexcept
+{
+    return vandq_u8(a, b);
+}
+
+FORCE_INLINE inline simd_vector add_bias(const simd_vector a) noexcept
+{
+    return veorq_u8(a, broadcast(0x80));
+}
+
+FORCE_INLINE inline simd_vector floor_average(const simd_vector a, const simd_vector b) noexcept
+{
+    return vhaddq_u8(a, b);
+}
+
+FORCE_INLINE inline simd_vector shift_right_1(const simd_vector a) noexcept
+{
+    return vshrq_n_u8(a, 1);
+}
+
+#endif
+
+
+constexpr size_t simd_pixel_count{16};
+
+struct vector3 final
+{
+    simd_vector v1;
+    simd_vector v2;
+    simd_vector v3;
+};
+
+SIMD_TARGET FORCE_INLINE inline vector3 load_pixels(const uint8_t* source) noexcept
+{
+#ifdef CHARLS_SIMD_SSE41
+    const simd_vector block0{load(source)};
+    const simd_vector block1{load(source + 16)};
+    const simd_vector block2{load(source + 32)};
+    return {shuffle_blocks(block0, block1, block2, deinterleave_masks[0]),
+            shuffle_blocks(block0, block1, block2, deinterleave_masks[1]),
+            shuffle_blocks(block0, block1, block2, deinterleave_masks[2])};
+#else
+    const uint8x16x3_t pixels{vld3q_u8(source)};
+    return {pixels.val[0], pixels.val[1], pixels.val[2]};
+#endif
+}
+
+SIMD_TARGET FORCE_INLINE inline void store_pixels(uint8_t* destination, const vector3 pixels) noexcept
+{
+#ifdef CHARLS_SIMD_SSE41
+    for (size_t block{}; block != 3; ++block)
+    {
+        store(destination + (block * 16),
+              _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(pixels.v1, load(interleave_masks[0][block])),
+                                        _mm_shuffle_epi8(pixels.v2, load(interleave_masks[1][block]))),
+                           _mm_shuffle_epi8(pixels.v3, load(interleave_masks[2][block]))));
+    }
+#else
+    vst3q_u8(destination, {{pixels.v1, pixels.v2, pixels.v3}});
+#endif
+}
+
+
+struct simd_transform_none final
+{
+    SIMD_TARGET FORCE_INLINE static vector3 forward(const vector3 pixels) noexcept
+    {
+        return pixels;
+    }
+
+    SIMD_TARGET FORCE_INLINE static vector3 inverse(const vector3 pixels) noexcept
+    {
+        return pixels;
+    }
+
+    FORCE_INLINE static triplet<uint8_t> forward(const int32_t red, const int32_t green, const int32_t blue) noexcept
+    {
+        return {static_cast<uint8_t>(red), static_cast<uint8_t>(green), static_cast<uint8_t>(blue)};
+    }
+
+    FORCE_INLINE static triplet<uint8_t> inverse(const int32_t v1, const int32_t v2, const int32_t v3) noexcept
+    {
+        return {static_cast<uint8_t>(v1), static_cast<uint8_t>(v2), static_cast<uint8_t>(v3)};
+    }
+};
+
+struct simd_transform_hp1 final
+{
+    SIMD_TARGET FORCE_INLINE static vector3 forward(const vector3 rgb) noexcept
+    {
+        return {add_bias(subtract(rgb.v1, rgb.v2)), rgb.v2, add_bias(subtract(rgb.v3, rgb.v2))};
+    }
+
+    SIMD_TARGET FORCE_INLINE static vector3 inverse(const vector3 v) noexcept
+    {
+        return {add_bias(add(v.v1, v.v2)), v.v2, add_bias(add(v.v3, v.v2))};
+    }
+
+    FORCE_INLINE static triplet<uint8_t> forward(const int32_t red, const int32_t green, const int32_t blue) noexcept
+    {
+        return transform_hp1<uint8_t>{}(red, green, blue);
+    }
+
+    FORCE_INLINE static triplet<uint8_t> inverse(const int32_t v1, const int32_t v2, const int32_t v3) noexcept
+    {
+        return transform_hp1<uint8_t>::inverse{}(v1, v2, v3);
+    }
+};
+
+struct simd_transform_hp2 final
+{
+    SIMD_TARGET FORCE_INLINE static vector3 forward(const vector3 rgb) noexcept
+    {
+        return {add_bias(subtract(rgb.v1, rgb.v2)), rgb.v2,
+                add_bias(subtract(rgb.v3, floor_average(rgb.v1, rgb.v2)))};
+    }
+
+    SIMD_TARGET FORCE_INLINE static vector3 inverse(const vector3 v) noexcept
+    {
+        const simd_vector red{add_bias(add(v.v1, v.v2))};
+        return {red, v.v2, add_bias(add(v.v3, floor_average(red, v.v2)))};
+    }
+
+    FORCE_INLINE static triplet<uint8_t> forward(const int32_t red, const int32_t green, const int32_t blue) noexcept
+    {
+        return transform_hp2<uint8_t>{}(red, green, blue);
+    }
+
+    FORCE_INLINE static triplet<uint8_t> inverse(const int32_t v1, const int32_t v2, const int32_t v3) noexcept
+    {
+        return transform_hp2<uint8_t>::inverse{}(v1, v2, v3);
+    }
+};
+
+struct simd_transform_hp3 final
+{
+    SIMD_TARGET FORCE_INLINE static vector3 forward(const vector3 rgb) noexcept
+    {
+        const simd_vector v2{add_bias(subtract(rgb.v3, rgb.v2))};
+        const simd_vector v3{add_bias(subtract(rgb.v1, rgb.v2))};
+
+        // (v2 + v3) >> 2 is computed as ((v2 + v3) >> 1) >> 1 to stay within 8 bits.
+        return {subtract(add(rgb.v2, shift_right_1(floor_average(v2, v3))), broadcast(64)), v2, v3};
+    }
+
+    SIMD_TARGET FORCE_INLINE static vector3 inverse(const vector3 v) noexcept
+    {
+        const simd_vector green{add(subtract(v.v1, shift_right_1(floor_average(v.v3, v.v2))), broadcast(64))};
+        return {add_bias(add(v.v3, green)), green, add_bias(add(v.v2, green))};
+    }
+
+    FORCE_INLINE static triplet<uint8_t> forward(const int32_t red, const int32_t green, const int32_t blue) noexcept
+    {
+        return transform_hp3<uint8_t>{}(red, green, blue);
+    }
+
+    FORCE_INLINE static triplet<uint8_t> inverse(const int32_t v1, const int32_t v2, const int32_t v3) noexcept
+    {
+        return transform_hp3<uint8_t>::inverse{}(v1, v2, v3);
+    }
+};
+
+
+// Encoding: sample interleaved source => line interleaved line buffer (3 planes with a pixel stride).
+template<typename Transform>
+SIMD_TARGET void copy_line_3_components_to_line_buffer(const void* source, void* destination, const size_t pixel_count,
+                                                        const uint32_t mask) noexcept
+{
+    const auto* s{static_cast<const uint8_t*>(source)};
+    auto* d{static_cast<uint8_t*>(destination)};
+    const size_t pixel_stride{pixel_count_to_pixel_stride(pixel_count)};
+    const auto m{static_cast<uint8_t>(mask)};
+    const simd_vector mask_vector{broadcast(m)};
+
+    size_t i{};
+    for (; i + simd_pixel_count <= pixel_count; i += simd_pixel_count)
+    {
+        vector3 pixels{load_pixels(s + (i * 3))};
+        if constexpr (std::is_same_v<Transform, simd_transform_none>)
+        {
+            pixels = {bitwise_and(pixels.v1, mask_vector), bitwise_and(pixels.v2, mask_vector),
+                      bitwise_and(pixels.v3, mask_vector)};
+        }
+
+        const vector3 transformed{Transform::forward(pixels)};
+        store(d + i, transformed.v1);
+        store(d + i + pixel_stride, transformed.v2);
+        store(d + i + (2 * pixel_stride), transformed.v3);
+    }
+
+    for (; i != pixel_count; ++i)
+    {
+        const uint8_t* pixel{s + (i * 3)};
+        const auto transformed{std::is_same_v<Transform, simd_transform_none>
+                                   ? Transform::forward(pixel[0] & m, pixel[1] & m, pixel[2] & m)
+                                   : Transform::forward(pixel[0], pixel[1], pixel[2])};
+        d[i] = transformed.v1;
+        d[i + pixel_stride] = transformed.v2;
+        d[i + (2 * pixel_stride)] = transformed.v3;
+    }
+}
+
+// Encoding: sample interleaved source => sample interleaved line buffer.
+template<typename Transform>
+SIMD_TARGET void copy_pixels_3_components_to_line_buffer(const void* source, void* destination, const size_t pixel_count,
+                                                          uint32_t /*mask*/) noexcept
+{
+    const auto* s{static_cast<const uint8_t*>(source)};
+    auto* d{static_cast<uint8_t*>(destination)};
+
+    size_t i{};
+    for (; i + simd_pixel_count <= pixel_count; i += simd_pixel_count)
+    {
+        store_pixels(d + (i * 3), Transform::forward(load_pixels(s + (i * 3))));
+    }
+
+    for (; i != pixel_count; ++i)
+    {
+        const auto transformed{Transform::forward(s[i * 3], s[(i * 3) + 1], s[(i * 3) + 2])};
+        d[i * 3] = transformed.v1;
+        d[(i * 3) + 1] = transformed.v2;
+        d[(i * 3) + 2] = transformed.v3;
+    }
+}
+
+// Decoding: line interleaved line buffer (3 planes with a pixel stride) => sample interleaved destination.
+template<typename Transform>
+SIMD_TARGET void copy_line_3_components_from_line_buffer(const void* source, void* destination,
+                                                          const size_t pixel_count) noexcept
+{
+    const auto* s{static_cast<const uint8_t*>(source)};
+    auto* d{static_cast<uint8_t*>(destination)};
+    const size_t pixel_stride{pixel_count_to_pixel_stride(pixel_count)};
+
+    size_t i{};
+    for (; i + simd_pixel_count <= pixel_count; i += simd_pixel_count)
+    {
+        store_pixels(d + (i * 3),
+                     Transform::inverse({load(s + i), load(s + i + pixel_stride), load(s + i + (2 * pixel_stride))}));
+    }
+
+    for (; i != pixel_count; ++i)
+    {
+        const auto pixel{Transform::inverse(s[i], s[i + pixel_stride], s[i + (2 * pixel_stride)])};
+        d[i * 3] = pixel.v1;
+        d[(i * 3) + 1] = pixel.v2;
+        d[(i * 3) + 2] = pixel.v3;
+    }
+}
+
+// Decoding: sample interleaved line buffer => sample interleaved destination.
+template<typename Transform>
+SIMD_TARGET void copy_pixels_3_components_from_line_buffer(const void* source, void* destination,
+                                                            const size_t pixel_count) noexcept
+{
+    const auto* s{static_cast<const uint8_t*>(source)};
+    auto* d{static_cast<uint8_t*>(destination)};
+
+    size_t i{};
+    for (; i + simd_pixel_count <= pixel_count; i += simd_pixel_count)
+    {
+        store_pixels(d + (i * 3), Transform::inverse(load_pixels(s + (i * 3))));
+    }
+
+    for (; i != pixel_count; ++i)
+    {
+        const auto pixel{Transform::inverse(s[i * 3], s[(i * 3) + 1], s[(i * 3) + 2])};
+        d[i * 3] = pixel.v1;
+        d[(i * 3) + 1] = pixel.v2;
+        d[(i * 3) + 2] = pixel.v3;
+    }
+}
+
+#undef SIMD_TARGET
+
+} // namespace
+
+
+copy_to_line_buffer_fn get_simd_copy_to_line_buffer_function(const interleave_mode interleave_mode,
+                                                              const int32_t component_count,
+                                                              const color_transformation color_transformation) noexcept
+{
+    static const bool supported{simd_supported()};
+    if (!supported || component_count != 3)
+        return nullptr;
+
+    if (interleave_mode == interleave_mode::line)
+    {
+        switch (color_transformation)
+        {
+        case color_transformation::none:
+            return &copy_line_3_components_to_line_buffer<simd_transform_none>;
+        case color_transformation::hp1:
+            return &copy_line_3_components_to_line_buffer<simd_transform_hp1>;
+        case color_transformation::hp2:
+            return &copy_line_3_components_to_line_buffer<simd_transform_hp2>;
+        case color_transformation::hp3:
+            return &copy_line_3_components_to_line_buffer<simd_transform_hp3>;
+        }
+    }
+
+    if (interleave_mode == interleave_mode::sample)
+    {
+        switch (color_transformation)
+        {
+        case color_transformation::none:
+            break; // The scalar masked copy is already vectorized by the compiler.
+        case color_transformation::hp1:
+            return &copy_pixels_3_components_to_line_buffer<simd_transform_hp1>;
+        case color_transformation::hp2:
+            return &copy_pixels_3_components_to_line_buffer<simd_transform_hp2>;
+        case color_transformation::hp3:
+            return &copy_pixels_3_components_to_line_buffer<simd_transform_hp3>;
+        }
+    }
+
+    return nullptr;
+}
+
+
+copy_from_line_buffer_fn get_simd_copy_from_line_buffer_function(const interleave_mode interleave_mode,
+                                                                  const int32_t component_count,
+                                                                  const color_transformation color_transformation) noexcept
+{
+    static const bool supported{simd_supported()};
+    if (!supported || component_count != 3)
+        return nullptr;
+
+    if (interleave_mode == interleave_mode::line)
+    {
+        switch (color_transformation)
+        {
+        case color_transformation::none:
+            return &copy_line_3_components_from_line_buffer<simd_transform_none>;
+        case color_transformation::hp1:
+            return &copy_line_3_components_from_line_buffer<simd_transform_hp1>;
+        case color_transformation::hp2:
+            return &copy_line_3_components_from_line_buffer<simd_transform_hp2>;
+        case color_transformation::hp3:
+            return &copy_line_3_components_from_line_buffer<simd_transform_hp3>;
+        }
+    }
+
+    if (interleave_mode == interleave_mode::sample)
+    {
+        switch (color_transformation)
+        {
+        case color_transformation::none:
+            break; // A plain memcpy.
+        case color_transformation::hp1:
+            return &copy_pixels_3_components_from_line_buffer<simd_transform_hp1>;
+        case color_transformation::hp2:
+            return &copy_pixels_3_components_from_line_buffer<simd_transform_hp2>;
+        case color_transformation::hp3:
+            return &copy_pixels_3_components_from_line_buffer<simd_transform_hp3>;
+        }
+    }
+
+    return nullptr;
+}
+
+#else
+
+copy_to_line_buffer_fn get_simd_copy_to_line_buffer_function(interleave_mode /*interleave_mode*/,
+                                                              int32_t /*component_count*/,
+                                                              color_transformation /*color_transformation*/) noexcept
+{
+    return nullptr;
+}
+
+
+copy_from_line_buffer_fn get_simd_copy_from_line_buffer_function(interleave_mode /*interleave_mode*/,
+                                                                  int32_t /*component_count*/,
+                                                                  color_transformation /*color_transformation*/) noexcept
+{
+    return nullptr;
+}
+
+#endif
+
+} // namespace charls
@@ -18,6 +18,13 @@ namespace charls {
 
 using copy_to_line_buffer_fn = void (*)(const void* source, void* destination, size_t pixel_count, uint32_t mask) noexcept;
 
+/// <summary>
+/// Returns a SIMD implementation for 8-bit samples that is supported by the CPU, or nullptr when none is available.
+/// </summary>
+[[nodiscard]]
+copy_to_line_buffer_fn get_simd_copy_to_line_buffer_function(interleave_mode interleave_mode, int32_t component_count,
+                                                              color_transformation color_transformation) noexcept;
+
 template<typename SampleType>
 class copy_to_line_buffer final
 {
@@ -27,6 +34,13 @@ public:
                                                     const int32_t bits_per_sample,
                                                     const color_transformation color_transformation) noexcept
     {
+        if constexpr (std::is_same_v<sample_type, uint8_t>)
+        {
+            if (const auto simd_function{
+                    get_simd_copy_to_line_buffer_function(interleave_mode, component_count, color_transformation)})
+                return simd_function;
+        }
+
         switch (interleave_mode)
         {
         case interleave_mode::none: {
@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: © 2026 Team CharLS
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "pch.hpp"
+
+#include "cpu_features.hpp"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define CHARLS_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace charls {
+
+namespace {
+
+#ifdef CHARLS_X86
+
+struct cpuid_registers final
+{
+    uint32_t eax;
+    uint32_t ebx;
+    uint32_t ecx;
+    uint32_t edx;
+};
+
+struct x86_features final
+{
+    bool sse41;
+    bool x86_64_v3;
+};
+
+[[nodiscard]]
+cpuid_registers cpuid(const uint32_t leaf) noexcept
+{
+#ifdef _MSC_VER
+    std::array<int, 4> registers{};
+    __cpuidex(registers.data(), static_cast<int>(leaf), 0);
+    return {static_cast<uint32_t>(registers[0]), static_cast<uint32_t>(registers[1]),
+            static_cast<uint32_t>(registers[2]), static_cast<uint32_t>(registers[3])};
+#else
+    cpuid_registers registers{};
+    __cpuid_count(leaf, 0, registers.eax, registers.ebx, registers.ecx, registers.edx);
+    return registers;
+#endif
+}
+
+/// <summary>
+/// Reads the XCR0 register, which reports which register states the operating system saves on a context switch.
+/// </summary>
+[[nodiscard]]
+uint64_t read_extended_control_register() noexcept
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    uint32_t low;
+    uint32_t high;
+    __asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return (uint64_t{high} << 32) | low;
+#endif
+}
+
+[[nodiscard]]
+constexpr bool is_bit_set(const uint32_t value, const int index) noexcept
+{
+    return ((value >> index) & 1U) != 0;
+}
+
+[[nodiscard]]
+x86_features detect_x86_features() noexcept
+{
+    const uint32_t maximum_leaf{cpuid(0).eax};
+    if (maximum_leaf < 1)
+        return {};
+
+    const cpuid_registers leaf1{cpuid(1)};
+    x86_features features{is_bit_set(leaf1.ecx, 19), false};
+    if (maximum_leaf < 7 || cpuid(0x80000000).eax < 0x80000001)
+        return features;
+
+    // AVX requires that the OS saves the XMM and YMM registers (XCR0 bits 1 and 2), which OSXSAVE makes readable.
+    constexpr uint64_t xmm_ymm_state{0b110};
+    const bool avx_enabled{is_bit_set(leaf1.ecx, 27) && is_bit_set(leaf1.ecx, 28) &&
+                           (read_extended_control_register() & xmm_ymm_state) == xmm_ymm_state};
+
+    const cpuid_registers leaf7{cpuid(7)};
+    const cpuid_registers extended_leaf1{cpuid(0x80000001)};
+    features.x86_64_v3 = avx_enabled && is_bit_set(leaf1.ecx, 12) /* FMA */ && is_bit_set(leaf1.ecx, 22) /* MOVBE */ &&
+                         is_bit_set(leaf1.ecx, 29) /* F16C */ && is_bit_set(leaf7.ebx, 3) /* BMI1 */ &&
+                         is_bit_set(leaf7.ebx, 5) /* AVX2 */ && is_bit_set(leaf7.ebx, 8) /* BMI2 */ &&
+                         is_bit_set(extended_leaf1.ecx, 5) /* LZCNT */;
+    return features;
+}
+
+[[nodiscard]]
+const x86_features& x86_cpu_features() noexcept
+{
+    static const x86_features features{detect_x86_features()};
+    return features;
+}
+
+#endif
+
+} // namespace
+
+
+bool cpu_supports_sse41() noexcept
+{
+#ifdef CHARLS_X86
+    return x86_cpu_features().sse41;
+#else
+    return false;
+#endif
+}
+
+
+instruction_set supported_instruction_set() noexcept
+{
+#ifdef CHARLS_X86
+    if (x86_cpu_features().x86_64_v3)
+        return instruction_set::x86_64_v3;
+#endif
+
+    return instruction_set::baseline;
+}
+
+} // namespace charls
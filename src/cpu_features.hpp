@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: © 2026 Team CharLS
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+namespace charls {
+
+/// <summary>
+/// The instruction set levels for which code paths are compiled. The best level supported by the CPU is selected at
+/// runtime, which makes it possible to ship a single binary that still uses the newer instructions when available.
+/// </summary>
+enum class instruction_set
+{
+    /// <summary>
+    /// The instruction set of the compilation target.
+    /// </summary>
+    baseline,
+
+    /// <summary>
+    /// x86-64-v3 (Haswell and newer): AVX2, BMI1, BMI2, LZCNT, MOVBE, FMA and F16C.
+    /// </summary>
+    x86_64_v3
+};
+
+/// <summary>
+/// Returns true when the CPU supports the SSE4.1 instructions.
+/// </summary>
+[[nodiscard]]
+bool cpu_supports_sse41() noexcept;
+
+/// <summary>
+/// Returns the best instruction set level that is supported by the CPU and the operating system.
+/// </summary>
+[[nodiscard]]
+instruction_set supported_instruction_set() noexcept;
+
+} // namespace charls
@@ -48,6 +48,9 @@ struct default_traits final
 
     uint32_t quantization_range;
 
+    // Replaces the division by 2 * NEAR + 1 of the error value quantization with a multiply and a shift.
+    uint64_t quantization_reciprocal;
+
     default_traits(const int32_t arg_maximum_sample_value, const int32_t arg_near_lossless) noexcept :
         maximum_sample_value{arg_maximum_sample_value},
         near_lossless{arg_near_lossless},
@@ -55,7 +58,8 @@ struct default_traits final
         quantized_bits_per_sample{log2_ceiling(range)},
         bits_per_sample{log2_ceiling(maximum_sample_value)},
         limit{compute_limit_parameter(bits_per_sample)},
-        quantization_range{1U << bits_per_sample}
+        quantization_range{1U << bits_per_sample},
+        quantization_reciprocal{compute_reciprocal_multiplier(2 * near_lossless + 1)}
     {
         ASSERT(sizeof(SampleType) * 8 >= static_cast<size_t>(bits_per_sample));
     }
@@ -154,12 +158,13 @@ struct default_traits final
 
 private:
     [[nodiscard]]
-    int32_t quantize(const int32_t error_value) const noexcept
+    FORCE_INLINE int32_t quantize(const int32_t error_value) const noexcept
     {
+        // The dividends are at most MAXVAL + 2 * NEAR, which is far below the 2^32 / (2 * NEAR + 1) bound.
         if (error_value > 0)
-            return (error_value + near_lossless) / (2 * near_lossless + 1);
+            return divide_by_reciprocal(error_value + near_lossless, quantization_reciprocal);
 
-        return -(near_lossless - error_value) / (2 * near_lossless + 1);
+        return -divide_by_reciprocal(near_lossless - error_value, quantization_reciprocal);
     }
 
     [[nodiscard]]
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "constants.hpp"
+#include "jpegls_algorithm.hpp"
 #include "util.hpp"
 
 #include <array>
@@ -14,22 +15,51 @@ namespace charls {
 /// Maps a possible golomb code to an error value and a bit-count.
 /// If the bit-count is zero, there was no match and full decoding is required.
 /// </summary>
+/// <remarks>
+/// The 16-bit members keep an entry at 4 bytes: the tables of the few values of k that an image uses stay in the L1 cache.
+/// </remarks>
 struct golomb_code_match final
 {
-    int32_t error_value;
-    int32_t bit_count;
+    int16_t error_value;
+    int16_t bit_count;
 };
 
 
 /// <summary>
-/// Lookup up table with possible golomb code matches.
+/// Lookup up table with possible golomb code matches of at most BitCount bits.
 /// </summary>
+template<size_t BitCount = 8>
 class golomb_code_match_table final
 {
 public:
-    explicit golomb_code_match_table(int32_t k);
+    static_assert(BitCount <= 16, "bit_count of golomb_code_match must be able to store the code length");
 
-    constexpr void add_entry(uint8_t value, golomb_code_match code) noexcept;
+    static constexpr size_t code_bit_count{BitCount};
+
+    explicit constexpr golomb_code_match_table(const int32_t k) noexcept
+    {
+        for (int16_t error_value{};; ++error_value)
+        {
+            // Q is not used when k != 0
+            const int32_t mapped_error_value{map_error_value(error_value)};
+            const auto [code_length, table_value]{create_encoded_value(k, mapped_error_value)};
+            if (static_cast<size_t>(code_length) > code_bit_count)
+                break;
+
+            add_entry(static_cast<size_t>(table_value), {error_value, static_cast<int16_t>(code_length)});
+        }
+
+        for (int16_t error_value{-1};; --error_value)
+        {
+            // Q is not used when k != 0
+            const int32_t mapped_error_value{map_error_value(error_value)};
+            const auto [code_length, table_value]{create_encoded_value(k, mapped_error_value)};
+            if (static_cast<size_t>(code_length) > code_bit_count)
+                break;
+
+            add_entry(static_cast<size_t>(table_value), {error_value, static_cast<int16_t>(code_length)});
+        }
+    }
 
     [[nodiscard]]
     FORCE_INLINE golomb_code_match get(const size_t value) const noexcept
@@ -38,11 +68,42 @@ public:
     }
 
 private:
-    static constexpr size_t byte_bit_count{8};
-    std::array<golomb_code_match, 1 << byte_bit_count> matches_{};
+    [[nodiscard]]
+    static constexpr std::pair<int32_t, int32_t> create_encoded_value(const int32_t k, const int32_t mapped_error) noexcept
+    {
+        const int32_t high_bits{mapped_error >> k};
+        return std::make_pair(high_bits + k + 1, (1 << k) | (mapped_error & ((1 << k) - 1)));
+    }
+
+    constexpr void add_entry(const size_t value, const golomb_code_match code) noexcept
+    {
+        ASSERT(static_cast<size_t>(code.bit_count) <= code_bit_count);
+
+        const size_t unused_bit_count{code_bit_count - static_cast<size_t>(code.bit_count)};
+        for (size_t i{}; i < size_t{1} << unused_bit_count; ++i)
+        {
+            const size_t index{(value << unused_bit_count) + i};
+            ASSERT(matches_[index].bit_count == 0);
+            matches_[index] = code;
+        }
+    }
+
+    std::array<golomb_code_match, size_t{1} << BitCount> matches_{};
 };
 
 
-extern const std::array<golomb_code_match_table, max_k_value> golomb_lut;
+// The table width can be set at build time to 11 or 12 bits. The default of 8 bits keeps the tables of all values
+// of k (16 KiB) in the L1 cache, a 12-bit table needs 16 KiB for each value of k.
+#ifndef CHARLS_GOLOMB_LUT_BIT_COUNT
+#define CHARLS_GOLOMB_LUT_BIT_COUNT 8
+#endif
+
+/// <summary>
+/// The number of bits that are used to lookup a golomb code. Codes that are longer require full decoding.
+/// A wider table resolves more codes with a single lookup, but needs 2^n * 4 bytes for every value of k.
+/// </summary>
+constexpr size_t golomb_lut_bit_count{CHARLS_GOLOMB_LUT_BIT_COUNT};
+
+extern const std::array<golomb_code_match_table<golomb_lut_bit_count>, max_k_value> golomb_lut;
 
 } // namespace charls
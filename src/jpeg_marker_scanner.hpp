@@ -0,0 +1,317 @@
+// SPDX-FileCopyrightText: © 2026 Team CharLS
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "jpeg_marker_code.hpp"
+#include "span.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <emmintrin.h>
+#define CHARLS_FF_BYTE_INDEX_SSE2
+#endif
+
+namespace charls {
+
+/// <summary>
+/// Index of the positions of the 0xFF bytes in entropy coded data. Every 0xFF byte is either followed by a stuffed 0 bit
+/// or is the start of a marker. The data is scanned in large blocks (SSE2 on x64: 16 bytes at a time) and the positions
+/// of the 0xFF bytes are stored as 16 bit offsets. This avoids a new search for every 0xFF byte that is encountered.
+/// </summary>
+class ff_byte_index final
+{
+public:
+    void reset(const span<const std::byte> source) noexcept
+    {
+        block_begin_ = source.data();
+        block_end_ = block_begin_;
+        end_ = to_address(source.end());
+        count_ = 0;
+        next_ = 0;
+    }
+
+    /// <summary>
+    /// Returns the position of the first 0xFF byte at or after position, or the end of the source when there is none.
+    /// Positions must be passed in increasing order (until the next reset).
+    /// </summary>
+    [[nodiscard]]
+    const std::byte* find(const std::byte* position) noexcept
+    {
+        for (;;)
+        {
+            for (; next_ != count_; ++next_)
+            {
+                if (const std::byte* ff_position{block_begin_ + offsets_[next_]}; ff_position >= position)
+                    return ff_position;
+            }
+
+            if (block_end_ == end_)
+                return end_;
+
+            scan_block(std::max(position, block_end_));
+        }
+    }
+
+private:
+    void scan_block(const std::byte* begin) noexcept
+    {
+        block_begin_ = begin;
+        count_ = 0;
+        next_ = 0;
+
+        const std::byte* const end{begin + std::min(static_cast<size_t>(end_ - begin), block_size)};
+        const std::byte* position{begin};
+
+#ifdef CHARLS_FF_BYTE_INDEX_SSE2
+        const __m128i ff_bytes{_mm_set1_epi8(-1)};
+        for (; end - position >= 16; position += 16)
+        {
+            const __m128i bytes{_mm_loadu_si128(static_cast<const __m128i*>(static_cast<const void*>(position)))};
+            auto mask{static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, ff_bytes)))};
+            if (LIKELY(mask == 0))
+                continue;
+
+            if (count_ + 16 > capacity)
+            {
+                block_end_ = position;
+                return;
+            }
+
+            for (; mask != 0; mask &= mask - 1)
+            {
+                offsets_[count_++] = static_cast<uint16_t>(position - begin + countr_zero(mask));
+            }
+        }
+#else
+        for (; end - position >= 8; position += 8)
+        {
+            uint64_t mask{ff_byte_mask(read_big_endian_unaligned<uint64_t>(position))};
+            if (LIKELY(mask == 0))
+                continue;
+
+            if (count_ + 8 > capacity)
+            {
+                block_end_ = position;
+                return;
+            }
+
+            // The most significant byte of the big endian value is the first byte.
+            do
+            {
+                const int bit_index{countl_zero(mask)};
+                offsets_[count_++] = static_cast<uint16_t>(position - begin + (bit_index / 8));
+                mask ^= uint64_t{1} << (63 - bit_index);
+            } while (mask != 0);
+        }
+#endif
+
+        for (; position != end; ++position)
+        {
+            if (*position != jpeg_marker_start_byte)
+                continue;
+
+            if (count_ == capacity)
+            {
+                block_end_ = position;
+                return;
+            }
+
+            offsets_[count_++] = static_cast<uint16_t>(position - begin);
+        }
+
+        block_end_ = end;
+    }
+
+    static constexpr size_t block_size{size_t{1} << 16}; // Offsets in a block fit in 16 bits.
+    static constexpr uint32_t capacity{512};
+
+    std::array<uint16_t, capacity> offsets_{};
+    uint32_t count_{};
+    uint32_t next_{};
+    const std::byte* block_begin_{};
+    const std::byte* block_end_{};
+    const std::byte* end_{};
+};
+
+
+/// <summary>
+/// Locates the start of every restart interval in the entropy coded data of a scan by searching for the RSTm markers.
+/// Returns the byte offsets (relative to the begin of source) of the first byte of each restart interval.
+/// An empty vector is returned when the expected sequence of RSTm markers cannot be found; the caller
+/// is expected to fall back to sequential decoding, which will report the exact error.
+/// </summary>
+[[nodiscard]]
+inline std::vector<size_t> find_restart_interval_offsets(const span<const std::byte> source, const size_t interval_count)
+{
+    std::vector<size_t> offsets;
+    offsets.reserve(interval_count);
+    offsets.push_back(0);
+
+    ff_byte_index index;
+    index.reset(source);
+    const std::byte* position{source.data()};
+    const std::byte* const end_position{to_address(source.end())};
+    while (offsets.size() < interval_count)
+    {
+        position = index.find(position);
+        if (position == end_position)
+            return {};
+
+        // Skip all 0xFF fill bytes that may precede a marker (see T.81, B.1.1.2).
+        do
+        {
+            ++position;
+        } while (position < end_position && *position == jpeg_marker_start_byte);
+
+        if (position == end_position)
+            return {};
+
+        // JPEG-LS bit stream rule: if 0xFF is followed by a 0 bit, it is part of the entropy coded data.
+        if ((*position & std::byte{0x80}) == std::byte{})
+            continue;
+
+        if (std::to_integer<uint32_t>(*position) !=
+            jpeg_restart_marker_base + (offsets.size() - 1) % jpeg_restart_marker_range)
+            return {};
+
+        ++position;
+        offsets.push_back(static_cast<size_t>(position - source.data()));
+    }
+
+    return offsets;
+}
+
+
+/// <summary>
+/// Locates the end of the entropy coded data of a scan: the first marker that is not a RSTm marker
+/// (or any marker when restart markers are not expected).
+/// Returns the byte offset (relative to the begin of source) of the first 0xFF byte of this marker,
+/// or the size of source when no marker can be found.
+/// </summary>
+[[nodiscard]]
+inline size_t find_end_of_scan(const span<const std::byte> source, const bool restart_markers_expected) noexcept
+{
+    ff_byte_index index;
+    index.reset(source);
+    const std::byte* position{source.data()};
+    const std::byte* const end_position{to_address(source.end())};
+    for (;;)
+    {
+        const std::byte* marker_start{index.find(position)};
+        if (marker_start == end_position)
+            return source.size();
+
+        // Skip all 0xFF fill bytes that may precede a marker (see T.81, B.1.1.2).
+        position = marker_start;
+        do
+        {
+            ++position;
+        } while (position < end_position && *position == jpeg_marker_start_byte);
+
+        if (position == end_position)
+            return source.size();
+
+        // JPEG-LS bit stream rule: if 0xFF is followed by a 0 bit, it is part of the entropy coded data.
+        if ((*position & std::byte{0x80}) == std::byte{})
+            continue;
+
+        if (const auto code{std::to_integer<uint32_t>(*position)};
+            restart_markers_expected && code >= jpeg_restart_marker_base &&
+            code < jpeg_restart_marker_base + jpeg_restart_marker_range)
+        {
+            ++position;
+            continue;
+        }
+
+        return static_cast<size_t>(marker_start - source.data());
+    }
+}
+
+
+/// <summary>
+/// Determines if source contains all marker segments up to and including the next start of scan (SOS) segment or
+/// end of image (EOI) marker. When the frame header defines a height of 0, the define number of lines (DNL) segment
+/// that follows the first scan must also be present. Used by incremental decoding to only parse complete headers.
+/// Returns true for malformed data: the stream reader will report the exact error.
+/// </summary>
+[[nodiscard]]
+inline bool contains_complete_marker_segments(const span<const std::byte> source) noexcept
+{
+    const std::byte* position{source.data()};
+    const std::byte* const end_position{to_address(source.end())};
+    const auto read_uint16{[](const std::byte* p) noexcept {
+        return (std::to_integer<size_t>(p[0]) << 8U) | std::to_integer<size_t>(p[1]);
+    }};
+
+    // Some legacy JPEG encoders insert a padding zero byte before the EOI marker, which is tolerated by the reader.
+    if (position < end_position && *position == std::byte{})
+    {
+        ++position;
+    }
+
+    bool height_defined_by_dnl{};
+    for (;;)
+    {
+        if (position == end_position)
+            return false;
+
+        if (*position != jpeg_marker_start_byte)
+            return true;
+
+        // Skip all 0xFF fill bytes that may precede a marker code (see T.81, B.1.1.2).
+        do
+        {
+            ++position;
+        } while (position < end_position && *position == jpeg_marker_start_byte);
+
+        if (position == end_position)
+            return false;
+
+        const auto marker_code{static_cast<jpeg_marker_code>(*position)};
+        ++position;
+        if (marker_code == jpeg_marker_code::start_of_image)
+            continue;
+
+        if (marker_code == jpeg_marker_code::end_of_image)
+            return true;
+
+        if (end_position - position < 2)
+            return false;
+
+        const size_t segment_size{read_uint16(position)};
+        if (segment_size < 2)
+            return true;
+
+        if (static_cast<size_t>(end_position - position) < segment_size)
+            return false;
+
+        if (marker_code == jpeg_marker_code::start_of_frame_jpegls && segment_size >= 5)
+        {
+            // The segment starts with the segment size, P and Y (the number of lines).
+            height_defined_by_dnl = read_uint16(position + 3) == 0;
+        }
+
+        position += segment_size;
+        if (marker_code != jpeg_marker_code::start_of_scan)
+            continue;
+
+        if (!height_defined_by_dnl)
+            return true;
+
+        // The DNL segment is located directly after the entropy coded data of the first scan.
+        const span<const std::byte> scan_data{position, static_cast<size_t>(end_position - position)};
+        const size_t end_of_scan{find_end_of_scan(scan_data, false)};
+        if (end_of_scan == scan_data.size())
+            return false;
+
+        position += end_of_scan;
+        height_defined_by_dnl = false;
+    }
+}
+
+} // namespace charls
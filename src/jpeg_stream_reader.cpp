@@ -84,6 +84,25 @@ void jpeg_stream_reader::source(const span<const byte> source) noexcept
 }
 
 
+void jpeg_stream_reader::rewind() noexcept
+{
+    position_ = {};
+    end_position_ = {};
+    segment_data_ = {};
+    frame_info_ = {};
+    parameters_ = {};
+    preset_coding_parameters_ = {};
+    component_infos_.clear();
+    mapping_tables_.clear();
+    state_ = state::before_start_of_image;
+    read_component_count_ = 0;
+    scan_component_count_ = 0;
+    scan_interleave_mode_ = {};
+    dnl_marker_expected_ = false;
+    compressed_data_format_ = {};
+}
+
+
 void jpeg_stream_reader::read_header(spiff_header* header, bool* spiff_header_found)
 {
     ASSERT(state_ != state::scan_section);
@@ -952,7 +971,7 @@ void jpeg_stream_reader::add_mapping_table(const uint8_t table_id, const uint8_t
     if (table_id == 0 || as_const(*this).find_mapping_table_entry(table_id) != mapping_tables_.cend())
         throw_jpegls_error(jpegls_errc::invalid_parameter_mapping_table_id);
 
-    mapping_tables_.emplace_back(table_id, entry_size, table_data);
+    mapping_tables_.emplace_back(table_id, entry_size, table_data, mapping_tables_.get_allocator());
 }
 
 
@@ -995,7 +1014,7 @@ bool jpeg_stream_reader::has_external_mapping_table_ids() const noexcept
 }
 
 
-std::vector<jpeg_stream_reader::mapping_table_entry>::const_iterator
+memory_vector<jpeg_stream_reader::mapping_table_entry>::const_iterator
 jpeg_stream_reader::find_mapping_table_entry(const uint8_t table_id) const noexcept
 {
     return find_if(mapping_tables_.cbegin(), mapping_tables_.cend(),
@@ -1003,7 +1022,7 @@ jpeg_stream_reader::find_mapping_table_entry(const uint8_t table_id) const noexc
 }
 
 
-std::vector<jpeg_stream_reader::mapping_table_entry>::iterator
+memory_vector<jpeg_stream_reader::mapping_table_entry>::iterator
 jpeg_stream_reader::find_mapping_table_entry(const uint8_t table_id) noexcept
 {
     const auto const_it{as_const(*this).find_mapping_table_entry(table_id)};
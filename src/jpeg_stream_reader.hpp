@@ -6,12 +6,12 @@
 #include "charls/public_types.h"
 
 #include "coding_parameters.hpp"
+#include "memory_allocator.hpp"
 #include "span.hpp"
 #include "util.hpp"
 
 #include <cstdint>
 #include <numeric>
-#include <vector>
 
 namespace charls {
 
@@ -22,6 +22,13 @@ class jpeg_stream_reader final
 {
 public:
     jpeg_stream_reader() = default;
+
+    explicit jpeg_stream_reader(const memory_resource& resource) noexcept :
+        component_infos_{memory_allocator<component_info>{resource}},
+        mapping_tables_{memory_allocator<mapping_table_entry>{resource}}
+    {
+    }
+
     ~jpeg_stream_reader() = default;
 
     jpeg_stream_reader(const jpeg_stream_reader&) = delete;
@@ -31,6 +38,21 @@ public:
 
     void source(span<const std::byte> source) noexcept;
 
+    /// <summary>
+    /// Resets the reader to its initial state. The installed callbacks are kept.
+    /// </summary>
+    void rewind() noexcept;
+
+    /// <summary>
+    /// Replaces the source with a larger one that starts with the same bytes, possibly at another memory location.
+    /// Data referenced by already read segments (mapping tables) must remain valid at the previous location.
+    /// </summary>
+    void extend_source(const std::byte* previous_source_begin, span<const std::byte> source) noexcept
+    {
+        position_ = source.begin() + (position_ - previous_source_begin);
+        end_position_ = source.end();
+    }
+
     [[nodiscard]]
     const charls::frame_info& frame_info() const noexcept
     {
@@ -254,8 +276,9 @@ private:
     class mapping_table_entry final
     {
     public:
-        mapping_table_entry(const uint8_t table_id, const uint8_t entry_size, const span<const std::byte> table_data) :
-            table_id_{table_id}, entry_size_{entry_size}
+        mapping_table_entry(const uint8_t table_id, const uint8_t entry_size, const span<const std::byte> table_data,
+                            const memory_allocator<span<const std::byte>>& allocator) :
+            data_fragments_{allocator}, table_id_{table_id}, entry_size_{entry_size}
         {
             add_fragment(table_data);
         }
@@ -296,16 +319,16 @@ private:
         }
 
     private:
-        std::vector<span<const std::byte>> data_fragments_;
+        memory_vector<span<const std::byte>> data_fragments_;
         uint8_t table_id_;
         uint8_t entry_size_;
     };
 
     [[nodiscard]]
-    std::vector<mapping_table_entry>::const_iterator find_mapping_table_entry(uint8_t table_id) const noexcept;
+    memory_vector<mapping_table_entry>::const_iterator find_mapping_table_entry(uint8_t table_id) const noexcept;
 
     [[nodiscard]]
-    std::vector<mapping_table_entry>::iterator find_mapping_table_entry(uint8_t table_id) noexcept;
+    memory_vector<mapping_table_entry>::iterator find_mapping_table_entry(uint8_t table_id) noexcept;
 
     span<const std::byte>::iterator position_{};
     span<const std::byte>::iterator end_position_{};
@@ -313,8 +336,8 @@ private:
     charls::frame_info frame_info_{};
     coding_parameters parameters_{};
     jpegls_pc_parameters preset_coding_parameters_{};
-    std::vector<component_info> component_infos_;
-    std::vector<mapping_table_entry> mapping_tables_;
+    memory_vector<component_info> component_infos_;
+    memory_vector<mapping_table_entry> mapping_tables_;
     state state_{};
     uint32_t read_component_count_{};
     uint32_t scan_component_count_{};
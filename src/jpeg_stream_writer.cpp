@@ -28,10 +28,38 @@ void jpeg_stream_writer::write_end_of_image(const bool even_destination_size)
     if (even_destination_size && bytes_written() % 2 != 0)
     {
         // Write an additional 0xFF byte to ensure that the encoded bit stream has an even size.
+        reserve(1);
         write_byte(jpeg_marker_start_byte);
     }
 
     write_segment_without_data(jpeg_marker_code::end_of_image);
+
+    if (has_encoded_data_handler())
+    {
+        flush_encoded_data();
+    }
+}
+
+
+void jpeg_stream_writer::flush_encoded_data(const size_t minimum_size)
+{
+    ASSERT(has_encoded_data_handler());
+
+    if (byte_offset_ != 0)
+    {
+        if (UNLIKELY(static_cast<bool>(
+                encoded_data_handler_.handler(buffer_.data(), byte_offset_, encoded_data_handler_.user_context))))
+            impl::throw_jpegls_error(jpegls_errc::callback_failed);
+
+        flushed_byte_count_ += byte_offset_;
+        byte_offset_ = 0;
+    }
+
+    if (buffer_.size() < minimum_size)
+    {
+        buffer_.resize(minimum_size);
+        destination_ = {buffer_.data(), buffer_.size()};
+    }
 }
 
 
@@ -207,6 +235,31 @@ void jpeg_stream_writer::write_start_of_scan_segment(const int32_t component_cou
 }
 
 
+void jpeg_stream_writer::write_define_restart_interval_segment(const uint32_t restart_interval)
+{
+    // Note: The JPEG-LS standard supports a 2,3 or 4 byte restart interval (see ISO/IEC 14495-1, C.2.5)
+    //       Use the 2 byte variant when possible, as the original JPEG standard only supports 2 bytes.
+    if (restart_interval <= numeric_limits<uint16_t>::max())
+    {
+        write_segment_header(jpeg_marker_code::define_restart_interval, sizeof(uint16_t));
+        write_uint16(restart_interval);
+    }
+    else
+    {
+        write_segment_header(jpeg_marker_code::define_restart_interval, sizeof(uint32_t));
+        write_uint32(restart_interval);
+    }
+}
+
+
+void jpeg_stream_writer::write_restart_marker(const uint32_t restart_interval_index)
+{
+    reserve(2);
+    write_byte(jpeg_marker_start_byte);
+    write_uint8(jpeg_restart_marker_base + static_cast<int32_t>(restart_interval_index % jpeg_restart_marker_range));
+}
+
+
 void jpeg_stream_writer::write_jpegls_preset_parameters_segment(const jpegls_preset_parameters_type preset_parameters_type,
                                                                 const int32_t table_id, const int32_t entry_size,
                                                                 const span<const std::byte> table_data)
@@ -234,9 +287,7 @@ void jpeg_stream_writer::write_segment_header(const jpeg_marker_code marker_code
     // Check if there is enough room in the destination to write the complete segment.
     // Other methods assume that the checking in done here and don't check again.
     constexpr size_t marker_code_size{2};
-    if (const size_t total_segment_size{marker_code_size + segment_length_size + data_size};
-        UNLIKELY(byte_offset_ + total_segment_size > destination_.size()))
-        impl::throw_jpegls_error(jpegls_errc::destination_too_small);
+    reserve(marker_code_size + segment_length_size + data_size);
 
     write_marker(marker_code);
     write_uint16(static_cast<uint16_t>(segment_length_size + data_size));
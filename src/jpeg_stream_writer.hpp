@@ -8,11 +8,10 @@
 #include "constants.hpp"
 #include "jpeg_marker_code.hpp"
 #include "jpegls_preset_parameters_type.hpp"
+#include "memory_allocator.hpp"
 #include "span.hpp"
 #include "util.hpp"
 
-#include <vector>
-
 namespace charls {
 
 // Purpose: 'Writer' class that can generate JPEG-LS file streams.
@@ -20,6 +19,12 @@ class jpeg_stream_writer final
 {
 public:
     jpeg_stream_writer() = default;
+
+    explicit jpeg_stream_writer(const memory_resource& resource) noexcept :
+        mapping_table_ids_{memory_allocator<uint8_t>{resource}}, buffer_{memory_allocator<std::byte>{resource}}
+    {
+    }
+
     ~jpeg_stream_writer() = default;
 
     jpeg_stream_writer(const jpeg_stream_writer&) = delete;
@@ -100,12 +105,24 @@ public:
     /// <param name="interleave_mode">The interleave mode of the components.</param>
     void write_start_of_scan_segment(int32_t component_count, int32_t near_lossless, interleave_mode interleave_mode);
 
+    /// <summary>
+    /// Writes a JPEG Define Restart Interval (DRI) segment.
+    /// </summary>
+    /// <param name="restart_interval">The number of lines in a restart interval. 0 disables restart intervals.</param>
+    void write_define_restart_interval_segment(uint32_t restart_interval);
+
+    /// <summary>
+    /// Writes the JPEG restart (RSTm) marker that follows a restart interval.
+    /// </summary>
+    /// <param name="restart_interval_index">The index of the restart interval in the scan that the marker completes.</param>
+    void write_restart_marker(uint32_t restart_interval_index);
+
     void write_end_of_image(bool even_destination_size);
 
     [[nodiscard]]
     size_t bytes_written() const noexcept
     {
-        return byte_offset_;
+        return flushed_byte_count_ + byte_offset_;
     }
 
     [[nodiscard]]
@@ -123,11 +140,38 @@ public:
     void destination(const span<std::byte> destination) noexcept
     {
         destination_ = destination;
+        encoded_data_handler_ = {};
+        buffer_.clear();
+        buffer_.shrink_to_fit();
+    }
+
+    /// <summary>
+    /// Uses an internal buffer as destination: the buffered bytes are passed to the handler when the buffer is full
+    /// and when the end of the image is written.
+    /// </summary>
+    void destination(const callback_function<at_encoded_data_handler> encoded_data_handler)
+    {
+        buffer_.resize(encoded_data_buffer_size);
+        destination_ = {buffer_.data(), buffer_.size()};
+        encoded_data_handler_ = encoded_data_handler;
     }
 
+    [[nodiscard]]
+    bool has_encoded_data_handler() const noexcept
+    {
+        return encoded_data_handler_.handler != nullptr;
+    }
+
+    /// <summary>
+    /// Passes the buffered bytes to the encoded data handler and ensures that at least minimum_size bytes are available
+    /// in the destination.
+    /// </summary>
+    void flush_encoded_data(size_t minimum_size = 0);
+
     void rewind() noexcept
     {
         byte_offset_ = 0;
+        flushed_byte_count_ = 0;
         component_index_ = 0;
     }
 
@@ -145,6 +189,11 @@ public:
         mapping_table_ids_[component_index] = static_cast<uint8_t>(mapping_table_id);
     }
 
+    void copy_mapping_table_ids_to(jpeg_stream_writer& writer) const
+    {
+        writer.mapping_table_ids_.assign(mapping_table_ids_.cbegin(), mapping_table_ids_.cend());
+    }
+
 private:
     void write_jpegls_preset_parameters_segment(jpegls_preset_parameters_type preset_parameters_type, int32_t table_id,
                                                 int32_t entry_size, span<const std::byte> table_data);
@@ -152,10 +201,19 @@ private:
 
     void write_segment_without_data(const jpeg_marker_code marker_code)
     {
-        if (UNLIKELY(byte_offset_ + 2 > destination_.size()))
+        reserve(2);
+        write_marker(marker_code);
+    }
+
+    void reserve(const size_t size)
+    {
+        if (LIKELY(byte_offset_ + size <= destination_.size()))
+            return;
+
+        if (UNLIKELY(!has_encoded_data_handler()))
             impl::throw_jpegls_error(jpegls_errc::destination_too_small);
 
-        write_marker(marker_code);
+        flush_encoded_data(size);
     }
 
     void write_segment(const jpeg_marker_code marker_code, const span<const std::byte> data)
@@ -247,7 +305,12 @@ private:
     span<std::byte> destination_{};
     size_t byte_offset_{};
     uint8_t component_index_{};
-    std::vector<uint8_t> mapping_table_ids_;
+    memory_vector<uint8_t> mapping_table_ids_;
+
+    // Streaming to a handler: the bytes are buffered and the number of bytes already passed to the handler is tracked.
+    callback_function<at_encoded_data_handler> encoded_data_handler_{};
+    memory_vector<std::byte> buffer_;
+    size_t flushed_byte_count_{};
 };
 
 } // namespace charls
@@ -130,6 +130,29 @@ constexpr int32_t compute_range_parameter(const int32_t maximum_sample_value, co
 }
 
 
+/// <summary>
+/// Computes the multiplier that replaces a division by divisor with a multiply and a 32 bit shift.
+/// </summary>
+[[nodiscard]]
+constexpr uint64_t compute_reciprocal_multiplier(const int32_t divisor) noexcept
+{
+    ASSERT(divisor > 0);
+    return (uint64_t{1} << 32) / static_cast<uint32_t>(divisor) + 1;
+}
+
+
+/// <summary>
+/// Computes (dividend / divisor) with the multiplier of compute_reciprocal_multiplier.
+/// The result is exact for all dividends below 2^32 / divisor.
+/// </summary>
+[[nodiscard]]
+constexpr int32_t divide_by_reciprocal(const int32_t dividend, const uint64_t multiplier) noexcept
+{
+    ASSERT(dividend >= 0);
+    return static_cast<int32_t>((static_cast<uint64_t>(dividend) * multiplier) >> 32);
+}
+
+
 /// <summary>
 /// Computes the parameter LIMIT. (see ISO/IEC 14495-1, A.2.1)
 /// </summary>
@@ -140,6 +163,24 @@ constexpr int32_t compute_limit_parameter(const int32_t bits_per_sample)
 }
 
 
+/// <summary>
+/// Computes the maximum number of bytes that can be needed to encode a single line of a scan.
+/// </summary>
+[[nodiscard]]
+constexpr size_t compute_maximum_encoded_line_size(const uint32_t width, const int32_t component_count,
+                                                   const int32_t bits_per_sample)
+{
+    // Worst case every sample is encoded with LIMIT bits (run mode uses fewer bits), a few bits are needed per
+    // line to terminate a run and a bit is lost for every 0xFF byte.
+    constexpr size_t line_overhead_bits{32};
+    return ((static_cast<size_t>(width) * static_cast<size_t>(component_count) *
+                 static_cast<size_t>(compute_limit_parameter(bits_per_sample)) +
+             line_overhead_bits) /
+            7) +
+           1;
+}
+
+
 [[nodiscard]]
 inline int32_t compute_predicted_value(const int32_t ra, const int32_t rb, const int32_t rc) noexcept
 {
@@ -11,7 +11,7 @@
 
 namespace charls {
 
-// Optimized trait classes for lossless compression of 8-bit color and 8/16 bit monochrome images.
+// Optimized trait classes for lossless compression of 8/10/12/16 bit color and monochrome images.
 // This class assumes MaximumSampleValue correspond to a whole number of bits, and no custom ResetValue is set when encoding.
 // The point of this is to have the most optimized code for the most common and most demanding scenario.
 template<typename SampleType, int32_t BitsPerSample>
@@ -170,7 +170,11 @@ struct lossless_traits<pair<SampleType>, BitsPerSample> final : lossless_traits_
     FORCE_INLINE static SampleType compute_reconstructed_sample(const int32_t predicted_value,
                                                                 const int32_t error_value) noexcept
     {
-        return static_cast<SampleType>(predicted_value + error_value);
+        if constexpr (BitsPerSample == sizeof(SampleType) * 8)
+            return static_cast<SampleType>(predicted_value + error_value);
+        else
+            return lossless_traits_impl<SampleType, BitsPerSample>::compute_reconstructed_sample(predicted_value,
+                                                                                                 error_value);
     }
 };
 
@@ -196,7 +200,11 @@ struct lossless_traits<triplet<SampleType>, BitsPerSample> final : lossless_trai
     FORCE_INLINE static SampleType compute_reconstructed_sample(const int32_t predicted_value,
                                                                 const int32_t error_value) noexcept
     {
-        return static_cast<SampleType>(predicted_value + error_value);
+        if constexpr (BitsPerSample == sizeof(SampleType) * 8)
+            return static_cast<SampleType>(predicted_value + error_value);
+        else
+            return lossless_traits_impl<SampleType, BitsPerSample>::compute_reconstructed_sample(predicted_value,
+                                                                                                 error_value);
     }
 };
 
@@ -222,7 +230,11 @@ struct lossless_traits<quad<SampleType>, BitsPerSample> final : lossless_traits_
     FORCE_INLINE static SampleType compute_reconstructed_sample(const int32_t predicted_value,
                                                                 const int32_t error_value) noexcept
     {
-        return static_cast<SampleType>(predicted_value + error_value);
+        if constexpr (BitsPerSample == sizeof(SampleType) * 8)
+            return static_cast<SampleType>(predicted_value + error_value);
+        else
+            return lossless_traits_impl<SampleType, BitsPerSample>::compute_reconstructed_sample(predicted_value,
+                                                                                                 error_value);
     }
 };
 
@@ -8,38 +8,164 @@
 #include "default_traits.hpp"
 #include "jpegls_preset_coding_parameters.hpp"
 #include "lossless_traits.hpp"
+#include "near_lossless_traits.hpp"
 #include "scan_decoder_impl.hpp"
 #include "scan_encoder_impl.hpp"
 #include "util.hpp"
 
-namespace charls {
+// GCC and Clang can compile individual functions for another instruction set. The x86-64-v3 scan codecs override
+// the entry points of the baseline codecs with functions that are compiled for that instruction set and into which all
+// called functions are inlined (flatten). The shared inline functions are thereby only compiled into these functions
+// for x86-64-v3 (with for example LZCNT for countl_zero, MOVBE for the big endian reads and BMI2 for the shifts),
+// their out-of-line versions remain baseline code.
+// MSVC has no equivalent option: it only builds the baseline codecs.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CHARLS_X86_64_V3_CODECS
+#define X86_64_V3_TARGET __attribute__((target("avx2,bmi,bmi2,lzcnt,movbe,fma,f16c,popcnt"), flatten))
+#endif
 
-using std::make_unique;
-using std::unique_ptr;
+namespace charls {
 
 namespace {
 
-template<typename ScanProcess, typename Traits>
+#ifdef CHARLS_X86_64_V3_CODECS
+
+template<typename Traits>
+class scan_encoder_x86_64_v3 final : public scan_encoder_impl<Traits>
+{
+public:
+    using scan_encoder_impl<Traits>::scan_encoder_impl;
+
+    X86_64_V3_TARGET void encode_lines(const std::byte* source, const size_t stride, const uint32_t line_count) override
+    {
+        scan_encoder_impl<Traits>::encode_lines(source, stride, line_count);
+    }
+};
+
+
+template<typename Traits>
+class scan_decoder_x86_64_v3 final : public scan_decoder_impl<Traits>
+{
+public:
+    using scan_decoder_impl<Traits>::scan_decoder_impl;
+
+    X86_64_V3_TARGET void decode_lines(std::byte* destination, const size_t stride, const uint32_t line_count) override
+    {
+        scan_decoder_impl<Traits>::decode_lines(destination, stride, line_count);
+    }
+};
+
+#endif
+
+
+template<typename ScanProcess, instruction_set InstructionSet, typename Traits>
 [[nodiscard]]
-unique_ptr<ScanProcess> make_codec(const frame_info& frame, const jpegls_pc_parameters& pc_parameters,
-                                   const coding_parameters& parameters, const Traits& traits)
+memory_unique_ptr<ScanProcess> make_codec(const frame_info& frame, const jpegls_pc_parameters& pc_parameters,
+                                          const coding_parameters& parameters, const memory_resource& resource,
+                                          const Traits& traits)
 {
-    if constexpr (std::is_same_v<ScanProcess, scan_encoder>)
+#ifdef CHARLS_X86_64_V3_CODECS
+    if constexpr (InstructionSet == instruction_set::x86_64_v3)
     {
-        return make_unique<scan_encoder_impl<Traits>>(frame, pc_parameters, parameters, traits);
+        if constexpr (std::is_same_v<ScanProcess, scan_encoder>)
+        {
+            return allocate_unique<scan_encoder_x86_64_v3<Traits>>(resource, frame, pc_parameters, parameters, traits,
+                                                                   resource);
+        }
+        else
+        {
+            return allocate_unique<scan_decoder_x86_64_v3<Traits>>(resource, frame, pc_parameters, parameters, traits,
+                                                                   resource);
+        }
     }
     else
+#endif
     {
-        return make_unique<scan_decoder_impl<Traits>>(frame, pc_parameters, parameters, traits);
+        if constexpr (std::is_same_v<ScanProcess, scan_encoder>)
+        {
+            return allocate_unique<scan_encoder_impl<Traits>>(resource, frame, pc_parameters, parameters, traits,
+                                                              resource);
+        }
+        else
+        {
+            return allocate_unique<scan_decoder_impl<Traits>>(resource, frame, pc_parameters, parameters, traits,
+                                                              resource);
+        }
     }
 }
 
-} // namespace
 
+template<typename ScanProcess, instruction_set InstructionSet, typename SampleType, int32_t BitsPerSample>
+[[nodiscard]]
+memory_unique_ptr<ScanProcess> make_sample_interleaved_lossless_codec(const frame_info& frame,
+                                                                      const jpegls_pc_parameters& pc_parameters,
+                                                                      const coding_parameters& parameters,
+                                                                      const memory_resource& resource)
+{
+    switch (frame.component_count)
+    {
+    case 2:
+        return make_codec<ScanProcess, InstructionSet>(frame, pc_parameters, parameters, resource,
+                                                       lossless_traits<pair<SampleType>, BitsPerSample>());
+    case 3:
+        return make_codec<ScanProcess, InstructionSet>(frame, pc_parameters, parameters, resource,
+                                                       lossless_traits<triplet<SampleType>, BitsPerSample>());
+    default:
+        ASSERT(frame.component_count == 4);
+        return make_codec<ScanProcess, InstructionSet>(frame, pc_parameters, parameters, resource,
+                                                       lossless_traits<quad<SampleType>, BitsPerSample>());
+    }
+}
 
-template<typename ScanProcess>
-unique_ptr<ScanProcess> make_scan_codec(const frame_info& frame, const jpegls_pc_parameters& pc_parameters,
-                                        const coding_parameters& parameters)
+
+// The near-lossless codecs with compile time parameters are created for the most common formats: a single component
+// per line (interleave mode none or line) or 3 components interleaved by sample, to limit the number of instantiations.
+constexpr int32_t maximum_specialized_near_lossless{3};
+
+template<typename ScanProcess, instruction_set InstructionSet, typename SampleType, int32_t Near>
+[[nodiscard]]
+memory_unique_ptr<ScanProcess> make_near_lossless_codec(const frame_info& frame, const jpegls_pc_parameters& pc_parameters,
+                                                        const coding_parameters& parameters,
+                                                        const memory_resource& resource)
+{
+    if (parameters.interleave_mode == interleave_mode::sample)
+    {
+        ASSERT(frame.component_count == 3);
+        return make_codec<ScanProcess, InstructionSet>(frame, pc_parameters, parameters, resource,
+                                                       near_lossless_traits<SampleType, triplet<SampleType>, Near>());
+    }
+
+    return make_codec<ScanProcess, InstructionSet>(frame, pc_parameters, parameters, resource,
+                                                   near_lossless_traits<SampleType, SampleType, Near>());
+}
+
+
+template<typename ScanProcess, instruction_set InstructionSet, typename SampleType>
+[[nodiscard]]
+memory_unique_ptr<ScanProcess> make_near_lossless_codec(const frame_info& frame, const jpegls_pc_parameters& pc_parameters,
+                                                        const coding_parameters& parameters,
+                                                        const memory_resource& resource)
+{
+    switch (parameters.near_lossless)
+    {
+    case 1:
+        return make_near_lossless_codec<ScanProcess, InstructionSet, SampleType, 1>(frame, pc_parameters, parameters,
+                                                                                    resource);
+    case 2:
+        return make_near_lossless_codec<ScanProcess, InstructionSet, SampleType, 2>(frame, pc_parameters, parameters,
+                                                                                    resource);
+    default:
+        ASSERT(parameters.near_lossless == maximum_specialized_near_lossless);
+        return make_near_lossless_codec<ScanProcess, InstructionSet, SampleType, 3>(frame, pc_parameters, parameters,
+                                                                                    resource);
+    }
+}
+
+
+template<typename ScanProcess, instruction_set InstructionSet>
+[[nodiscard]]
+memory_unique_ptr<ScanProcess> make_scan_codec(const frame_info& frame, const jpegls_pc_parameters& pc_parameters,
+                                               const coding_parameters& parameters, const memory_resource& resource)
 {
 #ifndef DISABLE_SPECIALIZATIONS
 
@@ -48,33 +174,22 @@ unique_ptr<ScanProcess> make_scan_codec(const frame_info& frame, const jpegls_pc
     {
         if (parameters.interleave_mode == interleave_mode::sample)
         {
-            if (frame.bits_per_sample == 8)
-            {
-                switch (frame.component_count)
-                {
-                case 2:
-                    return make_codec<ScanProcess>(frame, pc_parameters, parameters, lossless_traits<pair<uint8_t>, 8>());
-                case 3:
-                    return make_codec<ScanProcess>(frame, pc_parameters, parameters, lossless_traits<triplet<uint8_t>, 8>());
-                default:
-                    ASSERT(frame.component_count == 4);
-                    return make_codec<ScanProcess>(frame, pc_parameters, parameters, lossless_traits<quad<uint8_t>, 8>());
-                }
-            }
-
-            if (frame.bits_per_sample == 16)
+            switch (frame.bits_per_sample)
             {
-                switch (frame.component_count)
-                {
-                case 2:
-                    return make_codec<ScanProcess>(frame, pc_parameters, parameters, lossless_traits<pair<uint16_t>, 16>());
-                case 3:
-                    return make_codec<ScanProcess>(frame, pc_parameters, parameters,
-                                                   lossless_traits<triplet<uint16_t>, 16>());
-                default:
-                    ASSERT(frame.component_count == 4);
-                    return make_codec<ScanProcess>(frame, pc_parameters, parameters, lossless_traits<quad<uint16_t>, 16>());
-                }
+            case 8:
+                return make_sample_interleaved_lossless_codec<ScanProcess, InstructionSet, uint8_t, 8>(
+                    frame, pc_parameters, parameters, resource);
+            case 10:
+                return make_sample_interleaved_lossless_codec<ScanProcess, InstructionSet, uint16_t, 10>(
+                    frame, pc_parameters, parameters, resource);
+            case 12:
+                return make_sample_interleaved_lossless_codec<ScanProcess, InstructionSet, uint16_t, 12>(
+                    frame, pc_parameters, parameters, resource);
+            case 16:
+                return make_sample_interleaved_lossless_codec<ScanProcess, InstructionSet, uint16_t, 16>(
+                    frame, pc_parameters, parameters, resource);
+            default:
+                break;
             }
         }
         else
@@ -82,16 +197,34 @@ unique_ptr<ScanProcess> make_scan_codec(const frame_info& frame, const jpegls_pc
             switch (frame.bits_per_sample)
             {
             case 8:
-                return make_codec<ScanProcess>(frame, pc_parameters, parameters, lossless_traits<uint8_t, 8>());
+                return make_codec<ScanProcess, InstructionSet>(frame, pc_parameters, parameters, resource,
+                                                               lossless_traits<uint8_t, 8>());
+            case 10:
+                return make_codec<ScanProcess, InstructionSet>(frame, pc_parameters, parameters, resource,
+                                                               lossless_traits<uint16_t, 10>());
             case 12:
-                return make_codec<ScanProcess>(frame, pc_parameters, parameters, lossless_traits<uint16_t, 12>());
+                return make_codec<ScanProcess, InstructionSet>(frame, pc_parameters, parameters, resource,
+                                                               lossless_traits<uint16_t, 12>());
             case 16:
-                return make_codec<ScanProcess>(frame, pc_parameters, parameters, lossless_traits<uint16_t, 16>());
+                return make_codec<ScanProcess, InstructionSet>(frame, pc_parameters, parameters, resource,
+                                                               lossless_traits<uint16_t, 16>());
             default:
                 break;
             }
         }
     }
+    else if (parameters.near_lossless <= maximum_specialized_near_lossless &&
+             (parameters.interleave_mode != interleave_mode::sample || frame.component_count == 3))
+    {
+        // Optimized near-lossless versions for common formats.
+        if (frame.bits_per_sample == 8)
+            return make_near_lossless_codec<ScanProcess, InstructionSet, uint8_t>(frame, pc_parameters, parameters,
+                                                                                  resource);
+
+        if (frame.bits_per_sample == 16)
+            return make_near_lossless_codec<ScanProcess, InstructionSet, uint16_t>(frame, pc_parameters, parameters,
+                                                                                   resource);
+    }
 
 #endif
 
@@ -103,62 +236,84 @@ unique_ptr<ScanProcess> make_scan_codec(const frame_info& frame, const jpegls_pc
         {
             if (frame.component_count == 2)
             {
-                return make_codec<ScanProcess>(
-                    frame, pc_parameters, parameters,
+                return make_codec<ScanProcess, InstructionSet>(
+                    frame, pc_parameters, parameters, resource,
                     default_traits<uint8_t, pair<uint8_t>>(maximum_sample_value, parameters.near_lossless));
             }
 
             if (frame.component_count == 3)
             {
-                return make_codec<ScanProcess>(
-                    frame, pc_parameters, parameters,
+                return make_codec<ScanProcess, InstructionSet>(
+                    frame, pc_parameters, parameters, resource,
                     default_traits<uint8_t, triplet<uint8_t>>(maximum_sample_value, parameters.near_lossless));
             }
 
             if (frame.component_count == 4)
             {
-                return make_codec<ScanProcess>(
-                    frame, pc_parameters, parameters,
+                return make_codec<ScanProcess, InstructionSet>(
+                    frame, pc_parameters, parameters, resource,
                     default_traits<uint8_t, quad<uint8_t>>(maximum_sample_value, parameters.near_lossless));
             }
         }
 
-        return make_codec<ScanProcess>(frame, pc_parameters, parameters,
-                                       default_traits<uint8_t, uint8_t>(maximum_sample_value, parameters.near_lossless));
+        return make_codec<ScanProcess, InstructionSet>(
+            frame, pc_parameters, parameters, resource,
+            default_traits<uint8_t, uint8_t>(maximum_sample_value, parameters.near_lossless));
     }
 
     if (parameters.interleave_mode == interleave_mode::sample)
     {
         if (frame.component_count == 2)
         {
-            return make_codec<ScanProcess>(
-                frame, pc_parameters, parameters,
+            return make_codec<ScanProcess, InstructionSet>(
+                frame, pc_parameters, parameters, resource,
                 default_traits<uint16_t, pair<uint16_t>>(maximum_sample_value, parameters.near_lossless));
         }
 
         if (frame.component_count == 3)
         {
-            return make_codec<ScanProcess>(
-                frame, pc_parameters, parameters,
+            return make_codec<ScanProcess, InstructionSet>(
+                frame, pc_parameters, parameters, resource,
                 default_traits<uint16_t, triplet<uint16_t>>(maximum_sample_value, parameters.near_lossless));
         }
 
         if (frame.component_count == 4)
         {
-            return make_codec<ScanProcess>(
-                frame, pc_parameters, parameters,
+            return make_codec<ScanProcess, InstructionSet>(
+                frame, pc_parameters, parameters, resource,
                 default_traits<uint16_t, quad<uint16_t>>(maximum_sample_value, parameters.near_lossless));
         }
     }
 
-    return make_codec<ScanProcess>(frame, pc_parameters, parameters,
-                                   default_traits<uint16_t, uint16_t>(maximum_sample_value, parameters.near_lossless));
+    return make_codec<ScanProcess, InstructionSet>(
+        frame, pc_parameters, parameters, resource,
+        default_traits<uint16_t, uint16_t>(maximum_sample_value, parameters.near_lossless));
+}
+
+} // namespace
+
+
+template<typename ScanProcess>
+memory_unique_ptr<ScanProcess> make_scan_codec(const frame_info& frame, const jpegls_pc_parameters& pc_parameters,
+                                               const coding_parameters& parameters, const memory_resource& resource,
+                                               const instruction_set isa)
+{
+#ifdef CHARLS_X86_64_V3_CODECS
+    if (isa == instruction_set::x86_64_v3)
+        return make_scan_codec<ScanProcess, instruction_set::x86_64_v3>(frame, pc_parameters, parameters, resource);
+#else
+    static_cast<void>(isa);
+#endif
+
+    return make_scan_codec<ScanProcess, instruction_set::baseline>(frame, pc_parameters, parameters, resource);
 }
 
 
-template std::unique_ptr<scan_decoder> make_scan_codec<scan_decoder>(const frame_info&, const jpegls_pc_parameters&,
-                                                                     const coding_parameters&);
-template std::unique_ptr<scan_encoder> make_scan_codec<scan_encoder>(const frame_info&, const jpegls_pc_parameters&,
-                                                                     const coding_parameters&);
+template memory_unique_ptr<scan_decoder> make_scan_codec<scan_decoder>(const frame_info&, const jpegls_pc_parameters&,
+                                                                       const coding_parameters&, const memory_resource&,
+                                                                       instruction_set);
+template memory_unique_ptr<scan_encoder> make_scan_codec<scan_encoder>(const frame_info&, const jpegls_pc_parameters&,
+                                                                       const coding_parameters&, const memory_resource&,
+                                                                       instruction_set);
 
 } // namespace charls
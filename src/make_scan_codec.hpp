@@ -4,21 +4,90 @@
 #pragma once
 
 #include "coding_parameters.hpp"
-
-#include <memory>
+#include "cpu_features.hpp"
+#include "memory_allocator.hpp"
 
 
 namespace charls {
 
+/// <summary>
+/// Creates the scan encoder or decoder for the parameters. The codec is compiled for the passed instruction set
+/// level, by default the best level the CPU supports. Levels that are not available in the build use the baseline codec.
+/// </summary>
 template<typename ScanProcess>
 [[nodiscard]]
-std::unique_ptr<ScanProcess> make_scan_codec(const frame_info& frame,
-                                             const jpegls_pc_parameters& pc_parameters, const coding_parameters& parameters);
+memory_unique_ptr<ScanProcess> make_scan_codec(const frame_info& frame, const jpegls_pc_parameters& pc_parameters,
+                                               const coding_parameters& parameters, const memory_resource& resource,
+                                               instruction_set isa = supported_instruction_set());
+
+
+extern template memory_unique_ptr<class scan_decoder>
+make_scan_codec<scan_decoder>(const frame_info&, const jpegls_pc_parameters&, const coding_parameters&,
+                              const memory_resource&, instruction_set);
+extern template memory_unique_ptr<class scan_encoder>
+make_scan_codec<scan_encoder>(const frame_info&, const jpegls_pc_parameters&, const coding_parameters&,
+                              const memory_resource&, instruction_set);
+
+
+/// <summary>
+/// Owns the scan codec of the previous scan and reuses it for the next scan when the parameters are identical.
+/// This avoids memory allocations (codec, line buffer and quantization lookup table) when many images with the
+/// same properties are encoded or decoded.
+/// </summary>
+template<typename ScanProcess>
+class scan_codec_cache final
+{
+public:
+    explicit scan_codec_cache(const memory_resource& resource = default_memory_resource()) noexcept :
+        resource_{&resource}
+    {
+    }
+
+    [[nodiscard]]
+    ScanProcess& get(const frame_info& frame, const jpegls_pc_parameters& pc_parameters, const coding_parameters& parameters)
+    {
+        if (codec_ && equal(frame_, frame) && equal(pc_parameters_, pc_parameters) && equal(parameters_, parameters))
+        {
+            codec_->reset();
+        }
+        else
+        {
+            codec_ = make_scan_codec<ScanProcess>(frame, pc_parameters, parameters, *resource_);
+            frame_ = frame;
+            pc_parameters_ = pc_parameters;
+            parameters_ = parameters;
+        }
+
+        return *codec_;
+    }
+
+private:
+    [[nodiscard]]
+    static constexpr bool equal(const frame_info& lhs, const frame_info& rhs) noexcept
+    {
+        return lhs.width == rhs.width && lhs.height == rhs.height && lhs.bits_per_sample == rhs.bits_per_sample &&
+               lhs.component_count == rhs.component_count;
+    }
+
+    [[nodiscard]]
+    static constexpr bool equal(const jpegls_pc_parameters& lhs, const jpegls_pc_parameters& rhs) noexcept
+    {
+        return lhs.maximum_sample_value == rhs.maximum_sample_value && lhs.threshold1 == rhs.threshold1 &&
+               lhs.threshold2 == rhs.threshold2 && lhs.threshold3 == rhs.threshold3 && lhs.reset_value == rhs.reset_value;
+    }
 
+    [[nodiscard]]
+    static constexpr bool equal(const coding_parameters& lhs, const coding_parameters& rhs) noexcept
+    {
+        return lhs.near_lossless == rhs.near_lossless && lhs.restart_interval == rhs.restart_interval &&
+               lhs.interleave_mode == rhs.interleave_mode && lhs.transformation == rhs.transformation;
+    }
 
-extern template std::unique_ptr<class scan_decoder>
-make_scan_codec<scan_decoder>(const frame_info&, const jpegls_pc_parameters& , const coding_parameters&);
-extern template std::unique_ptr<class scan_encoder>
-make_scan_codec<scan_encoder>(const frame_info&, const jpegls_pc_parameters&, const coding_parameters&);
+    const memory_resource* resource_;
+    memory_unique_ptr<ScanProcess> codec_;
+    frame_info frame_{};
+    jpegls_pc_parameters pc_parameters_{};
+    coding_parameters parameters_{};
+};
 
 } // namespace charls
@@ -0,0 +1,190 @@
+// SPDX-FileCopyrightText: © 2026 Team CharLS
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "charls/public_types.h"
+
+#include "assert.hpp"
+#include "util.hpp"
+
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace charls {
+
+/// <summary>
+/// The allocation functions (and their context) that a decoder or encoder instance uses for its memory.
+/// </summary>
+struct memory_resource final
+{
+    allocate_handler allocate;
+    deallocate_handler deallocate;
+    void* user_context;
+
+    [[nodiscard]]
+    void* allocate_bytes(const size_t size, const size_t alignment) const
+    {
+        ASSERT(alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+        void* memory{allocate(size, alignment, user_context)};
+        if (UNLIKELY(!memory))
+            throw std::bad_alloc();
+
+        return memory;
+    }
+
+    void deallocate_bytes(void* pointer, const size_t size) const noexcept
+    {
+        deallocate(pointer, size, user_context);
+    }
+};
+
+
+namespace impl {
+
+inline void* CHARLS_API_CALLING_CONVENTION default_allocate(const size_t size, size_t /*alignment*/,
+                                                            void* /*user_context*/) noexcept
+{
+    return ::operator new(size, std::nothrow);
+}
+
+inline void CHARLS_API_CALLING_CONVENTION default_deallocate(void* pointer, size_t /*size*/,
+                                                             void* /*user_context*/) noexcept
+{
+    ::operator delete(pointer);
+}
+
+} // namespace impl
+
+
+/// <summary>
+/// Returns the memory resource that uses the global operator new and delete.
+/// </summary>
+[[nodiscard]]
+inline const memory_resource& default_memory_resource() noexcept
+{
+    static constexpr memory_resource resource{impl::default_allocate, impl::default_deallocate, nullptr};
+    return resource;
+}
+
+
+/// <summary>
+/// Standard library compatible allocator that gets its memory from a memory_resource.
+/// The memory resource must outlive the allocator and all containers that use it.
+/// </summary>
+template<typename T>
+class memory_allocator
+{
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    memory_allocator() noexcept = default;
+
+    explicit memory_allocator(const memory_resource& resource) noexcept : resource_{&resource}
+    {
+    }
+
+    template<typename U>
+    memory_allocator(const memory_allocator<U>& other) noexcept : // NOLINT(google-explicit-constructor)
+        resource_{&other.resource()}
+    {
+    }
+
+    [[nodiscard]]
+    T* allocate(const size_t count) const
+    {
+        if (UNLIKELY(count > std::numeric_limits<size_t>::max() / sizeof(T)))
+            throw std::bad_alloc();
+
+        return static_cast<T*>(resource_->allocate_bytes(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, const size_t count) const noexcept
+    {
+        resource_->deallocate_bytes(pointer, count * sizeof(T));
+    }
+
+    [[nodiscard]]
+    const memory_resource& resource() const noexcept
+    {
+        return *resource_;
+    }
+
+    [[nodiscard]]
+    friend bool operator==(const memory_allocator& lhs, const memory_allocator& rhs) noexcept
+    {
+        return lhs.resource_ == rhs.resource_;
+    }
+
+    [[nodiscard]]
+    friend bool operator!=(const memory_allocator& lhs, const memory_allocator& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    const memory_resource* resource_{&default_memory_resource()};
+};
+
+
+template<typename T>
+using memory_vector = std::vector<T, memory_allocator<T>>;
+
+
+/// <summary>
+/// Deleter for objects that are created with allocate_unique.
+/// </summary>
+class memory_resource_deleter final
+{
+public:
+    memory_resource_deleter() noexcept = default;
+
+    memory_resource_deleter(const memory_resource& resource, const size_t size) noexcept :
+        resource_{&resource}, size_{size}
+    {
+    }
+
+    template<typename T>
+    void operator()(T* object) const noexcept
+    {
+        object->~T();
+        resource_->deallocate_bytes(object, size_);
+    }
+
+private:
+    const memory_resource* resource_{&default_memory_resource()};
+    size_t size_{};
+};
+
+
+template<typename T>
+using memory_unique_ptr = std::unique_ptr<T, memory_resource_deleter>;
+
+
+/// <summary>
+/// Creates an object with memory from the memory resource, comparable to std::make_unique.
+/// </summary>
+template<typename T, typename... Args>
+[[nodiscard]]
+memory_unique_ptr<T> allocate_unique(const memory_resource& resource, Args&&... args)
+{
+    void* memory{resource.allocate_bytes(sizeof(T), alignof(T))};
+    try
+    {
+        return memory_unique_ptr<T>{new (memory) T(std::forward<Args>(args)...), {resource, sizeof(T)}};
+    }
+    catch (...)
+    {
+        resource.deallocate_bytes(memory, sizeof(T));
+        throw;
+    }
+}
+
+} // namespace charls
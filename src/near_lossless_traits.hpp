@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: © 2026 Team CharLS
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "constants.hpp"
+#include "jpegls_algorithm.hpp"
+#include "util.hpp"
+
+#include <cstdlib>
+
+namespace charls {
+
+/// <summary>
+/// Computes (dividend / divisor) for a small constant divisor with a multiply and a shift.
+/// The result is exact for all dividends below 2^32 / divisor, which includes all dividends of
+/// 8 and 16 bit near-lossless coding (|error value| + NEAR).
+/// </summary>
+template<int32_t Divisor>
+struct reciprocal_divider final
+{
+    static_assert(Divisor > 0);
+
+    static constexpr uint64_t multiplier{compute_reciprocal_multiplier(Divisor)};
+    static constexpr uint32_t maximum_dividend{static_cast<uint32_t>((uint64_t{1} << 32) / Divisor)};
+
+    [[nodiscard]]
+    FORCE_INLINE constexpr static int32_t divide(const int32_t dividend) noexcept
+    {
+        ASSERT(static_cast<uint32_t>(dividend) < maximum_dividend);
+        return divide_by_reciprocal(dividend, multiplier);
+    }
+};
+
+
+// Optimized trait classes for near-lossless compression of 8 and 16 bit images with a small NEAR value.
+// This class assumes MaximumSampleValue corresponds to the number of bits of the sample type.
+// All parameters are compile time constants: the quantization of the error value (a division by 2 * NEAR + 1) is
+// done with a multiply and a shift.
+template<typename SampleType, typename PixelType, int32_t Near>
+struct near_lossless_traits final
+{
+    using sample_type = SampleType;
+    using pixel_type = PixelType;
+
+    static constexpr bool always_lossless{};
+    static constexpr bool always_lossless_and_default_parameters{};
+    static constexpr bool fixed_bits_per_pixel{true};
+
+    // ISO 14495-1 bpp symbol: number of bits needed to represent MAXVAL (not less than 2).
+    static constexpr int32_t bits_per_sample{static_cast<int32_t>(sizeof(SampleType) * 8)};
+
+    // ISO 14495-1 MAXVAL symbol: maximum possible image sample value over all components of a scan.
+    static constexpr int32_t maximum_sample_value{(1 << bits_per_sample) - 1};
+
+    // ISO 14495-1 NEAR symbol: difference bound for near-lossless coding.
+    static constexpr int32_t near_lossless{Near};
+
+    // ISO 14495-1 RANGE symbol: range of prediction error representation.
+    static constexpr int32_t range{compute_range_parameter(maximum_sample_value, near_lossless)};
+
+    // ISO 14495-1 qbpp symbol: number of bits needed to represent a mapped error value.
+    static constexpr int32_t quantized_bits_per_sample{log2_ceiling(range)};
+
+    // ISO 14495-1 LIMIT symbol: the value of glimit for a sample encoded in regular mode.
+    static constexpr int32_t limit{compute_limit_parameter(bits_per_sample)};
+
+    static constexpr uint32_t quantization_range{1U << bits_per_sample};
+
+    static_assert(Near > 0 && Near <= 3);
+    static_assert(bits_per_sample == 8 || bits_per_sample == 16);
+
+    [[nodiscard]]
+    FORCE_INLINE constexpr static int32_t compute_error_value(const int32_t e) noexcept
+    {
+        return modulo_range(quantize(e));
+    }
+
+    [[nodiscard]]
+    FORCE_INLINE static SampleType compute_reconstructed_sample(const int32_t predicted_value,
+                                                                const int32_t error_value) noexcept
+    {
+        return fix_reconstructed_value(predicted_value + dequantize(error_value));
+    }
+
+    [[nodiscard]]
+    FORCE_INLINE static bool is_near(const int32_t lhs, const int32_t rhs) noexcept
+    {
+        return std::abs(lhs - rhs) <= near_lossless;
+    }
+
+    [[nodiscard]]
+    static bool is_near(const pair<SampleType> lhs, const pair<SampleType> rhs) noexcept
+    {
+        return is_near(lhs.v1, rhs.v1) && is_near(lhs.v2, rhs.v2);
+    }
+
+    [[nodiscard]]
+    static bool is_near(const triplet<SampleType> lhs, const triplet<SampleType> rhs) noexcept
+    {
+        return is_near(lhs.v1, rhs.v1) && is_near(lhs.v2, rhs.v2) && is_near(lhs.v3, rhs.v3);
+    }
+
+    [[nodiscard]]
+    static bool is_near(const quad<SampleType> lhs, const quad<SampleType> rhs) noexcept
+    {
+        return is_near(lhs.v1, rhs.v1) && is_near(lhs.v2, rhs.v2) && is_near(lhs.v3, rhs.v3) && is_near(lhs.v4, rhs.v4);
+    }
+
+    [[nodiscard]]
+    FORCE_INLINE static int32_t correct_prediction(const int32_t predicted) noexcept
+    {
+        if (LIKELY((predicted & maximum_sample_value) == predicted))
+            return predicted;
+
+        return (~(predicted >> (int32_t_bit_count - 1))) & maximum_sample_value;
+    }
+
+    /// <summary>
+    /// Returns the value of errorValue modulo RANGE. ITU.T.87, A.4.5 (code segment A.9)
+    /// </summary>
+    [[nodiscard]]
+    FORCE_INLINE constexpr static int32_t modulo_range(int32_t error_value) noexcept
+    {
+        ASSERT(std::abs(error_value) <= range);
+
+        if (error_value < 0)
+        {
+            error_value += range;
+        }
+
+        if (error_value >= (range + 1) / 2)
+        {
+            error_value -= range;
+        }
+
+        return error_value;
+    }
+
+    /// <summary>
+    /// Quantizes the error value (ITU.T.87, A.4.4, code segment A.8) without a division instruction.
+    /// </summary>
+    [[nodiscard]]
+    FORCE_INLINE constexpr static int32_t quantize(const int32_t error_value) noexcept
+    {
+        if (error_value > 0)
+            return divider::divide(error_value + near_lossless);
+
+        return -divider::divide(near_lossless - error_value);
+    }
+
+    [[nodiscard]]
+    FORCE_INLINE constexpr static int32_t dequantize(const int32_t error_value) noexcept
+    {
+        return error_value * (2 * near_lossless + 1);
+    }
+
+#ifndef NDEBUG
+    [[nodiscard]]
+    static bool is_valid() noexcept
+    {
+        return true;
+    }
+#endif
+
+private:
+    using divider = reciprocal_divider<2 * Near + 1>;
+    static_assert(maximum_sample_value + (2 * Near) < divider::maximum_dividend);
+
+    [[nodiscard]]
+    FORCE_INLINE static SampleType fix_reconstructed_value(int32_t value) noexcept
+    {
+        if (value < -near_lossless)
+        {
+            value = value + range * (2 * near_lossless + 1);
+        }
+        else if (value > maximum_sample_value + near_lossless)
+        {
+            value = value - range * (2 * near_lossless + 1);
+        }
+
+        return static_cast<SampleType>(correct_prediction(value));
+    }
+};
+
+} // namespace charls
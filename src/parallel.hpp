@@ -0,0 +1,234 @@
+// SPDX-FileCopyrightText: © 2026 Team CharLS
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "assert.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace charls {
+
+/// <summary>
+/// Resolves the thread count requested by the user: 0 means use all hardware threads.
+/// </summary>
+[[nodiscard]]
+inline uint32_t resolve_thread_count(const uint32_t thread_count) noexcept
+{
+    if (thread_count != 0)
+        return thread_count;
+
+    return std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+
+/// <summary>
+/// Executes function(index) for every index in [0, count) using up to thread_count threads.
+/// The number of threads is also limited to the number of hardware threads: more threads would only add overhead, and
+/// a large user supplied thread count must not create that many OS threads. The calling thread also participates.
+/// Tasks are started in index order; after an exception no new tasks are started. The exception of the task with the
+/// lowest index is rethrown after all threads have completed, which makes the reported error identical to sequential
+/// execution.
+/// </summary>
+template<typename Function>
+void parallel_for(const size_t count, const uint32_t thread_count, Function function)
+{
+    ASSERT(thread_count > 0);
+    if (count == 0)
+        return;
+
+    std::atomic<size_t> next_index{};
+    std::atomic<bool> failed{};
+    std::exception_ptr exception;
+    size_t exception_index{};
+    std::mutex exception_mutex;
+
+    const auto worker{[&]() noexcept {
+        for (size_t index{next_index++}; index < count && !failed; index = next_index++)
+        {
+            try
+            {
+                function(index);
+            }
+            catch (...)
+            {
+                const std::lock_guard lock{exception_mutex};
+                if (!exception || index < exception_index)
+                {
+                    exception = std::current_exception();
+                    exception_index = index;
+                }
+                failed = true;
+            }
+        }
+    }};
+
+    std::vector<std::thread> threads;
+    const size_t extra_thread_count{
+        std::min({static_cast<size_t>(thread_count), static_cast<size_t>(resolve_thread_count(0)), count}) - 1};
+    threads.reserve(extra_thread_count);
+    for (size_t i{}; i < extra_thread_count; ++i)
+    {
+        try
+        {
+            threads.emplace_back(worker);
+        }
+        catch (const std::system_error&)
+        {
+            // Not able to create more threads: continue with the threads that are available.
+            break;
+        }
+    }
+
+    worker();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+
+/// <summary>
+/// Executes function(state, index) for every index in [0, count) using up to thread_count threads. Every thread
+/// creates its own state with make_state() and reuses it for all the indices it executes. The indices are handed out
+/// one at a time to the next idle thread, which balances tasks of different sizes. A thread that finds no index left
+/// doesn't create a state.
+/// </summary>
+template<typename MakeState, typename Function>
+void parallel_for_with_state(const size_t count, const uint32_t thread_count, MakeState make_state, Function function)
+{
+    // parallel_for doesn't run more threads than there are hardware threads: only create a task for every thread.
+    const size_t task_count{
+        std::min({count, static_cast<size_t>(thread_count), static_cast<size_t>(resolve_thread_count(0))})};
+
+    std::atomic<size_t> next_index{};
+    parallel_for(task_count, thread_count, [&](size_t) {
+        size_t index{next_index++};
+        if (index >= count)
+            return;
+
+        auto state{make_state()};
+        for (; index < count; index = next_index++)
+        {
+            function(state, index);
+        }
+    });
+}
+
+
+/// <summary>
+/// Executes produce(index) and consume(index) for every index in [0, count) as a two-stage pipeline on the calling
+/// thread and a second thread. consume(index) starts after produce(index) has completed, produce(index) starts after
+/// consume(index - depth) has completed. The produce stage runs on the second thread when produce_in_background is
+/// true, otherwise the consume stage does. When a stage throws, the other stage stops and the exception is rethrown.
+/// </summary>
+template<typename Produce, typename Consume>
+void pipeline_for(const size_t count, const size_t depth, const bool produce_in_background, Produce produce,
+                  Consume consume)
+{
+    ASSERT(depth > 0);
+
+    std::mutex mutex;
+    std::condition_variable progress_changed;
+    size_t produced_count{};
+    size_t consumed_count{};
+    bool aborted{};
+    std::exception_ptr exception;
+
+    // Waits until the condition is met, returns false when the other stage has failed.
+    const auto wait_until{[&](const auto condition) {
+        std::unique_lock lock{mutex};
+        progress_changed.wait(lock, [&] { return aborted || condition(); });
+        return !aborted;
+    }};
+
+    const auto completed{[&](size_t& completed_count) {
+        {
+            const std::lock_guard lock{mutex};
+            ++completed_count;
+        }
+        progress_changed.notify_all();
+    }};
+
+    const auto producer{[&] {
+        for (size_t index{}; index != count; ++index)
+        {
+            if (!wait_until([&] { return index < consumed_count + depth; }))
+                return;
+
+            produce(index);
+            completed(produced_count);
+        }
+    }};
+
+    const auto consumer{[&] {
+        for (size_t index{}; index != count; ++index)
+        {
+            if (!wait_until([&] { return index < produced_count; }))
+                return;
+
+            consume(index);
+            completed(consumed_count);
+        }
+    }};
+
+    const auto run_stage{[&](const bool produce_stage) noexcept {
+        try
+        {
+            if (produce_stage)
+            {
+                producer();
+            }
+            else
+            {
+                consumer();
+            }
+        }
+        catch (...)
+        {
+            const std::lock_guard lock{mutex};
+            if (!exception)
+            {
+                exception = std::current_exception();
+            }
+            aborted = true;
+        }
+        progress_changed.notify_all();
+    }};
+
+    std::thread thread;
+    try
+    {
+        thread = std::thread{run_stage, produce_in_background};
+    }
+    catch (const std::system_error&)
+    {
+        // Not able to create a thread: execute the stages sequentially.
+        for (size_t index{}; index != count; ++index)
+        {
+            produce(index);
+            consume(index);
+        }
+        return;
+    }
+
+    run_stage(!produce_in_background);
+    thread.join();
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+} // namespace charls
@@ -5,6 +5,9 @@
 
 #include "default_traits.hpp"
 #include "lossless_traits.hpp"
+#include "near_lossless_traits.hpp"
+
+#include <type_traits>
 
 namespace charls {
 
@@ -62,13 +65,20 @@ struct sample_traits_of<lossless_traits<PixelType, BitsPerSample>>
     using type = lossless_traits<typename extract_sample<PixelType>::type, BitsPerSample>;
 };
 
+// near_lossless_traits<SampleType, PixelType, Near> -> near_lossless_traits<SampleType, SampleType, Near>
+template<typename SampleType, typename PixelType, int32_t Near>
+struct sample_traits_of<near_lossless_traits<SampleType, PixelType, Near>>
+{
+    using type = near_lossless_traits<SampleType, SampleType, Near>;
+};
+
 template<typename Traits>
 using sample_traits_t = typename sample_traits_of<Traits>::type;
 
 
 /// <summary>
 /// Constructs a SampleTraits instance from a full Traits instance.
-/// For lossless_traits (stateless), returns a default-constructed instance.
+/// For lossless_traits and near_lossless_traits (stateless), returns a default-constructed instance.
 /// For default_traits, constructs with the same parameters (sample_type as pixel_type).
 /// </summary>
 template<typename Traits>
@@ -81,7 +91,7 @@ auto make_sample_traits(const Traits& traits) noexcept
     {
         return traits;
     }
-    else if constexpr (sample_traits_type::always_lossless)
+    else if constexpr (std::is_empty_v<sample_traits_type>)
     {
         return sample_traits_type{};
     }
@@ -5,6 +5,7 @@
 
 #include "coding_parameters.hpp"
 #include "jpegls_algorithm.hpp"
+#include "memory_allocator.hpp"
 #include "quantization_lut.hpp"
 #include "regular_mode_context.hpp"
 #include "run_mode_context.hpp"
@@ -36,7 +37,7 @@ bool precomputed_quantization_lut_available(const Traits& traits, const int32_t
 
 template<typename Traits>
 const int8_t* initialize_quantization_lut(const Traits& traits, const int32_t threshold1, const int32_t threshold2,
-                                          const int32_t threshold3, std::vector<int8_t>& quantization_lut)
+                                          const int32_t threshold3, memory_vector<int8_t>& quantization_lut)
 {
     // For lossless mode with default parameters, we have precomputed the lookup table for bit counts 8, 10, 12 and 16.
     if (precomputed_quantization_lut_available(traits, threshold1, threshold2, threshold3))
@@ -48,6 +49,11 @@ const int8_t* initialize_quantization_lut(const Traits& traits, const int32_t th
                 const auto& lut{quantization_lut_lossless_8()};
                 return &lut[lut.size() / 2];
             }
+            else if constexpr (Traits::bits_per_sample == 10)
+            {
+                const auto& lut{quantization_lut_lossless_10()};
+                return &lut[lut.size() / 2];
+            }
             else if constexpr (Traits::bits_per_sample == 12)
             {
                 const auto& lut{quantization_lut_lossless_12()};
@@ -124,14 +130,15 @@ protected:
     /// Copy frame_info and parameters to prevent 1 indirection during encoding/decoding.
     /// </remarks>
     scan_codec(const frame_info& frame_info, const jpegls_pc_parameters& pc_parameters,
-               const coding_parameters& parameters) noexcept :
+               const coding_parameters& parameters, const memory_resource& resource) noexcept :
         frame_info_{frame_info},
         parameters_{parameters},
         t1_{pc_parameters.threshold1},
         t2_{pc_parameters.threshold2},
         t3_{pc_parameters.threshold3},
         width_{frame_info.width},
-        reset_threshold_{static_cast<uint8_t>(pc_parameters.reset_value)}
+        reset_threshold_{static_cast<uint8_t>(pc_parameters.reset_value)},
+        quantization_lut_{memory_allocator<int8_t>{resource}}
     {
         ASSERT((parameters.interleave_mode == interleave_mode::none && this->frame_info().component_count == 1) ||
                parameters.interleave_mode != interleave_mode::none);
@@ -209,7 +216,7 @@ protected:
 
     // Quantization lookup table
     const int8_t* quantization_{};
-    std::vector<int8_t> quantization_lut_;
+    memory_vector<int8_t> quantization_lut_;
 };
 
 } // namespace charls
@@ -8,6 +8,7 @@
 #include "assert.hpp"
 #include "copy_from_line_buffer.hpp"
 #include "jpeg_marker_code.hpp"
+#include "jpeg_marker_scanner.hpp"
 #include "scan_codec.hpp"
 #include "span.hpp"
 #include "util.hpp"
@@ -30,7 +31,107 @@ public:
     scan_decoder& operator=(scan_decoder&&) = delete;
 
     [[nodiscard]]
-    virtual size_t decode_scan(span<const std::byte> source, std::byte* destination, size_t stride) = 0;
+    size_t decode_scan(const span<const std::byte> source, std::byte* destination, const size_t stride)
+    {
+        start_scan(source);
+        decode_lines(destination, stride, frame_info().height);
+        return end_scan();
+    }
+
+    /// <summary>
+    /// Starts decoding a scan. The lines of the scan can then be decoded in one or more calls to decode_lines.
+    /// </summary>
+    void start_scan(const span<const std::byte> source)
+    {
+        // Process images without a restart interval, as 1 large restart interval.
+        if (parameters_.restart_interval == 0)
+        {
+            parameters_.restart_interval = frame_info().height;
+        }
+
+        scan_begin_ = source.data();
+        initialize(source);
+    }
+
+    /// <summary>
+    /// Decodes the next line_count lines of the scan. Decoding continues where the previous call stopped.
+    /// </summary>
+    virtual void decode_lines(std::byte* destination, size_t stride, uint32_t line_count) = 0;
+
+    /// <summary>
+    /// Enables copying the decoded lines to the destination (including the color transformation) on a second thread,
+    /// behind the decoding of the lines. Needs to be called before the first line of a scan is decoded.
+    /// </summary>
+    virtual void use_conversion_thread(bool enable) = 0;
+
+    /// <summary>
+    /// Verifies the end of the scan and returns the number of bytes that have been read from the source.
+    /// </summary>
+    [[nodiscard]]
+    size_t end_scan()
+    {
+        if (UNLIKELY(position_ >= end_position_))
+            impl::throw_jpegls_error(jpegls_errc::need_more_data);
+
+        if (*position_ != jpeg_marker_start_byte)
+        {
+            read_bit();
+
+            if (UNLIKELY(position_ >= end_position_))
+                impl::throw_jpegls_error(jpegls_errc::need_more_data);
+
+            if (UNLIKELY(*position_ != jpeg_marker_start_byte))
+                impl::throw_jpegls_error(jpegls_errc::invalid_data);
+        }
+
+        if (UNLIKELY(read_cache_ != 0))
+            impl::throw_jpegls_error(jpegls_errc::invalid_data);
+
+        return read_position();
+    }
+
+    /// <summary>
+    /// Returns the number of source bytes that have been consumed by the lines decoded so far.
+    /// </summary>
+    [[nodiscard]]
+    size_t read_position() const noexcept
+    {
+        return static_cast<size_t>(get_actual_position() - scan_begin_);
+    }
+
+    /// <summary>
+    /// Replaces the source with a larger one that starts with the same bytes, possibly at another memory location.
+    /// Used by incremental decoding when more encoded data becomes available.
+    /// </summary>
+    void extend_source(const span<const std::byte> source) noexcept
+    {
+        ASSERT(source.size() >= static_cast<size_t>(end_position_ - scan_begin_));
+
+        position_ = source.data() + (position_ - scan_begin_);
+        scan_begin_ = source.data();
+        end_position_ = to_address(source.end());
+        ff_byte_index_.reset({position_, end_position_});
+        find_jpeg_marker_start_byte();
+    }
+
+    /// <summary>
+    /// Resets the decoder to the state after construction, to decode another scan with the same parameters.
+    /// </summary>
+    virtual void reset() noexcept
+    {
+        read_cache_ = 0;
+        valid_bits_ = 0;
+        restart_interval_counter_ = 0;
+    }
+
+    /// <summary>
+    /// Sets the index of the restart interval at which the source starts. Used when the restart intervals
+    /// of a scan are decoded in separate parts, to validate the RSTm markers that follow.
+    /// </summary>
+    void restart_interval_index(const size_t index) noexcept
+    {
+        restart_interval_counter_ = static_cast<uint32_t>(index % jpeg_restart_marker_range);
+    }
 
 protected:
     using scan_codec::scan_codec;
@@ -41,6 +142,7 @@ protected:
 
         position_ = source.data();
         end_position_ = to_address(source.end());
+        ff_byte_index_.reset(source);
 
         find_jpeg_marker_start_byte();
         fill_read_cache();
@@ -68,26 +170,6 @@ protected:
         copy_from_line_buffer_(source, static_cast<std::byte*>(destination), pixel_count);
     }
 
-    void end_scan()
-    {
-        if (UNLIKELY(position_ >= end_position_))
-            impl::throw_jpegls_error(jpegls_errc::need_more_data);
-
-        if (*position_ != jpeg_marker_start_byte)
-        {
-            read_bit();
-
-            if (UNLIKELY(position_ >= end_position_))
-                impl::throw_jpegls_error(jpegls_errc::need_more_data);
-
-            if (UNLIKELY(*position_ != jpeg_marker_start_byte))
-                impl::throw_jpegls_error(jpegls_errc::invalid_data);
-        }
-
-        if (UNLIKELY(read_cache_ != 0))
-            impl::throw_jpegls_error(jpegls_errc::invalid_data);
-    }
-
     [[nodiscard]]
     const std::byte* get_actual_position() const noexcept
     {
@@ -142,17 +224,29 @@ protected:
     }
 
     /// <summary>
-    /// Reads a byte from the bitstream without removing it.
-    /// This byte is used to check if there is a pre-computed Golomb code available.
+    /// Reads BitCount bits from the bitstream without removing them.
+    /// These bits are used to check if there is a pre-computed Golomb code available.
     /// </summary>
-    FORCE_INLINE size_t peek_byte()
+    template<size_t BitCount>
+    FORCE_INLINE size_t peek_bits()
     {
-        if (UNLIKELY(valid_bits_ < 8))
+        constexpr auto bit_count{static_cast<int32_t>(BitCount)};
+        static_assert(bit_count <= max_readable_cache_bits);
+
+        if (UNLIKELY(valid_bits_ < bit_count))
         {
             fill_read_cache();
         }
 
-        return read_cache_ >> max_readable_cache_bits;
+        return read_cache_ >> (cache_t_bit_count - bit_count);
+    }
+
+    /// <summary>
+    /// Reads a byte from the bitstream without removing it.
+    /// </summary>
+    FORCE_INLINE size_t peek_byte()
+    {
+        return peek_bits<8>();
     }
 
     FORCE_INLINE uintptr_t read_bit()
@@ -323,13 +417,7 @@ private:
 
     void find_jpeg_marker_start_byte() noexcept
     {
-        // Use memchr to find next start byte (0xFF). memchr is optimized on some platforms to search faster.
-        position_ff_ = static_cast<const std::byte*>(
-            memchr(position_, std::to_integer<int>(jpeg_marker_start_byte), static_cast<size_t>(end_position_ - position_)));
-        if (!position_ff_)
-        {
-            position_ff_ = end_position_;
-        }
+        position_ff_ = ff_byte_index_.find(position_);
     }
 
     void read_restart_marker(const uint32_t expected_restart_marker_id)
@@ -355,9 +443,11 @@ private:
     cache_t read_cache_{};
     int32_t valid_bits_{};
     uint32_t restart_interval_counter_{};
+    const std::byte* scan_begin_{};
     const std::byte* position_{};
     const std::byte* end_position_{};
     const std::byte* position_ff_{};
+    ff_byte_index ff_byte_index_;
 };
 
 } // namespace charls
@@ -20,8 +20,9 @@ public:
 
 protected:
     scan_decoder_core(const charls::frame_info& source_frame_info, const jpegls_pc_parameters& pc_parameters,
-                      const coding_parameters& parameters, const SampleTraits& sample_traits) :
-        scan_decoder{source_frame_info, pc_parameters, parameters}, sample_traits_{sample_traits}
+                      const coding_parameters& parameters, const SampleTraits& sample_traits,
+                      const memory_resource& resource) :
+        scan_decoder{source_frame_info, pc_parameters, parameters, resource}, sample_traits_{sample_traits}
     {
         quantization_ = initialize_quantization_lut(sample_traits_, t1_, t2_, t3_, quantization_lut_);
         initialize_parameters(sample_traits_.range);
@@ -43,7 +44,8 @@ protected:
         const int32_t k{context.compute_golomb_coding_parameter()};
 
         int32_t error_value;
-        if (const golomb_code_match code = golomb_lut[static_cast<size_t>(k)].get(peek_byte()); LIKELY(code.bit_count != 0))
+        if (const golomb_code_match code{golomb_lut[static_cast<size_t>(k)].get(peek_bits<golomb_lut_bit_count>())};
+            LIKELY(code.bit_count != 0))
         {
             // There is a pre-computed match.
             skip_bits(code.bit_count);
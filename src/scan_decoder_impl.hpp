@@ -4,13 +4,14 @@
 #pragma once
 
 #include "color_transform.hpp"
+#include "parallel.hpp"
 #include "sample_traits.hpp"
 #include "scan_decoder_core.hpp"
 
 namespace charls {
 
 template<typename Traits>
-class scan_decoder_impl final : public scan_decoder_core<sample_traits_t<Traits>>
+class scan_decoder_impl : public scan_decoder_core<sample_traits_t<Traits>>
 {
     using base = scan_decoder_core<sample_traits_t<Traits>>;
     using base::decode_regular;
@@ -27,8 +28,17 @@ class scan_decoder_impl final : public scan_decoder_core<sample_traits_t<Traits>
 public:
 
     scan_decoder_impl(const charls::frame_info& source_frame_info, const jpegls_pc_parameters& pc_parameters,
-                      const coding_parameters& parameters, const Traits& traits) :
-        base{source_frame_info, pc_parameters, parameters, make_sample_traits(traits)}, traits_{traits}
+                      const coding_parameters& parameters, const Traits& traits, const memory_resource& resource) :
+        base{source_frame_info, pc_parameters, parameters, make_sample_traits(traits), resource},
+        traits_{traits},
+        // In ILV_SAMPLE mode, multiple components are handled in do_line
+        // In ILV_LINE mode, a call to do_line is made for every component
+        // In ILV_NONE mode, do_scan is called for each component
+        component_count_{parameters.interleave_mode == interleave_mode::line
+                             ? static_cast<size_t>(source_frame_info.component_count)
+                             : 1U},
+        // 2 line slots for the previous and current line and 1 zero line.
+        line_buffer_(component_count_ * (width_ + 2U) * 3, memory_allocator<pixel_type>{resource})
     {
         ASSERT(traits_.is_valid());
 
@@ -36,96 +46,126 @@ public:
             parameters.interleave_mode, source_frame_info.component_count, parameters.transformation);
     }
 
-    [[nodiscard]]
-    size_t decode_scan(const span<const std::byte> source, std::byte* destination, const size_t stride) override
+    void reset() noexcept override
     {
-        const auto* scan_begin{to_address(source.begin())};
+        base::reset();
+        base::initialize_parameters(base::sample_traits_.range);
+        std::fill(run_index_per_component_.begin(), run_index_per_component_.end(), 0);
+        std::fill(line_buffer_.begin(), line_buffer_.end(), pixel_type{});
+        line_ = 0;
+    }
 
-        base::initialize(source);
+    void decode_lines(std::byte* destination, const size_t stride, const uint32_t line_count) override
+    {
+        ASSERT(line_ + line_count <= frame_info().height);
 
-        // Process images without a restart interval, as 1 large restart interval.
-        if (parameters_.restart_interval == 0)
+        if (conversion_thread_ && line_count > 1)
         {
-            parameters_.restart_interval = frame_info().height;
+            // A line can be decoded into its slot when the line that used the slot before has been copied.
+            const uint32_t first_line{line_};
+            pipeline_for(
+                line_count, line_slot_count_, false, [this](size_t) { decode_line(); },
+                [this, destination, stride, first_line](const size_t index) {
+                    base::copy_line_buffer_to_destination(line_slot(first_line + static_cast<uint32_t>(index)) + 1,
+                                                          destination + (index * stride), width_);
+                });
+            return;
         }
 
-        decode_lines(destination, stride);
-        base::end_scan();
-
-        return static_cast<size_t>(base::get_actual_position() - scan_begin);
+        for (const uint32_t end_line{line_ + line_count}; line_ != end_line;)
+        {
+            decode_line();
+            base::copy_line_buffer_to_destination(line_slot(line_ - 1) + 1, destination, width_);
+            destination += stride;
+        }
     }
 
-private:
-    // In ILV_SAMPLE mode, multiple components are handled in do_line
-    // In ILV_LINE mode, a call to do_line is made for every component
-    // In ILV_NONE mode, do_scan is called for each component
-    void decode_lines(std::byte* destination, const size_t stride)
+    void use_conversion_thread(const bool enable) override
     {
-        const uint32_t pixel_stride{width_ + 2U};
-        const size_t component_count{base::parameters().interleave_mode == interleave_mode::line
-                                         ? static_cast<size_t>(frame_info().component_count)
-                                         : 1U};
-
-        std::array<uint32_t, maximum_component_count_in_scan> run_index{};
-        std::vector<pixel_type> line_buffer(component_count * pixel_stride * 2);
+        ASSERT(line_ == 0);
 
-        for (uint32_t line{};;)
+        conversion_thread_ = enable;
+        line_slot_count_ = enable ? pipeline_line_slot_count : 2;
+        if (line_buffer_.size() < (line_slot_count_ + 1) * line_slot_size())
         {
-            const uint32_t lines_in_interval{std::min(frame_info().height - line, parameters_.restart_interval)};
+            line_buffer_.resize((line_slot_count_ + 1) * line_slot_size());
+        }
+        std::fill_n(zero_line(), line_slot_size(), pixel_type{});
+    }
 
-            for (uint32_t mcu{}; mcu < lines_in_interval; ++mcu, ++line)
-            {
-                previous_line_ = line_buffer.data();
-                current_line_ = line_buffer.data() + component_count * pixel_stride;
-                if ((line & 1) == 1)
-                {
-                    std::swap(previous_line_, current_line_);
-                }
-
-                for (size_t component{}; component < component_count; ++component)
-                {
-                    run_index_ = run_index[component];
-
-                    base::initialize_edge_pixels(previous_line_, current_line_, width_);
-
-                    if constexpr (std::is_same_v<pixel_type, sample_type>)
-                    {
-                        decode_sample_line();
-                    }
-                    else if constexpr (std::is_same_v<pixel_type, pair<sample_type>>)
-                    {
-                        decode_pair_line();
-                    }
-                    else if constexpr (std::is_same_v<pixel_type, triplet<sample_type>>)
-                    {
-                        decode_triplet_line();
-                    }
-                    else
-                    {
-                        static_assert(std::is_same_v<pixel_type, quad<sample_type>>);
-                        decode_quad_line();
-                    }
-
-                    run_index[component] = run_index_;
-                    current_line_ += pixel_stride;
-                    previous_line_ += pixel_stride;
-                }
-
-                base::copy_line_buffer_to_destination(current_line_ + 1 - (component_count * pixel_stride), destination,
-                                                      width_);
-                destination += stride;
-            }
+private:
+    // 2 slots for the previous and current line and 2 slots for the lines that are waiting to be copied.
+    static constexpr size_t pipeline_line_slot_count{4};
 
-            if (line == frame_info().height)
-                break;
+    [[nodiscard]]
+    size_t line_slot_size() const noexcept
+    {
+        return component_count_ * (width_ + 2U);
+    }
+
+    [[nodiscard]]
+    pixel_type* line_slot(const uint32_t line) noexcept
+    {
+        return line_buffer_.data() + ((line % line_slot_count_) * line_slot_size());
+    }
+
+    /// <summary>
+    /// Returns the line after the line slots, which is always zero. It is used as the previous line of the first line
+    /// of a restart interval: the slot of the actual previous line may still be waiting to be copied.
+    /// </summary>
+    [[nodiscard]]
+    pixel_type* zero_line() noexcept
+    {
+        return line_buffer_.data() + (line_slot_count_ * line_slot_size());
+    }
 
+    /// <summary>Decodes line_ into its line buffer slot</summary>
+    void decode_line()
+    {
+        previous_line_ = line_slot(line_ + static_cast<uint32_t>(line_slot_count_) - 1);
+        if (line_ != 0 && line_ % parameters_.restart_interval == 0)
+        {
             base::process_restart_marker();
 
             // After a restart marker it is required to reset the decoder.
-            std::fill(run_index.begin(), run_index.end(), 0);
-            std::fill(line_buffer.begin(), line_buffer.end(), pixel_type{});
+            std::fill(run_index_per_component_.begin(), run_index_per_component_.end(), 0);
+            previous_line_ = zero_line();
             base::initialize_parameters(base::sample_traits_.range);
         }
+
+        const size_t pixel_stride{width_ + 2U};
+        current_line_ = line_slot(line_);
+
+        for (size_t component{}; component < component_count_; ++component)
+        {
+            run_index_ = run_index_per_component_[component];
+
+            base::initialize_edge_pixels(previous_line_, current_line_, width_);
+
+            if constexpr (std::is_same_v<pixel_type, sample_type>)
+            {
+                decode_sample_line();
+            }
+            else if constexpr (std::is_same_v<pixel_type, pair<sample_type>>)
+            {
+                decode_pair_line();
+            }
+            else if constexpr (std::is_same_v<pixel_type, triplet<sample_type>>)
+            {
+                decode_triplet_line();
+            }
+            else
+            {
+                static_assert(std::is_same_v<pixel_type, quad<sample_type>>);
+                decode_quad_line();
+            }
+
+            run_index_per_component_[component] = run_index_;
+            current_line_ += pixel_stride;
+            previous_line_ += pixel_stride;
+        }
+
+        ++line_;
     }
 
     /// <summary>Decodes a scan line of samples</summary>
@@ -337,6 +377,12 @@ private:
     }
 
     Traits traits_;
+    size_t component_count_;
+    memory_vector<pixel_type> line_buffer_;
+    size_t line_slot_count_{2};
+    bool conversion_thread_{};
+    std::array<uint32_t, maximum_component_count_in_scan> run_index_per_component_{};
+    uint32_t line_{};
     pixel_type* previous_line_{};
     pixel_type* current_line_{};
 };
@@ -25,12 +25,96 @@ public:
     scan_encoder& operator=(const scan_encoder&) = delete;
     scan_encoder& operator=(scan_encoder&&) = delete;
 
-    virtual size_t encode_scan(const std::byte* source, size_t stride, span<std::byte> destination) = 0;
+    size_t encode_scan(const std::byte* source, const size_t stride, const span<std::byte> destination)
+    {
+        start_scan(destination);
+        encode_lines(source, stride, frame_info().height);
+        return finish_scan();
+    }
+
+    /// <summary>
+    /// Starts encoding a scan. The lines of the scan can then be encoded in one or more calls to encode_lines.
+    /// </summary>
+    /// <param name="destination">The destination for the encoded bytes.</param>
+    /// <param name="first_restart_interval">
+    /// The index of the first restart interval when only a part of a scan is encoded: the RSTm markers are then
+    /// numbered as in the complete scan.
+    /// </param>
+    void start_scan(const span<std::byte> destination, const uint32_t first_restart_interval = 0) noexcept
+    {
+        // Process images without a restart interval, as 1 large restart interval.
+        if (parameters_.restart_interval == 0)
+        {
+            parameters_.restart_interval = frame_info().height;
+        }
+
+        restart_interval_counter_ = first_restart_interval % jpeg_restart_marker_range;
+        initialize(destination);
+    }
+
+    /// <summary>
+    /// Encodes the next line_count lines of the scan. Encoding continues where the previous call stopped.
+    /// </summary>
+    virtual void encode_lines(const std::byte* source, size_t stride, uint32_t line_count) = 0;
+
+    /// <summary>
+    /// Enables copying the source lines to the line buffer (including the color transformation) on a second thread,
+    /// ahead of the encoding of the lines. Needs to be called before the first line of a scan is encoded.
+    /// </summary>
+    virtual void use_conversion_thread(bool enable) = 0;
+
+    /// <summary>
+    /// Writes the remaining bits of the scan and returns the number of bytes written to the destination.
+    /// </summary>
+    [[nodiscard]]
+    size_t finish_scan()
+    {
+        end_scan();
+        return get_length();
+    }
+
+    /// <summary>
+    /// Returns the number of bytes that have been written to the destination so far. These bytes will not change.
+    /// </summary>
+    [[nodiscard]]
+    size_t bytes_written() const noexcept
+    {
+        return bytes_written_;
+    }
+
+    /// <summary>
+    /// Resets the encoder to the state after construction, to encode another scan with the same parameters.
+    /// </summary>
+    virtual void reset() noexcept
+    {
+        is_ff_written_ = false;
+        bytes_written_ = 0;
+        restart_interval_counter_ = 0;
+    }
+
+    /// <summary>
+    /// Returns the number of bytes that are still available in the destination.
+    /// </summary>
+    [[nodiscard]]
+    size_t remaining_destination_size() const noexcept
+    {
+        return compressed_length_;
+    }
+
+    /// <summary>
+    /// Continues writing the encoded bytes to a new destination. The written bytes are not needed anymore.
+    /// </summary>
+    void continue_in(const span<std::byte> destination) noexcept
+    {
+        position_ = destination.data();
+        compressed_length_ = destination.size();
+    }
 
 protected:
     scan_encoder(const charls::frame_info& frame_info, const jpegls_pc_parameters& pc_parameters,
-                 const coding_parameters& parameters, const copy_to_line_buffer_fn copy_to_line_buffer) noexcept :
-        scan_codec(frame_info, pc_parameters, parameters),
+                 const coding_parameters& parameters, const copy_to_line_buffer_fn copy_to_line_buffer,
+                 const memory_resource& resource) noexcept :
+        scan_codec(frame_info, pc_parameters, parameters, resource),
         copy_to_line_buffer_{copy_to_line_buffer},
         mask_{(1U << frame_info.bits_per_sample) - 1}
     {
@@ -43,7 +127,7 @@ protected:
 
     void initialize(const span<std::byte> destination) noexcept
     {
-        free_bit_count_ = sizeof(bit_buffer_) * 8;
+        free_bit_count_ = bit_buffer_bit_count;
         bit_buffer_ = 0;
 
         position_ = destination.data();
@@ -72,10 +156,15 @@ protected:
         }
     }
 
-    void append_to_bit_stream(const uint32_t bits, const int32_t bit_count)
+    /// <summary>
+    /// Appends the bit_count least significant bits of bits to the bit stream.
+    /// A flush of the full 64 bit buffer frees at least 56 bits (7 bits per byte when every byte is 0xFF and needs a
+    /// stuffed bit), which allows to append up to 56 bits with a single flush.
+    /// </summary>
+    void append_to_bit_stream(const uint64_t bits, const int32_t bit_count)
     {
-        ASSERT(0 <= bit_count && bit_count < 32);
-        ASSERT((bits | ((1U << bit_count) - 1U)) == ((1U << bit_count) - 1U)); // Not used bits must be set to zero.
+        ASSERT(0 <= bit_count && bit_count <= maximum_append_bit_count);
+        ASSERT((bits | ((uint64_t{1} << bit_count) - 1U)) == ((uint64_t{1} << bit_count) - 1U)); // Not used bits must be 0.
 
         free_bit_count_ -= bit_count;
         if (free_bit_count_ >= 0)
@@ -88,13 +177,6 @@ protected:
             bit_buffer_ |= bits >> -free_bit_count_;
             flush();
 
-            // A second flush may be required if extra marker detect bits were needed and not all bits could be written.
-            if (free_bit_count_ < 0)
-            {
-                bit_buffer_ |= bits >> -free_bit_count_;
-                flush();
-            }
-
             ASSERT(free_bit_count_ >= 0);
             bit_buffer_ |= bits << free_bit_count_;
         }
@@ -111,63 +193,87 @@ protected:
         }
 
         flush();
-        ASSERT(free_bit_count_ == 32);
+        ASSERT(free_bit_count_ == bit_buffer_bit_count);
     }
 
-    void flush()
+    /// <summary>
+    /// Completes the current restart interval and writes the next RSTm marker (see ISO/IEC 14495-1, C.2.5 and T.81, B.2.1).
+    /// </summary>
+    void write_restart_marker()
     {
-        if (UNLIKELY(compressed_length_ < 4))
+        end_scan();
+
+        if (UNLIKELY(compressed_length_ < 2))
             impl::throw_jpegls_error(jpegls_errc::destination_too_small);
 
-        // Fast path: when the previous byte was not 0xFF and none of the 4 output bytes is 0xFF,
-        // write all 4 bytes directly. This avoids the per-byte loop and FF-state tracking.
-        // This is the common case: ~98.4% of flushes have no 0xFF bytes (1 - (255/256)^4).
-        if (!is_ff_written_ && free_bit_count_ <= 0)
+        position_[0] = jpeg_marker_start_byte;
+        position_[1] = static_cast<std::byte>(jpeg_restart_marker_base + restart_interval_counter_);
+        position_ += 2;
+        compressed_length_ -= 2;
+        bytes_written_ += 2;
+        is_ff_written_ = false;
+
+        restart_interval_counter_ = (restart_interval_counter_ + 1) % jpeg_restart_marker_range;
+    }
+
+    void flush()
+    {
+        // Fast path: when the previous byte was not 0xFF, the bytes up to and including the first 0xFF byte don't
+        // need a stuffed bit and are written with a single 8 byte store. This is the common case: ~96.9% of the
+        // flushes have no 0xFF bytes (1 - (255/256)^8) and write all 8 bytes directly.
+        // Only the bytes after an 0xFF byte are written by the per-byte loop, which inserts the stuffed bits.
+        size_t byte_count{sizeof(bit_buffer_)};
+        if (!is_ff_written_ && free_bit_count_ <= 0 && compressed_length_ >= sizeof(bit_buffer_))
         {
-            const auto b0{static_cast<std::byte>(bit_buffer_ >> 24)};
-            const auto b1{static_cast<std::byte>(bit_buffer_ >> 16)};
-            const auto b2{static_cast<std::byte>(bit_buffer_ >> 8)};
-            const auto b3{static_cast<std::byte>(bit_buffer_)};
+            write_big_endian_unaligned(position_, bit_buffer_);
 
-            if (b0 != jpeg_marker_start_byte && b1 != jpeg_marker_start_byte &&
-                b2 != jpeg_marker_start_byte && b3 != jpeg_marker_start_byte)
+            const uint64_t ff_bytes{ff_byte_mask(bit_buffer_)};
+            if (LIKELY(ff_bytes == 0))
             {
-                position_[0] = b0;
-                position_[1] = b1;
-                position_[2] = b2;
-                position_[3] = b3;
-                position_ += 4;
-                compressed_length_ -= 4;
-                bytes_written_ += 4;
+                advance_position(sizeof(bit_buffer_));
                 bit_buffer_ = 0;
-                free_bit_count_ += 32;
+                free_bit_count_ += bit_buffer_bit_count;
                 return;
             }
+
+            // The bytes after the first 0xFF byte have been written too, but will be overwritten.
+            const auto written_byte_count{static_cast<size_t>(countl_zero(ff_bytes) / 8) + 1};
+            advance_position(written_byte_count);
+            bit_buffer_ = written_byte_count == sizeof(bit_buffer_) ? 0 : bit_buffer_ << (written_byte_count * 8);
+            free_bit_count_ += static_cast<int32_t>(written_byte_count * 8);
+            is_ff_written_ = true;
+            byte_count -= written_byte_count;
         }
 
-        flush_with_ff_handling();
+        flush_with_ff_handling(byte_count);
     }
 
-    void flush_with_ff_handling() noexcept
+    /// <summary>
+    /// Writes at most byte_count bytes of the bit buffer (the bytes it still contains) and inserts the stuffed bits.
+    /// </summary>
+    void flush_with_ff_handling(const size_t byte_count)
     {
-        for (int i{}; i < 4; ++i)
+        for (size_t i{}; i < byte_count; ++i)
         {
-            if (free_bit_count_ >= 32)
+            if (free_bit_count_ >= bit_buffer_bit_count)
             {
-                free_bit_count_ = 32;
+                free_bit_count_ = bit_buffer_bit_count;
                 break;
             }
 
+            if (UNLIKELY(compressed_length_ == 0))
+                impl::throw_jpegls_error(jpegls_errc::destination_too_small);
+
             if (is_ff_written_)
             {
                 // JPEG-LS requirement (T.87, A.1) to detect markers: after a xFF value a single 0 bit needs to be inserted.
-                *position_ = static_cast<std::byte>(bit_buffer_ >> 25);
+                *position_ = static_cast<std::byte>(bit_buffer_ >> 57);
                 bit_buffer_ = bit_buffer_ << 7;
                 free_bit_count_ += 7;
             }
             else
             {
-                *position_ = static_cast<std::byte>(bit_buffer_ >> 24);
+                *position_ = static_cast<std::byte>(bit_buffer_ >> 56);
                 bit_buffer_ = bit_buffer_ << 8;
                 free_bit_count_ += 8;
             }
@@ -182,19 +288,29 @@ protected:
     [[nodiscard]]
     size_t get_length() const noexcept
     {
-        return bytes_written_ - (static_cast<size_t>(free_bit_count_) - 32U) / 8U;
+        return bytes_written_ - (static_cast<size_t>(free_bit_count_) - bit_buffer_bit_count) / 8U;
     }
 
     FORCE_INLINE void append_ones_to_bit_stream(const int32_t bit_count)
     {
-        append_to_bit_stream((1U << bit_count) - 1U, bit_count);
+        append_to_bit_stream((uint64_t{1} << bit_count) - 1U, bit_count);
     }
 
+    static constexpr int32_t bit_buffer_bit_count{64};
+    static constexpr int32_t maximum_append_bit_count{56};
+
     copy_to_line_buffer_fn copy_to_line_buffer_{};
 
 private:
-    unsigned int bit_buffer_{};
-    int32_t free_bit_count_{sizeof bit_buffer_ * 8};
+    void advance_position(const size_t byte_count) noexcept
+    {
+        position_ += byte_count;
+        compressed_length_ -= byte_count;
+        bytes_written_ += byte_count;
+    }
+
+    uint64_t bit_buffer_{};
+    int32_t free_bit_count_{bit_buffer_bit_count};
     size_t compressed_length_{};
     uint32_t mask_;
 
@@ -202,6 +318,7 @@ private:
     std::byte* position_{};
     bool is_ff_written_{};
     size_t bytes_written_{};
+    uint32_t restart_interval_counter_{};
 };
 
 } // namespace charls
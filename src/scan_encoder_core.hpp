@@ -22,8 +22,9 @@ public:
 protected:
     scan_encoder_core(const charls::frame_info& source_frame_info, const jpegls_pc_parameters& pc_parameters,
                       const coding_parameters& parameters, const copy_to_line_buffer_fn copy_to_line_buffer,
-                      const SampleTraits& sample_traits) :
-        scan_encoder{source_frame_info, pc_parameters, parameters, copy_to_line_buffer}, sample_traits_{sample_traits}
+                      const SampleTraits& sample_traits, const memory_resource& resource) :
+        scan_encoder{source_frame_info, pc_parameters, parameters, copy_to_line_buffer, resource},
+        sample_traits_{sample_traits}
     {
         quantization_ = initialize_quantization_lut(sample_traits_, t1_, t2_, t3_, quantization_lut_);
         initialize_parameters(sample_traits_.range);
@@ -68,38 +69,36 @@ protected:
 
     FORCE_INLINE void encode_mapped_value(const int32_t k, const int32_t mapped_error, const int32_t limit)
     {
-        if (int32_t high_bits{mapped_error >> k}; high_bits < limit - sample_traits_.quantized_bits_per_sample - 1)
+        const int32_t quantized_bits_per_sample{sample_traits_.quantized_bits_per_sample};
+        if (const int32_t high_bits{mapped_error >> k}; high_bits < limit - quantized_bits_per_sample - 1)
         {
-            if (high_bits + 1 > 31)
+            // Merge unary prefix (high_bits zeros + 1) and k-bit remainder into a single call.
+            // Only the longest codes of images with more than 12 bits per sample need 2 calls.
+            const uint64_t code{(uint64_t{1} << k) | static_cast<uint64_t>(mapped_error & ((1 << k) - 1))};
+            if (const int32_t total_bits{high_bits + 1 + k}; LIKELY(total_bits <= maximum_append_bit_count))
             {
-                append_to_bit_stream(0, high_bits / 2);
-                high_bits = high_bits - high_bits / 2;
-            }
-            if (const int32_t total_bits{high_bits + 1 + k}; total_bits < 32)
-            {
-                // Merge unary prefix (high_bits zeros + 1) and k-bit remainder into a single call.
-                append_to_bit_stream((1U << k) | static_cast<uint32_t>(mapped_error & ((1 << k) - 1)), total_bits);
+                append_to_bit_stream(code, total_bits);
             }
             else
             {
-                append_to_bit_stream(1, high_bits + 1);
-                append_to_bit_stream(static_cast<uint32_t>(mapped_error & ((1 << k) - 1)), k);
+                append_to_bit_stream(0, high_bits);
+                append_to_bit_stream(code, k + 1);
             }
             return;
         }
 
-        if (limit - sample_traits_.quantized_bits_per_sample > 31)
+        // Escape code: limit - qbpp - 1 zeros, a 1 and the value mapped_error - 1 in qbpp bits: limit bits in total.
+        const uint64_t code{(uint64_t{1} << quantized_bits_per_sample) |
+                            static_cast<uint64_t>((mapped_error - 1) & ((1 << quantized_bits_per_sample) - 1))};
+        if (limit <= maximum_append_bit_count)
         {
-            append_to_bit_stream(0, 31);
-            append_to_bit_stream(1, limit - sample_traits_.quantized_bits_per_sample - 31);
+            append_to_bit_stream(code, limit);
         }
         else
         {
-            append_to_bit_stream(1, limit - sample_traits_.quantized_bits_per_sample);
+            append_to_bit_stream(0, limit - quantized_bits_per_sample - 1);
+            append_to_bit_stream(code, quantized_bits_per_sample + 1);
         }
-        append_to_bit_stream(
-            static_cast<uint32_t>((mapped_error - 1) & ((1 << sample_traits_.quantized_bits_per_sample) - 1)),
-            sample_traits_.quantized_bits_per_sample);
     }
 
     void encode_run_interruption_error(run_mode_context& context, const int32_t error_value)
@@ -5,18 +5,20 @@
 
 #include "coding_parameters.hpp"
 #include "jpegls_algorithm.hpp"
+#include "parallel.hpp"
 #include "sample_traits.hpp"
 #include "scan_encoder_core.hpp"
 
 namespace charls {
 
 template<typename Traits>
-class scan_encoder_impl final : public scan_encoder_core<sample_traits_t<Traits>>
+class scan_encoder_impl : public scan_encoder_core<sample_traits_t<Traits>>
 {
     using base = scan_encoder_core<sample_traits_t<Traits>>;
     using base::encode_regular;
     using base::encode_run_interruption_component;
     using base::frame_info;
+    using base::parameters_;
     using base::quantize_gradient;
     using base::run_index_;
     using base::width_;
@@ -27,82 +29,135 @@ class scan_encoder_impl final : public scan_encoder_core<sample_traits_t<Traits>
 public:
 
     scan_encoder_impl(const charls::frame_info& source_frame_info, const jpegls_pc_parameters& pc_parameters,
-                      const coding_parameters& parameters, const Traits& traits) :
+                      const coding_parameters& parameters, const Traits& traits, const memory_resource& resource) :
         base{source_frame_info, pc_parameters, parameters,
              copy_to_line_buffer<sample_type>::get_copy_function(parameters.interleave_mode,
                                                                  source_frame_info.component_count,
                                                                  source_frame_info.bits_per_sample,
                                                                  parameters.transformation),
-             make_sample_traits(traits)},
-        traits_{traits}
+             make_sample_traits(traits), resource},
+        traits_{traits},
+        // In ILV_SAMPLE mode, multiple components are handled in do_line
+        // In ILV_LINE mode, a call to do_line is made for every component
+        // In ILV_NONE mode, do_scan is called for each component
+        component_count_{parameters.interleave_mode == interleave_mode::line
+                             ? static_cast<size_t>(source_frame_info.component_count)
+                             : 1U},
+        line_buffer_(component_count_ * (width_ + 2U) * 2, memory_allocator<pixel_type>{resource})
     {
         ASSERT(traits_.is_valid());
     }
 
-    size_t encode_scan(const std::byte* source, const size_t stride, const span<std::byte> destination) override
+    void reset() noexcept override
     {
-        base::initialize(destination);
-        encode_lines(source, stride);
-        base::end_scan();
+        base::reset();
+        base::initialize_parameters(base::sample_traits_.range);
+        std::fill(run_index_per_component_.begin(), run_index_per_component_.end(), 0);
+        std::fill(line_buffer_.begin(), line_buffer_.end(), pixel_type{});
+        line_ = 0;
+    }
+
+    void encode_lines(const std::byte* source, const size_t stride, const uint32_t line_count) override
+    {
+        ASSERT(line_ + line_count <= frame_info().height);
+
+        if (conversion_thread_ && line_count > 1)
+        {
+            // The source line can be copied to its slot when the slot is not used anymore as previous line.
+            const uint32_t first_line{line_};
+            pipeline_for(
+                line_count, line_slot_count_ - 1, true,
+                [this, source, stride, first_line](const size_t index) {
+                    base::copy_source_to_line_buffer(source + (index * stride),
+                                                     line_slot(first_line + static_cast<uint32_t>(index)) + 1, width_);
+                },
+                [this](size_t) { encode_line(); });
+            return;
+        }
+
+        for (const uint32_t end_line{line_ + line_count}; line_ != end_line;)
+        {
+            base::copy_source_to_line_buffer(source, line_slot(line_) + 1, width_);
+            source = source + stride;
+            encode_line();
+        }
+    }
+
+    void use_conversion_thread(const bool enable) override
+    {
+        ASSERT(line_ == 0);
 
-        return base::get_length();
+        conversion_thread_ = enable;
+        line_slot_count_ = enable ? pipeline_line_slot_count : 2;
+        if (line_buffer_.size() < line_slot_count_ * line_slot_size())
+        {
+            line_buffer_.resize(line_slot_count_ * line_slot_size());
+        }
     }
 
 private:
-    // In ILV_SAMPLE mode, multiple components are handled in do_line
-    // In ILV_LINE mode, a call to do_line is made for every component
-    // In ILV_NONE mode, do_scan is called for each component
-    void encode_lines(const std::byte* source, const size_t stride)
+    // 2 slots for the previous and current line and 2 slots for the lines that are copied ahead.
+    static constexpr size_t pipeline_line_slot_count{4};
+
+    [[nodiscard]]
+    size_t line_slot_size() const noexcept
     {
-        const uint32_t pixel_stride{width_ + 2U};
-        const size_t component_count{base::parameters().interleave_mode == interleave_mode::line
-                                         ? static_cast<size_t>(frame_info().component_count)
-                                         : 1U};
+        return component_count_ * (width_ + 2U);
+    }
 
-        std::array<uint32_t, maximum_component_count_in_scan> run_index{};
-        std::vector<pixel_type> line_buffer(component_count * pixel_stride * 2);
+    [[nodiscard]]
+    pixel_type* line_slot(const uint32_t line) noexcept
+    {
+        return line_buffer_.data() + ((line % line_slot_count_) * line_slot_size());
+    }
 
-        for (uint32_t line{}; line < frame_info().height; ++line)
+    /// <summary>Encodes the line that has been copied to the line buffer slot of line_</summary>
+    void encode_line()
+    {
+        if (line_ != 0 && line_ % parameters_.restart_interval == 0)
         {
-            previous_line_ = line_buffer.data();
-            current_line_ = line_buffer.data() + static_cast<size_t>(component_count) * pixel_stride;
-            if ((line & 1) == 1)
-            {
-                std::swap(previous_line_, current_line_);
-            }
+            base::write_restart_marker();
 
-            base::copy_source_to_line_buffer(source, current_line_ + 1, width_);
-            source = source + stride;
+            // After a restart marker it is required to reset the encoder (mirrors the decoder).
+            std::fill(run_index_per_component_.begin(), run_index_per_component_.end(), 0);
+            std::fill_n(line_slot(line_ - 1), line_slot_size(), pixel_type{});
+            base::initialize_parameters(base::sample_traits_.range);
+        }
 
-            for (size_t component{}; component < component_count; ++component)
-            {
-                run_index_ = run_index[component];
+        const size_t pixel_stride{width_ + 2U};
+        previous_line_ = line_slot(line_ + static_cast<uint32_t>(line_slot_count_) - 1);
+        current_line_ = line_slot(line_);
 
-                base::initialize_edge_pixels(previous_line_, current_line_, width_);
+        for (size_t component{}; component < component_count_; ++component)
+        {
+            run_index_ = run_index_per_component_[component];
 
-                if constexpr (std::is_same_v<pixel_type, sample_type>)
-                {
-                    encode_sample_line();
-                }
-                else if constexpr (std::is_same_v<pixel_type, pair<sample_type>>)
-                {
-                    encode_pair_line();
-                }
-                else if constexpr (std::is_same_v<pixel_type, triplet<sample_type>>)
-                {
-                    encode_triplet_line();
-                }
-                else
-                {
-                    static_assert(std::is_same_v<pixel_type, quad<sample_type>>);
-                    encode_quad_line();
-                }
+            base::initialize_edge_pixels(previous_line_, current_line_, width_);
 
-                run_index[component] = run_index_;
-                previous_line_ += pixel_stride;
-                current_line_ += pixel_stride;
+            if constexpr (std::is_same_v<pixel_type, sample_type>)
+            {
+                encode_sample_line();
+            }
+            else if constexpr (std::is_same_v<pixel_type, pair<sample_type>>)
+            {
+                encode_pair_line();
+            }
+            else if constexpr (std::is_same_v<pixel_type, triplet<sample_type>>)
+            {
+                encode_triplet_line();
             }
+            else
+            {
+                static_assert(std::is_same_v<pixel_type, quad<sample_type>>);
+                encode_quad_line();
+            }
+
+            run_index_per_component_[component] = run_index_;
+            previous_line_ += pixel_stride;
+            current_line_ += pixel_stride;
         }
+
+        ++line_;
     }
 
     /// <summary>Encodes a scan line of samples</summary>
@@ -304,6 +359,12 @@ private:
     using base::encode_run_interruption_pixel;
 
     Traits traits_;
+    size_t component_count_;
+    memory_vector<pixel_type> line_buffer_;
+    size_t line_slot_count_{2};
+    bool conversion_thread_{};
+    std::array<uint32_t, maximum_component_count_in_scan> run_index_per_component_{};
+    uint32_t line_{};
     pixel_type* previous_line_{};
     pixel_type* current_line_{};
 };
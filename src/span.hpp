@@ -88,6 +88,13 @@ public:
         return data_ + size_;
     }
 
+    [[nodiscard]]
+    constexpr T& operator[](const size_t index) const noexcept
+    {
+        ASSERT(index < size_);
+        return data_[index];
+    }
+
     [[nodiscard]]
     constexpr bool empty() const noexcept
     {
@@ -221,6 +221,18 @@ T read_big_endian_unaligned(const std::byte* buffer) noexcept
 }
 
 
+template<typename T>
+void write_big_endian_unaligned(std::byte* buffer, const T value) noexcept
+{
+#ifdef LITTLE_ENDIAN_ARCHITECTURE
+    const T big_endian_value{byte_swap(value)};
+#else
+    const T big_endian_value{value};
+#endif
+    memcpy(buffer, &big_endian_value, sizeof(T));
+}
+
+
 template<typename T>
 [[nodiscard]]
 T* check_pointer(T* pointer)
@@ -318,6 +330,32 @@ inline int countl_zero(const uint32_t value) noexcept
 
     return static_cast<int>(31U - index);
 }
+
+#if !defined(_M_X64) && !defined(_M_ARM64)
+/// <summary>
+/// Custom implementation of C++20 std::countl_zero (for uint64_t on 32-bit platforms)
+/// </summary>
+[[nodiscard]]
+inline int countl_zero(const uint64_t value) noexcept
+{
+    const auto high{static_cast<uint32_t>(value >> 32)};
+    return high == 0 ? 32 + countl_zero(static_cast<uint32_t>(value)) : countl_zero(high);
+}
+#endif
+
+/// <summary>
+/// Custom implementation of C++20 std::countr_zero (for uint32_t)
+/// </summary>
+[[nodiscard]]
+inline int countr_zero(const uint32_t value) noexcept
+{
+    if (value == 0)
+        return 32;
+
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return static_cast<int>(index);
+}
 #endif
 
 #ifdef __GNUC__
@@ -350,9 +388,34 @@ auto countl_zero(const T value) noexcept -> std::enable_if_t<is_uint_v<32, T>, i
     return __builtin_clz(value);
 }
 
+/// <summary>
+/// Custom implementation of C++20 std::countr_zero (for uint32_t)
+/// </summary>
+template<typename T>
+[[nodiscard]]
+auto countr_zero(const T value) noexcept -> std::enable_if_t<is_uint_v<32, T>, int>
+{
+    if (value == 0)
+        return 32;
+
+    return __builtin_ctz(value);
+}
+
 #endif
 
 
+/// <summary>
+/// Returns a mask with the most significant bit set of every byte of the value that is 0xFF.
+/// The computation is exact for every byte as no carry can propagate between the bytes (SWAR).
+/// </summary>
+[[nodiscard]]
+constexpr uint64_t ff_byte_mask(const uint64_t value) noexcept
+{
+    constexpr uint64_t low_7_bits{0x7F7F'7F7F'7F7F'7F7F};
+    return value & ((value & low_7_bits) + 0x0101'0101'0101'0101) & ~low_7_bits;
+}
+
+
 // Replacement for std::ckd_mul (will be introduced in C++26, but has a different API)
 [[nodiscard]]
 inline size_t checked_mul(const size_t a, const size_t b)
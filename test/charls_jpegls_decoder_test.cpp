@@ -66,6 +66,19 @@ TEST(charls_jpegls_decoder_test, set_source_buffer_nullptr)
     EXPECT_EQ(jpegls_errc::invalid_argument, error);
 }
 
+TEST(charls_jpegls_decoder_test, append_source_buffer_nullptr)
+{
+    constexpr array<byte, 10> buffer{};
+
+    auto error{charls_jpegls_decoder_append_source_buffer(nullptr, buffer.data(), buffer.size())};
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    auto* const decoder{charls_jpegls_decoder_create()};
+    error = charls_jpegls_decoder_append_source_buffer(decoder, nullptr, buffer.size());
+    charls_jpegls_decoder_destroy(decoder);
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+}
+
 TEST(charls_jpegls_decoder_test, read_spiff_header_nullptr)
 {
     charls_spiff_header spiff_header{};
@@ -89,6 +102,18 @@ TEST(charls_jpegls_decoder_test, read_spiff_header_nullptr)
     charls_jpegls_decoder_destroy(decoder);
 }
 
+TEST(charls_jpegls_decoder_test, set_thread_count_nullptr)
+{
+    const auto error{charls_jpegls_decoder_set_thread_count(nullptr, 2)};
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+}
+
+TEST(charls_jpegls_decoder_test, reset_nullptr)
+{
+    const auto error{charls_jpegls_decoder_reset(nullptr)};
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+}
+
 TEST(charls_jpegls_decoder_test, read_header_nullptr)
 {
     const auto error{charls_jpegls_decoder_read_header(nullptr)};
@@ -174,6 +199,66 @@ TEST(charls_jpegls_decoder_test, decode_to_buffer_nullptr)
     charls_jpegls_decoder_destroy(decoder);
 }
 
+TEST(charls_jpegls_decoder_test, decode_available_to_buffer_nullptr)
+{
+    array<byte, 5> buffer{};
+    uint32_t decoded_line_count;
+    auto error{charls_jpegls_decoder_decode_available_to_buffer(nullptr, buffer.data(), buffer.size(), 0,
+                                                                 &decoded_line_count)};
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    auto* decoder{charls_jpegls_decoder_create()};
+    error = charls_jpegls_decoder_decode_available_to_buffer(decoder, nullptr, buffer.size(), 0, &decoded_line_count);
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    error = charls_jpegls_decoder_decode_available_to_buffer(decoder, buffer.data(), buffer.size(), 0, nullptr);
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    charls_jpegls_decoder_destroy(decoder);
+}
+
+TEST(charls_jpegls_decoder_test, decode_to_line_handler_nullptr)
+{
+    const auto handler{[](const void*, size_t, uint32_t, uint32_t, uint32_t, void*) noexcept -> int32_t { return 0; }};
+    auto error{charls_jpegls_decoder_decode_to_line_handler(nullptr, 1, handler, nullptr)};
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    auto* decoder{charls_jpegls_decoder_create()};
+    error = charls_jpegls_decoder_decode_to_line_handler(decoder, 1, nullptr, nullptr);
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    error = charls_jpegls_decoder_decode_to_line_handler(decoder, 0, handler, nullptr);
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    charls_jpegls_decoder_destroy(decoder);
+}
+
+TEST(charls_jpegls_decoder_test, decode_rect_nullptr)
+{
+    array<byte, 5> buffer{};
+    auto error{charls_jpegls_decoder_decode_rect(nullptr, 0, 0, 1, 1, buffer.data(), buffer.size(), 0)};
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    auto* decoder{charls_jpegls_decoder_create()};
+    error = charls_jpegls_decoder_decode_rect(decoder, 0, 0, 1, 1, nullptr, buffer.size(), 0);
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    charls_jpegls_decoder_destroy(decoder);
+}
+
+TEST(charls_jpegls_decoder_test, decode_batch_nullptr)
+{
+    array<charls_batch_item, 1> items{};
+    auto error{charls_jpegls_decoder_decode_batch(nullptr, items.data(), items.size())};
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    auto* decoder{charls_jpegls_decoder_create()};
+    error = charls_jpegls_decoder_decode_batch(decoder, nullptr, items.size());
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    charls_jpegls_decoder_destroy(decoder);
+}
+
 TEST(charls_jpegls_decoder_test, read_header_from_zero_size_buffer)
 {
     auto* decoder{charls_jpegls_decoder_create()};
@@ -255,6 +340,33 @@ TEST(charls_jpegls_decoder_test, charls_decoder_get_mapping_table_info_nullptr)
     EXPECT_EQ(jpegls_errc::invalid_argument, error);
 }
 
+TEST(charls_jpegls_decoder_test, create_with_allocator_nullptr)
+{
+    allocation_statistics statistics;
+    EXPECT_EQ(nullptr, charls_jpegls_decoder_create_with_allocator(nullptr, counting_deallocate, &statistics));
+    EXPECT_EQ(nullptr, charls_jpegls_decoder_create_with_allocator(counting_allocate, nullptr, &statistics));
+    EXPECT_EQ(size_t{}, statistics.allocation_count);
+}
+
+TEST(charls_jpegls_decoder_test, create_with_failing_allocator)
+{
+    allocation_statistics statistics;
+    statistics.allocation_limit = 0;
+    EXPECT_EQ(nullptr, charls_jpegls_decoder_create_with_allocator(counting_allocate, counting_deallocate, &statistics));
+}
+
+TEST(charls_jpegls_decoder_test, create_with_allocator_and_destroy)
+{
+    allocation_statistics statistics;
+    charls_jpegls_decoder* decoder{charls_jpegls_decoder_create_with_allocator(counting_allocate, counting_deallocate,
+                                                                             &statistics)};
+    ASSERT_NE(nullptr, decoder);
+    EXPECT_EQ(size_t{1}, statistics.allocation_count);
+
+    charls_jpegls_decoder_destroy(decoder);
+    EXPECT_EQ(size_t{}, statistics.allocated_size);
+}
+
 } // namespace charls::test
 
 #ifdef __GNUC__
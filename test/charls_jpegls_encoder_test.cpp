@@ -83,6 +83,18 @@ TEST(charls_jpegls_encoder_test, set_color_transformation_nullptr)
     EXPECT_EQ(jpegls_errc::invalid_argument, error);
 }
 
+TEST(charls_jpegls_encoder_test, set_restart_interval_nullptr)
+{
+    const auto error{charls_jpegls_encoder_set_restart_interval(nullptr, 7)};
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+}
+
+TEST(charls_jpegls_encoder_test, set_thread_count_nullptr)
+{
+    const auto error{charls_jpegls_encoder_set_thread_count(nullptr, 2)};
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+}
+
 TEST(charls_jpegls_encoder_test, charls_jpegls_encoder_set_table_id_nullptr)
 {
     const auto error{charls_jpegls_encoder_set_mapping_table_id(nullptr, 0, 0)};
@@ -130,6 +142,54 @@ TEST(charls_jpegls_encoder_test, encode_from_buffer_nullptr)
     EXPECT_EQ(jpegls_errc::invalid_argument, error);
 }
 
+TEST(charls_jpegls_encoder_test, get_estimated_tiles_destination_size_nullptr)
+{
+    size_t size_in_bytes{};
+    auto error{charls_jpegls_encoder_get_estimated_tiles_destination_size(nullptr, 1, 1, &size_in_bytes)};
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    charls_jpegls_encoder* const encoder{charls_jpegls_encoder_create()};
+
+    constexpr charls_frame_info frame_info{1, 1, 2, 1};
+    error = charls_jpegls_encoder_set_frame_info(encoder, &frame_info);
+    EXPECT_EQ(jpegls_errc::success, error);
+
+    error = charls_jpegls_encoder_get_estimated_tiles_destination_size(encoder, 1, 1, nullptr);
+    charls_jpegls_encoder_destroy(encoder);
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+}
+
+TEST(charls_jpegls_encoder_test, encode_tiles_from_buffer_nullptr)
+{
+    constexpr array<byte, 10> source_buffer{};
+    array<charls_tile_info, 1> tiles{};
+    auto error{charls_jpegls_encoder_encode_tiles_from_buffer(nullptr, source_buffer.data(), source_buffer.size(), 0, 1,
+                                                              1, tiles.data(), tiles.size())};
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    auto* const encoder{charls_jpegls_encoder_create()};
+    error = charls_jpegls_encoder_encode_tiles_from_buffer(encoder, nullptr, source_buffer.size(), 0, 1, 1, tiles.data(),
+                                                           tiles.size());
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    error = charls_jpegls_encoder_encode_tiles_from_buffer(encoder, source_buffer.data(), source_buffer.size(), 0, 1, 1,
+                                                           nullptr, tiles.size());
+    charls_jpegls_encoder_destroy(encoder);
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+}
+
+TEST(charls_jpegls_encoder_test, encode_batch_nullptr)
+{
+    array<charls_batch_item, 1> items{};
+    auto error{charls_jpegls_encoder_encode_batch(nullptr, items.data(), items.size())};
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    auto* const encoder{charls_jpegls_encoder_create()};
+    error = charls_jpegls_encoder_encode_batch(encoder, nullptr, items.size());
+    charls_jpegls_encoder_destroy(encoder);
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+}
+
 TEST(charls_jpegls_encoder_test, encode_components_from_buffer_nullptr)
 {
     constexpr array<byte, 10> source_buffer{};
@@ -143,6 +203,30 @@ TEST(charls_jpegls_encoder_test, encode_components_from_buffer_nullptr)
     EXPECT_EQ(jpegls_errc::invalid_argument, error);
 }
 
+TEST(charls_jpegls_encoder_test, set_destination_handler_nullptr)
+{
+    auto error{charls_jpegls_encoder_set_destination_handler(
+        nullptr, [](const void*, size_t, void*) noexcept -> int32_t { return 0; }, nullptr)};
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    auto* const encoder{charls_jpegls_encoder_create()};
+    error = charls_jpegls_encoder_set_destination_handler(encoder, nullptr, nullptr);
+    charls_jpegls_encoder_destroy(encoder);
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+}
+
+TEST(charls_jpegls_encoder_test, encode_lines_from_buffer_nullptr)
+{
+    constexpr array<byte, 10> source_buffer{};
+    auto error{charls_jpegls_encoder_encode_lines_from_buffer(nullptr, source_buffer.data(), source_buffer.size(), 1, 0)};
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+
+    auto* const encoder{charls_jpegls_encoder_create()};
+    error = charls_jpegls_encoder_encode_lines_from_buffer(encoder, nullptr, source_buffer.size(), 1, 0);
+    charls_jpegls_encoder_destroy(encoder);
+    EXPECT_EQ(jpegls_errc::invalid_argument, error);
+}
+
 TEST(charls_jpegls_encoder_test, write_spiff_header_nullptr)
 {
     constexpr charls_spiff_header spiff_header{};
@@ -248,6 +332,33 @@ TEST(charls_jpegls_encoder_test, create_tables_only_null_ptr)
     EXPECT_EQ(jpegls_errc::invalid_argument, error);
 }
 
+TEST(charls_jpegls_encoder_test, create_with_allocator_nullptr)
+{
+    allocation_statistics statistics;
+    EXPECT_EQ(nullptr, charls_jpegls_encoder_create_with_allocator(nullptr, counting_deallocate, &statistics));
+    EXPECT_EQ(nullptr, charls_jpegls_encoder_create_with_allocator(counting_allocate, nullptr, &statistics));
+    EXPECT_EQ(size_t{}, statistics.allocation_count);
+}
+
+TEST(charls_jpegls_encoder_test, create_with_failing_allocator)
+{
+    allocation_statistics statistics;
+    statistics.allocation_limit = 0;
+    EXPECT_EQ(nullptr, charls_jpegls_encoder_create_with_allocator(counting_allocate, counting_deallocate, &statistics));
+}
+
+TEST(charls_jpegls_encoder_test, create_with_allocator_and_destroy)
+{
+    allocation_statistics statistics;
+    charls_jpegls_encoder* encoder{charls_jpegls_encoder_create_with_allocator(counting_allocate, counting_deallocate,
+                                                                             &statistics)};
+    ASSERT_NE(nullptr, encoder);
+    EXPECT_EQ(size_t{1}, statistics.allocation_count);
+
+    charls_jpegls_encoder_destroy(encoder);
+    EXPECT_EQ(size_t{}, statistics.allocated_size);
+}
+
 } // namespace charls::test
 
 #ifdef __GNUC__
@@ -8,6 +8,7 @@
 #include <charls/charls.hpp>
 #include <support/portable_anymap_file.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstdlib>
@@ -37,6 +38,39 @@ void compare_buffers(const byte* buffer1, const size_t size1, const byte* buffer
     }
 }
 
+void encode_with_restart_interval_and_compare_entropy_data(const char* encoded_filename, const char* raw_filename,
+                                                           const uint32_t restart_interval)
+{
+    // The reference files have been created by another encoder: the headers are different, but the
+    // encoded entropy data (including the RSTm markers) should be identical.
+    const auto encoded_source{read_file(encoded_filename)};
+    const jpegls_decoder decoder{encoded_source, true};
+    const portable_anymap_file reference_file{
+        read_anymap_reference_file(raw_filename, decoder.get_interleave_mode(), decoder.frame_info())};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(decoder.frame_info())
+        .interleave_mode(decoder.get_interleave_mode())
+        .restart_interval(restart_interval);
+    vector<byte> destination(encoder.estimated_destination_size());
+    encoder.destination(destination);
+    destination.resize(encoder.encode(reference_file.image_data()));
+
+    constexpr array start_of_scan{byte{0xFF}, byte{0xDA}};
+    const auto reference_scan{
+        std::search(encoded_source.cbegin(), encoded_source.cend(), start_of_scan.cbegin(), start_of_scan.cend())};
+    const auto scan{std::search(destination.cbegin(), destination.cend(), start_of_scan.cbegin(), start_of_scan.cend())};
+    ASSERT_NE(encoded_source.cend(), reference_scan);
+    ASSERT_NE(destination.cend(), scan);
+
+    const auto segment_size{(std::to_integer<size_t>(scan[2]) << 8) + std::to_integer<size_t>(scan[3])};
+    const auto entropy_data_offset{2 + segment_size};
+    compare_buffers(&*reference_scan + entropy_data_offset,
+                    static_cast<size_t>(encoded_source.cend() - reference_scan) - entropy_data_offset,
+                    &*scan + entropy_data_offset,
+                    static_cast<size_t>(destination.cend() - scan) - entropy_data_offset);
+}
+
 } // namespace
 
 
@@ -140,6 +174,21 @@ TEST(compliance_test, decode_monochrome_16_bit_restart_5)
     decode_encode_file("data/test16_rm_5.jls", "data/test16.pgm", false);
 }
 
+TEST(compliance_test, encode_color_8_bit_interleave_line_lossless_restart_7)
+{
+    encode_with_restart_interval_and_compare_entropy_data("data/test8_ilv_line_rm_7.jls", "data/test8.ppm", 7);
+}
+
+TEST(compliance_test, encode_color_8_bit_interleave_sample_lossless_restart_300)
+{
+    encode_with_restart_interval_and_compare_entropy_data("data/test8_ilv_sample_rm_300.jls", "data/test8.ppm", 300);
+}
+
+TEST(compliance_test, encode_monochrome_16_bit_restart_5)
+{
+    encode_with_restart_interval_and_compare_entropy_data("data/test16_rm_5.jls", "data/test16.pgm", 5);
+}
+
 TEST(compliance_test, decode_mapping_table_sample_annex_h4_5)
 {
     // ISO 14495-1: Sample image from appendix H.4.5 "Example of a palletised image" / Figure H.10
@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: © 2026 Team CharLS
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "pch.hpp"
+
+#include "../src/copy_from_line_buffer.hpp"
+#include "../src/copy_to_line_buffer.hpp"
+
+#include <random>
+#include <vector>
+
+using std::vector;
+
+namespace charls::test {
+
+namespace {
+
+constexpr std::array pixel_counts{size_t{1}, size_t{15}, size_t{16}, size_t{17}, size_t{31}, size_t{32}, size_t{33},
+                                  size_t{100}, size_t{257}};
+
+vector<uint8_t> create_random_samples(const size_t count)
+{
+    std::mt19937 generator(static_cast<std::mt19937::result_type>(count));
+    std::uniform_int_distribution<uint32_t> distribution(0, 255);
+
+    vector<uint8_t> samples(count);
+    for (auto& sample : samples)
+    {
+        sample = static_cast<uint8_t>(distribution(generator));
+    }
+
+    return samples;
+}
+
+template<typename Transform>
+triplet<uint8_t> forward(const uint8_t red, const uint8_t green, const uint8_t blue) noexcept
+{
+    if constexpr (std::is_same_v<Transform, void>)
+        return {red, green, blue};
+    else
+        return Transform{}(red, green, blue);
+}
+
+template<typename Transform>
+triplet<uint8_t> inverse(const uint8_t v1, const uint8_t v2, const uint8_t v3) noexcept
+{
+    if constexpr (std::is_same_v<Transform, void>)
+        return {v1, v2, v3};
+    else
+        return typename Transform::inverse{}(v1, v2, v3);
+}
+
+template<typename Transform>
+void check_copy_to_line_buffer(const interleave_mode interleave_mode, const color_transformation color_transformation,
+                               const int32_t bits_per_sample = 8)
+{
+    const auto copy_function{
+        copy_to_line_buffer<uint8_t>::get_copy_function(interleave_mode, 3, bits_per_sample, color_transformation)};
+    const auto mask{static_cast<uint8_t>((1U << bits_per_sample) - 1)};
+
+    for (const size_t pixel_count : pixel_counts)
+    {
+        const vector<uint8_t> source{create_random_samples(pixel_count * 3)};
+        const size_t pixel_stride{pixel_count_to_pixel_stride(pixel_count)};
+        vector<uint8_t> destination(pixel_stride * 3);
+        copy_function(source.data(), destination.data(), pixel_count, mask);
+
+        for (size_t i{}; i != pixel_count; ++i)
+        {
+            const auto expected{forward<Transform>(static_cast<uint8_t>(source[i * 3] & mask),
+                                                   static_cast<uint8_t>(source[(i * 3) + 1] & mask),
+                                                   static_cast<uint8_t>(source[(i * 3) + 2] & mask))};
+            if (interleave_mode == interleave_mode::line)
+            {
+                ASSERT_EQ(expected.v1, destination[i]);
+                ASSERT_EQ(expected.v2, destination[i + pixel_stride]);
+                ASSERT_EQ(expected.v3, destination[i + (2 * pixel_stride)]);
+            }
+            else
+            {
+                ASSERT_EQ(expected.v1, destination[i * 3]);
+                ASSERT_EQ(expected.v2, destination[(i * 3) + 1]);
+                ASSERT_EQ(expected.v3, destination[(i * 3) + 2]);
+            }
+        }
+    }
+}
+
+template<typename Transform>
+void check_copy_from_line_buffer(const interleave_mode interleave_mode, const color_transformation color_transformation)
+{
+    const auto copy_function{
+        copy_from_line_buffer<uint8_t>::get_copy_function(interleave_mode, 3, color_transformation)};
+
+    for (const size_t pixel_count : pixel_counts)
+    {
+        const size_t pixel_stride{pixel_count_to_pixel_stride(pixel_count)};
+        const vector<uint8_t> source{create_random_samples(pixel_stride * 3)};
+        vector<uint8_t> destination(pixel_count * 3);
+        copy_function(source.data(), destination.data(), pixel_count);
+
+        for (size_t i{}; i != pixel_count; ++i)
+        {
+            const auto expected{interleave_mode == interleave_mode::line
+                                    ? inverse<Transform>(source[i], source[i + pixel_stride],
+                                                         source[i + (2 * pixel_stride)])
+                                    : inverse<Transform>(source[i * 3], source[(i * 3) + 1], source[(i * 3) + 2])};
+            ASSERT_EQ(expected.v1, destination[i * 3]);
+            ASSERT_EQ(expected.v2, destination[(i * 3) + 1]);
+            ASSERT_EQ(expected.v3, destination[(i * 3) + 2]);
+        }
+    }
+}
+
+} // namespace
+
+
+TEST(copy_line_buffer_test, simd_functions_available)
+{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__aarch64__) || defined(_M_ARM64)
+    if (!get_simd_copy_to_line_buffer_function(interleave_mode::line, 3, color_transformation::hp1))
+        GTEST_SKIP() << "CPU has no SIMD support for the line buffer conversions";
+
+    EXPECT_NE(nullptr, get_simd_copy_from_line_buffer_function(interleave_mode::line, 3, color_transformation::hp1));
+#endif
+    EXPECT_EQ(nullptr, get_simd_copy_to_line_buffer_function(interleave_mode::line, 4, color_transformation::none));
+    EXPECT_EQ(nullptr, get_simd_copy_from_line_buffer_function(interleave_mode::none, 1, color_transformation::none));
+}
+
+TEST(copy_line_buffer_test, copy_to_line_buffer_line_interleaved)
+{
+    check_copy_to_line_buffer<void>(interleave_mode::line, color_transformation::none);
+    check_copy_to_line_buffer<void>(interleave_mode::line, color_transformation::none, 5);
+    check_copy_to_line_buffer<transform_hp1<uint8_t>>(interleave_mode::line, color_transformation::hp1);
+    check_copy_to_line_buffer<transform_hp2<uint8_t>>(interleave_mode::line, color_transformation::hp2);
+    check_copy_to_line_buffer<transform_hp3<uint8_t>>(interleave_mode::line, color_transformation::hp3);
+}
+
+TEST(copy_line_buffer_test, copy_to_line_buffer_sample_interleaved)
+{
+    check_copy_to_line_buffer<void>(interleave_mode::sample, color_transformation::none);
+    check_copy_to_line_buffer<transform_hp1<uint8_t>>(interleave_mode::sample, color_transformation::hp1);
+    check_copy_to_line_buffer<transform_hp2<uint8_t>>(interleave_mode::sample, color_transformation::hp2);
+    check_copy_to_line_buffer<transform_hp3<uint8_t>>(interleave_mode::sample, color_transformation::hp3);
+}
+
+TEST(copy_line_buffer_test, copy_from_line_buffer_line_interleaved)
+{
+    check_copy_from_line_buffer<void>(interleave_mode::line, color_transformation::none);
+    check_copy_from_line_buffer<transform_hp1<uint8_t>>(interleave_mode::line, color_transformation::hp1);
+    check_copy_from_line_buffer<transform_hp2<uint8_t>>(interleave_mode::line, color_transformation::hp2);
+    check_copy_from_line_buffer<transform_hp3<uint8_t>>(interleave_mode::line, color_transformation::hp3);
+}
+
+TEST(copy_line_buffer_test, copy_from_line_buffer_sample_interleaved)
+{
+    check_copy_from_line_buffer<void>(interleave_mode::sample, color_transformation::none);
+    check_copy_from_line_buffer<transform_hp1<uint8_t>>(interleave_mode::sample, color_transformation::hp1);
+    check_copy_from_line_buffer<transform_hp2<uint8_t>>(interleave_mode::sample, color_transformation::hp2);
+    check_copy_from_line_buffer<transform_hp3<uint8_t>>(interleave_mode::sample, color_transformation::hp3);
+}
+
+} // namespace charls::test
@@ -31,4 +31,20 @@ TEST(default_traits_test, modulo_range)
     }
 }
 
+TEST(default_traits_test, compute_error_value_near_lossless)
+{
+    for (const int32_t near_lossless : {1, 2, 7, 127})
+    {
+        const default_traits<uint16_t, uint16_t> traits(4095, near_lossless);
+
+        for (int32_t e{-4095}; e <= 4095; ++e)
+        {
+            // ISO/IEC 14495-1, A.4.4, code segment A.8 (error quantization).
+            const int32_t expected{e > 0 ? (e + near_lossless) / (2 * near_lossless + 1)
+                                         : -(near_lossless - e) / (2 * near_lossless + 1)};
+            ASSERT_EQ(traits.modulo_range(expected), traits.compute_error_value(e));
+        }
+    }
+}
+
 } // namespace charls::test
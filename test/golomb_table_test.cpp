@@ -23,4 +23,18 @@ TEST(golomb_table_test, golomb_table_create)
     EXPECT_EQ(0, golomb_table.get(255).error_value);
 }
 
+TEST(golomb_table_test, golomb_table_create_12_bit)
+{
+    const golomb_code_match_table<12> golomb_table(0);
+
+    // Error value -4 is mapped to 7, which is encoded with k = 0 as 0000 0001 (8 bits).
+    EXPECT_EQ(8, golomb_table.get(0b0000'0001'0000).bit_count);
+    EXPECT_EQ(-4, golomb_table.get(0b0000'0001'0000).error_value);
+
+    // Error value 5 is mapped to 10, which is encoded as 0000 0000 001 (11 bits): too long for an 8-bit table.
+    EXPECT_EQ(11, golomb_table.get(0b0000'0000'0010).bit_count);
+    EXPECT_EQ(5, golomb_table.get(0b0000'0000'0010).error_value);
+    EXPECT_EQ(0, golomb_table.get(0).bit_count);
+}
+
 } // namespace charls::test
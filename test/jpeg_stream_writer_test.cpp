@@ -566,6 +566,56 @@ TEST(jpeg_stream_writer_test, write_start_of_scan_segment_with_table_id_after_re
     EXPECT_EQ(byte{}, buffer[9]);   // transformation.
 }
 
+TEST(jpeg_stream_writer_test, write_define_restart_interval_segment)
+{
+    array<byte, 6> buffer{};
+    jpeg_stream_writer writer;
+    writer.destination({buffer.data(), buffer.size()});
+
+    writer.write_define_restart_interval_segment(0x1234);
+
+    EXPECT_EQ(buffer.size(), writer.bytes_written());
+    EXPECT_EQ(byte{0xFF}, buffer[0]);
+    EXPECT_EQ(byte{0xDD}, buffer[1]); // DRI marker.
+    EXPECT_EQ(byte{}, buffer[2]);
+    EXPECT_EQ(byte{4}, buffer[3]);    // segment length.
+    EXPECT_EQ(byte{0x12}, buffer[4]);
+    EXPECT_EQ(byte{0x34}, buffer[5]);
+}
+
+TEST(jpeg_stream_writer_test, write_define_restart_interval_segment_32_bit)
+{
+    array<byte, 8> buffer{};
+    jpeg_stream_writer writer;
+    writer.destination({buffer.data(), buffer.size()});
+
+    writer.write_define_restart_interval_segment(0x12345);
+
+    EXPECT_EQ(buffer.size(), writer.bytes_written());
+    EXPECT_EQ(byte{0xDD}, buffer[1]); // DRI marker.
+    EXPECT_EQ(byte{6}, buffer[3]);    // segment length.
+    EXPECT_EQ(byte{}, buffer[4]);
+    EXPECT_EQ(byte{0x01}, buffer[5]);
+    EXPECT_EQ(byte{0x23}, buffer[6]);
+    EXPECT_EQ(byte{0x45}, buffer[7]);
+}
+
+TEST(jpeg_stream_writer_test, write_restart_marker)
+{
+    array<byte, 4> buffer{};
+    jpeg_stream_writer writer;
+    writer.destination({buffer.data(), buffer.size()});
+
+    writer.write_restart_marker(2);
+    writer.write_restart_marker(9);
+
+    EXPECT_EQ(buffer.size(), writer.bytes_written());
+    EXPECT_EQ(byte{0xFF}, buffer[0]);
+    EXPECT_EQ(byte{0xD2}, buffer[1]); // RST2 marker.
+    EXPECT_EQ(byte{0xFF}, buffer[2]);
+    EXPECT_EQ(byte{0xD1}, buffer[3]); // RST1 marker.
+}
+
 TEST(jpeg_stream_writer_test, advance_position)
 {
     array<byte, 2> buffer{};
@@ -166,4 +166,20 @@ TEST(jpegls_algorithm_test, map_unmap_error_value_algorithm)
     map_unmap_error_value_algorithm(numeric_limits<int32_t>::min() / 2);
 }
 
+TEST(jpegls_algorithm_test, divide_by_reciprocal_is_exact)
+{
+    // All divisors 2 * NEAR + 1 and all dividends |error value| + NEAR of 16 bit near-lossless coding.
+    for (int32_t divisor{1}; divisor <= 2 * 255 + 1; divisor += 2)
+    {
+        const uint64_t multiplier{compute_reciprocal_multiplier(divisor)};
+        int32_t mismatch_count{};
+        for (int32_t dividend{}; dividend <= 65535 + 2 * 255; ++dividend)
+        {
+            mismatch_count += static_cast<int32_t>(divide_by_reciprocal(dividend, multiplier) != dividend / divisor);
+        }
+
+        ASSERT_EQ(0, mismatch_count) << "divisor = " << divisor;
+    }
+}
+
 } // namespace charls::test
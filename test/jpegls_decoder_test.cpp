@@ -141,6 +141,176 @@ void oversize_image_dimension_bad_segment_size_throws(const uint32_t number_of_b
     assert_expect_exception(jpegls_errc::invalid_marker_segment_size, [&decoder] { decoder.read_header(); });
 }
 
+[[nodiscard]]
+vector<byte> decode_with_thread_count(const vector<byte>& source, const uint32_t thread_count)
+{
+    jpegls_decoder decoder{source, true};
+    decoder.thread_count(thread_count);
+    vector<byte> destination(decoder.get_destination_size());
+    decoder.decode(destination);
+    return destination;
+}
+
+void decode_multi_threaded_and_compare(const char* filename)
+{
+    const auto source{read_file(filename)};
+
+    const auto expected{decode_with_thread_count(source, 1)};
+    for (const uint32_t thread_count : {0U, 2U, 3U, 8U, 64U})
+    {
+        EXPECT_EQ(expected, decode_with_thread_count(source, thread_count));
+    }
+}
+
+[[nodiscard]]
+jpegls_errc decode_with_thread_count_error(const vector<byte>& source, const uint32_t thread_count)
+{
+    try
+    {
+        ignore = decode_with_thread_count(source, thread_count);
+    }
+    catch (const jpegls_error& error)
+    {
+        return static_cast<jpegls_errc>(error.code().value());
+    }
+
+    return jpegls_errc::success;
+}
+
+[[nodiscard]]
+vector<byte> decode_incrementally(const vector<byte>& source, const size_t chunk_size)
+{
+    jpegls_decoder decoder;
+    size_t position{};
+    const auto append_chunk{[&decoder, &source, &position, chunk_size] {
+        const size_t size{std::min(chunk_size, source.size() - position)};
+        decoder.append_source(source.data() + position, size);
+        position += size;
+    }};
+
+    error_code ec;
+    do
+    {
+        append_chunk();
+        decoder.read_header(ec);
+    } while (ec == jpegls_errc::need_more_data && position < source.size());
+    EXPECT_FALSE(ec);
+
+    vector<byte> destination(decoder.get_destination_size());
+    uint32_t decoded_line_count{};
+    while (!decoder.decode_available(destination))
+    {
+        EXPECT_LE(decoded_line_count, decoder.decoded_line_count());
+        decoded_line_count = decoder.decoded_line_count();
+        if (position == source.size())
+            break;
+
+        append_chunk();
+    }
+
+    EXPECT_EQ(source.size(), position);
+    return destination;
+}
+
+void decode_incrementally_and_compare(const char* filename)
+{
+    const auto source{read_file(filename)};
+
+    const auto expected{decode_with_thread_count(source, 1)};
+    for (const size_t chunk_size : {size_t{1}, size_t{7}, size_t{100}, size_t{4096}, source.size()})
+    {
+        EXPECT_EQ(expected, decode_incrementally(source, chunk_size));
+    }
+}
+
+[[nodiscard]]
+vector<byte> decode_to_line_handler(const vector<byte>& source, const uint32_t lines_per_call)
+{
+    jpegls_decoder decoder{source, true};
+    const uint32_t height{decoder.frame_info().height};
+    vector<byte> destination(decoder.get_destination_size());
+
+    uint32_t expected_component_index{};
+    uint32_t expected_first_line{};
+    decoder.decode(
+        [&](const void* lines, const size_t size, const uint32_t component_index, const uint32_t first_line,
+            const uint32_t line_count) {
+            EXPECT_EQ(expected_component_index, component_index);
+            EXPECT_EQ(expected_first_line, first_line);
+            EXPECT_LE(line_count, lines_per_call);
+
+            const size_t stride{size / line_count};
+            const auto* first{static_cast<const byte*>(lines)};
+            std::copy(first, first + size,
+                      destination.begin() +
+                          static_cast<vector<byte>::difference_type>((component_index * height + first_line) * stride));
+
+            expected_first_line += line_count;
+            if (expected_first_line == height)
+            {
+                expected_first_line = 0;
+                ++expected_component_index;
+            }
+        },
+        lines_per_call);
+
+    return destination;
+}
+
+void decode_rect_and_compare(const vector<byte>& source, const uint32_t x, const uint32_t y, const uint32_t width,
+                             const uint32_t height)
+{
+    jpegls_decoder decoder{source, true};
+    const auto frame_info{decoder.frame_info()};
+    const bool planar{decoder.get_interleave_mode() == interleave_mode::none};
+    const size_t pixel_size{((static_cast<size_t>(frame_info.bits_per_sample) + 7) / 8) *
+                            (planar ? 1 : frame_info.component_count)};
+    const size_t stride{frame_info.width * pixel_size};
+    const int32_t plane_count{planar ? frame_info.component_count : 1};
+    const auto image{decode_with_thread_count(source, 1)};
+
+    vector<byte> expected;
+    for (int32_t plane{}; plane != plane_count; ++plane)
+    {
+        for (uint32_t line{y}; line != y + height; ++line)
+        {
+            const size_t offset{(plane * stride * frame_info.height) + (line * stride) + (x * pixel_size)};
+            const auto first{image.cbegin() + static_cast<vector<byte>::difference_type>(offset)};
+            expected.insert(expected.end(), first, first + static_cast<vector<byte>::difference_type>(width * pixel_size));
+        }
+    }
+
+    vector<byte> destination(expected.size());
+    decoder.decode_rect(x, y, width, height, destination);
+    EXPECT_EQ(expected, destination);
+}
+
+void decode_rect_and_compare(const char* filename)
+{
+    const auto source{read_file(filename)};
+    const auto frame_info{create_decoder(source).frame_info()};
+    const uint32_t width{frame_info.width};
+    const uint32_t height{frame_info.height};
+
+    decode_rect_and_compare(source, 0, 0, width, height);
+    decode_rect_and_compare(source, 0, 0, width, 1);
+    decode_rect_and_compare(source, 0, 0, width / 3, height / 4);
+    decode_rect_and_compare(source, width / 2, height / 2, width / 3, height / 3);
+    decode_rect_and_compare(source, 1, height - 1, width - 2, 1);
+    decode_rect_and_compare(source, 0, height / 2, width, height - (height / 2));
+}
+
+void decode_to_line_handler_and_compare(const char* filename)
+{
+    const auto source{read_file(filename)};
+
+    const auto expected{decode_with_thread_count(source, 1)};
+    for (const uint32_t lines_per_call : {1U, 7U, 256U, numeric_limits<uint32_t>::max()})
+    {
+        EXPECT_EQ(expected, decode_to_line_handler(source, lines_per_call));
+    }
+}
+
 void decode_image_with_too_small_buffer_throws(const char* image_filename, const uint32_t stride = 0,
                                                const uint32_t too_small_byte_count = 1)
 {
@@ -901,6 +1071,471 @@ TEST(jpegls_decoder_test, decode_file_that_ends_after_restart_marker_throws)
     assert_expect_exception(jpegls_errc::need_more_data, [&decoder, &destination] { decoder.decode(destination); });
 }
 
+TEST(jpegls_decoder_test, decode_restart_intervals_multi_threaded)
+{
+    decode_multi_threaded_and_compare("data/test8_ilv_none_rm_7.jls");
+    decode_multi_threaded_and_compare("data/test8_ilv_line_rm_7.jls");
+    decode_multi_threaded_and_compare("data/test8_ilv_sample_rm_7.jls");
+    decode_multi_threaded_and_compare("data/test8_ilv_sample_rm_300.jls");
+    decode_multi_threaded_and_compare("data/test16_rm_5.jls");
+}
+
+TEST(jpegls_decoder_test, decode_restart_intervals_multi_threaded_matches_reference)
+{
+    const auto source{read_file("data/test8_ilv_line_rm_7.jls")};
+
+    jpegls_decoder decoder{source, true};
+    decoder.thread_count(4);
+    vector<byte> destination(decoder.get_destination_size());
+    decoder.decode(destination);
+
+    verify_decoded_bytes(decoder.get_interleave_mode(), decoder.frame_info(), destination,
+                         static_cast<size_t>(decoder.frame_info().width) * decoder.frame_info().component_count,
+                         "data/test8.ppm");
+}
+
+TEST(jpegls_decoder_test, decode_restart_interval_of_one_line_multi_threaded)
+{
+    constexpr frame_info frame_info{37, 29, 8, 3};
+    vector<byte> source_pixels(static_cast<size_t>(frame_info.width) * frame_info.height * frame_info.component_count);
+    for (size_t i{}; i != source_pixels.size(); ++i)
+    {
+        source_pixels[i] = static_cast<byte>(i * 7 % 61);
+    }
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info).interleave_mode(interleave_mode::sample).restart_interval(1);
+    vector<byte> encoded(encoder.estimated_destination_size());
+    encoder.destination(encoded);
+    encoded.resize(encoder.encode(source_pixels));
+
+    EXPECT_EQ(source_pixels, decode_with_thread_count(encoded, 5));
+}
+
+TEST(jpegls_decoder_test, decode_file_with_incorrect_restart_marker_multi_threaded_throws)
+{
+    auto source{read_file("data/test8_ilv_none_rm_7.jls")};
+
+    // Change the first restart marker to the second.
+    auto it{find_scan_header(source.begin(), source.end())};
+    it = find_first_restart_marker(it + 1, source.end());
+    ++it;
+    *it = byte{0xD1};
+
+    jpegls_decoder decoder{source, true};
+    decoder.thread_count(4);
+    vector<byte> destination(decoder.get_destination_size());
+
+    assert_expect_exception(jpegls_errc::restart_marker_not_found,
+                            [&decoder, &destination] { decoder.decode(destination); });
+}
+
+TEST(jpegls_decoder_test, decode_file_with_extra_begin_bytes_for_restart_marker_code_multi_threaded)
+{
+    auto source{read_file("data/test8_ilv_none_rm_7.jls")};
+
+    // Add additional 0xFF marker begin bytes
+    auto it{find_scan_header(source.begin(), source.end())};
+    it = find_first_restart_marker(it + 1, source.end());
+    constexpr array extra_begin_bytes{byte{0xFF}, byte{0xFF}, byte{0xFF}};
+    source.insert(it, extra_begin_bytes.cbegin(), extra_begin_bytes.cend());
+
+    EXPECT_EQ(decode_with_thread_count(source, 1), decode_with_thread_count(source, 4));
+}
+
+TEST(jpegls_decoder_test, decode_file_that_ends_after_restart_marker_multi_threaded_throws)
+{
+    auto source{read_file("data/test8_ilv_none_rm_7.jls")};
+
+    auto it{find_scan_header(source.begin(), source.end())};
+    it = find_first_restart_marker(it + 1, source.end());
+    const vector too_small_source(source.begin(), it);
+
+    jpegls_decoder decoder{too_small_source, true};
+    decoder.thread_count(4);
+    vector<byte> destination(decoder.get_destination_size());
+
+    assert_expect_exception(jpegls_errc::need_more_data, [&decoder, &destination] { decoder.decode(destination); });
+}
+
+TEST(jpegls_decoder_test, decode_interleave_none_multi_threaded)
+{
+    decode_multi_threaded_and_compare("data/t8c0e0.jls");
+    decode_multi_threaded_and_compare("data/t8c0e3.jls");
+    decode_multi_threaded_and_compare("data/test8_ilv_none_rm_7.jls");
+}
+
+TEST(jpegls_decoder_test, decode_interleave_none_multi_threaded_matches_reference)
+{
+    const auto source{read_file("data/t8c0e0.jls")};
+
+    jpegls_decoder decoder{source, true};
+    decoder.thread_count(3);
+    vector<byte> destination(decoder.get_destination_size());
+    decoder.decode(destination);
+
+    verify_decoded_bytes(decoder.get_interleave_mode(), decoder.frame_info(), destination, decoder.frame_info().width,
+                         "data/test8.ppm");
+}
+
+TEST(jpegls_decoder_test, decode_interleaved_with_conversion_thread)
+{
+    decode_multi_threaded_and_compare("data/t8c1e0.jls");
+    decode_multi_threaded_and_compare("data/t8c2e3.jls");
+    decode_multi_threaded_and_compare("data/banny-hp1.jls");
+    decode_multi_threaded_and_compare("data/banny-hp2.jls");
+    decode_multi_threaded_and_compare("data/banny-hp3.jls");
+}
+
+TEST(jpegls_decoder_test, decode_scans_with_different_parameters_multi_threaded)
+{
+    constexpr frame_info frame_info{8, 3, 8, 4};
+    vector<byte> source(static_cast<size_t>(frame_info.width) * frame_info.height * frame_info.component_count);
+    for (size_t i{}; i != source.size(); ++i)
+    {
+        source[i] = static_cast<byte>(i * 13 % 251);
+    }
+    const size_t plane_size{static_cast<size_t>(frame_info.width) * frame_info.height};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info);
+    vector<byte> encoded(encoder.estimated_destination_size());
+    encoder.destination(encoded);
+    encoder.near_lossless(2).restart_interval(1);
+    encoder.encode_components(source.data(), plane_size, 1);
+    encoder.near_lossless(0).restart_interval(0).preset_coding_parameters({255, 10, 20, 22, 64});
+    encoder.encode_components(source.data() + plane_size, plane_size, 1);
+    encoder.interleave_mode(interleave_mode::sample).preset_coding_parameters({});
+    encoder.encode_components(source.data() + (2 * plane_size), 2 * plane_size, 2);
+    encoded.resize(encoder.bytes_written());
+
+    const auto expected{decode_with_thread_count(encoded, 1)};
+    EXPECT_EQ(expected, decode_with_thread_count(encoded, 2));
+    EXPECT_EQ(expected, decode_with_thread_count(encoded, 4));
+    EXPECT_EQ(expected, decode_with_thread_count(encoded, 0));
+}
+
+TEST(jpegls_decoder_test, decode_truncated_interleave_none_multi_threaded_throws)
+{
+    const auto source{read_file("data/t8c0e0.jls")};
+
+    for (const size_t size : {source.size() - 2, source.size() * 2 / 3})
+    {
+        const vector truncated_source(source.cbegin(), source.cbegin() + static_cast<vector<byte>::difference_type>(size));
+
+        const jpegls_errc expected{decode_with_thread_count_error(truncated_source, 1)};
+        EXPECT_NE(jpegls_errc::success, expected);
+        EXPECT_EQ(expected, decode_with_thread_count_error(truncated_source, 3));
+    }
+}
+
+TEST(jpegls_decoder_test, decode_incrementally)
+{
+    decode_incrementally_and_compare("data/t8c0e0.jls");
+    decode_incrementally_and_compare("data/t8c1e0.jls");
+    decode_incrementally_and_compare("data/t8c2e0.jls");
+    decode_incrementally_and_compare("data/t8c2e3.jls");
+    decode_incrementally_and_compare("data/t8nde0.jls");
+    decode_incrementally_and_compare("data/t16e0.jls");
+    decode_incrementally_and_compare("data/banny-hp1.jls");
+    decode_incrementally_and_compare("data/tulips-gray-8bit-512-512-hp-encoder.jls");
+}
+
+TEST(jpegls_decoder_test, decode_restart_intervals_incrementally)
+{
+    decode_incrementally_and_compare("data/test8_ilv_none_rm_7.jls");
+    decode_incrementally_and_compare("data/test8_ilv_line_rm_7.jls");
+    decode_incrementally_and_compare("data/test8_ilv_sample_rm_300.jls");
+    decode_incrementally_and_compare("data/test16_rm_5.jls");
+}
+
+TEST(jpegls_decoder_test, decode_rect)
+{
+    decode_rect_and_compare("data/t8c0e0.jls");
+    decode_rect_and_compare("data/t8c1e0.jls");
+    decode_rect_and_compare("data/t8c2e0.jls");
+    decode_rect_and_compare("data/t16e0.jls");
+    decode_rect_and_compare("data/t8nde0.jls");
+    decode_rect_and_compare("data/t8c2e3.jls");
+    decode_rect_and_compare("data/banny-hp2.jls");
+}
+
+TEST(jpegls_decoder_test, decode_rect_with_restart_interval)
+{
+    decode_rect_and_compare("data/test8_ilv_none_rm_7.jls");
+    decode_rect_and_compare("data/test8_ilv_line_rm_7.jls");
+    decode_rect_and_compare("data/test8_ilv_sample_rm_7.jls");
+    decode_rect_and_compare("data/test8_ilv_sample_rm_300.jls");
+    decode_rect_and_compare("data/test16_rm_5.jls");
+}
+
+TEST(jpegls_decoder_test, decode_rect_skips_restart_intervals_before_rect)
+{
+    auto source{read_file("data/test8_ilv_sample_rm_7.jls")};
+    const auto frame_info{create_decoder(source).frame_info()};
+
+    // Corrupt the first restart interval: a rectangle after it should still decode correctly.
+    const auto expected_image{decode_with_thread_count(source, 1)};
+    auto it{find_scan_header(source.begin(), source.end())};
+    const auto restart_marker{find_first_restart_marker(it + 1, source.end())};
+    std::fill(restart_marker - 16, restart_marker, byte{0x55});
+
+    const size_t stride{static_cast<size_t>(frame_info.width) * frame_info.component_count};
+    const vector<byte> expected(expected_image.cbegin() + static_cast<vector<byte>::difference_type>(7 * stride),
+                                expected_image.cbegin() + static_cast<vector<byte>::difference_type>(14 * stride));
+
+    jpegls_decoder decoder{source, true};
+    vector<byte> destination(expected.size());
+    decoder.decode_rect(0, 7, frame_info.width, 7, destination);
+    EXPECT_EQ(expected, destination);
+}
+
+TEST(jpegls_decoder_test, decode_rect_with_stride)
+{
+    const auto source{read_file("data/t8c0e0.jls")};
+    jpegls_decoder decoder{source, true};
+
+    constexpr uint32_t width{10};
+    constexpr uint32_t height{5};
+    constexpr uint32_t stride{16};
+    vector<byte> destination((3 * stride * height) - (stride - width));
+    decoder.decode_rect(3, 4, width, height, destination, stride);
+
+    jpegls_decoder expected_decoder{source, true};
+    vector<byte> expected(3 * width * height);
+    expected_decoder.decode_rect(3, 4, width, height, expected);
+    for (size_t line{}; line != 3 * height; ++line)
+    {
+        EXPECT_TRUE(std::equal(expected.cbegin() + static_cast<vector<byte>::difference_type>(line * width),
+                               expected.cbegin() + static_cast<vector<byte>::difference_type>((line + 1) * width),
+                               destination.cbegin() + static_cast<vector<byte>::difference_type>(line * stride)));
+    }
+}
+
+TEST(jpegls_decoder_test, decode_rect_outside_image_throws)
+{
+    const auto source{read_file("data/t8c0e0.jls")};
+    jpegls_decoder decoder{source, true};
+    const auto frame_info{decoder.frame_info()};
+    vector<byte> destination(decoder.get_destination_size());
+
+    assert_expect_exception(jpegls_errc::invalid_argument, [&decoder, &destination, &frame_info] {
+        decoder.decode_rect(1, 0, frame_info.width, 1, destination);
+    });
+    assert_expect_exception(jpegls_errc::invalid_argument, [&decoder, &destination, &frame_info] {
+        decoder.decode_rect(0, frame_info.height, 1, 1, destination);
+    });
+    assert_expect_exception(jpegls_errc::invalid_argument,
+                            [&decoder, &destination] { decoder.decode_rect(0, 0, 0, 1, destination); });
+}
+
+TEST(jpegls_decoder_test, decode_rect_with_too_small_destination_throws)
+{
+    const auto source{read_file("data/t8c0e0.jls")};
+    jpegls_decoder decoder{source, true};
+    vector<byte> destination((3 * 10 * 10) - 1);
+
+    assert_expect_exception(jpegls_errc::invalid_argument_size,
+                            [&decoder, &destination] { decoder.decode_rect(0, 0, 10, 10, destination); });
+}
+
+TEST(jpegls_decoder_test, decode_batch)
+{
+    const array<const char*, 4> filenames{"data/t8c0e0.jls", "data/t16e0.jls", "data/t8c2e3.jls",
+                                          "data/test8_ilv_sample_rm_7.jls"};
+    vector<vector<byte>> sources;
+    for (const char* filename : filenames)
+    {
+        sources.push_back(read_file(filename));
+    }
+
+    for (const uint32_t thread_count : {1U, 0U, 3U, 100000U})
+    {
+        jpegls_decoder decoder;
+        decoder.thread_count(thread_count);
+
+        vector<vector<byte>> destinations(sources.size(), vector<byte>(1000000));
+        vector<batch_item> items(sources.size());
+        for (size_t i{}; i < items.size(); ++i)
+        {
+            items[i].source = sources[i].data();
+            items[i].source_size = sources[i].size();
+            items[i].destination = destinations[i].data();
+            items[i].destination_size = destinations[i].size();
+        }
+
+        decoder.decode_batch(items);
+
+        for (size_t i{}; i < items.size(); ++i)
+        {
+            ASSERT_EQ(jpegls_errc::success, items[i].error);
+            const jpegls_decoder expected_decoder{sources[i], true};
+            const auto expected_frame_info{expected_decoder.frame_info()};
+            EXPECT_EQ(expected_frame_info.width, items[i].frame_info.width);
+            EXPECT_EQ(expected_frame_info.height, items[i].frame_info.height);
+            EXPECT_EQ(expected_frame_info.bits_per_sample, items[i].frame_info.bits_per_sample);
+            EXPECT_EQ(expected_frame_info.component_count, items[i].frame_info.component_count);
+            EXPECT_EQ(expected_decoder.get_destination_size(), items[i].bytes_written);
+
+            destinations[i].resize(items[i].bytes_written);
+            EXPECT_EQ(decode_with_thread_count(sources[i], 1), destinations[i]);
+        }
+    }
+}
+
+TEST(jpegls_decoder_test, decode_batch_reports_error_per_item)
+{
+    const auto source{read_file("data/t8c0e0.jls")};
+    const vector<byte> bad_source(100, byte{0x55});
+    vector<byte> destination1(1000000);
+    vector<byte> destination2(1000000);
+    vector<byte> destination3(10);
+
+    array<batch_item, 4> items{};
+    items[0] = {bad_source.data(), bad_source.size(), destination1.data(), destination1.size(), 0, {}, 0, {}};
+    items[1] = {source.data(), source.size(), destination2.data(), destination2.size(), 0, {}, 0, {}};
+    items[2] = {source.data(), source.size(), destination3.data(), destination3.size(), 0, {}, 0, {}};
+    items[3] = {nullptr, 0, destination1.data(), destination1.size(), 0, {}, 0, {}};
+
+    const jpegls_decoder decoder;
+    decoder.decode_batch(items);
+
+    EXPECT_EQ(jpegls_errc::jpeg_marker_start_byte_not_found, items[0].error);
+    EXPECT_EQ(0U, items[0].bytes_written);
+    EXPECT_EQ(jpegls_errc::success, items[1].error);
+    destination2.resize(items[1].bytes_written);
+    EXPECT_EQ(decode_with_thread_count(source, 1), destination2);
+    EXPECT_EQ(jpegls_errc::invalid_argument_size, items[2].error);
+    EXPECT_EQ(0U, items[2].bytes_written);
+    EXPECT_EQ(jpegls_errc::need_more_data, items[3].error);
+}
+
+TEST(jpegls_decoder_test, decode_empty_batch)
+{
+    const jpegls_decoder decoder;
+    decoder.decode_batch(nullptr, 0);
+
+    vector<batch_item> items;
+    decoder.decode_batch(items);
+}
+
+TEST(jpegls_decoder_test, decode_available_reports_decoded_line_count)
+{
+    const auto source{read_file("data/t8c0e0.jls")};
+
+    jpegls_decoder decoder;
+    decoder.append_source(source.data(), source.size() / 2);
+    decoder.read_header();
+    vector<byte> destination(decoder.get_destination_size());
+
+    EXPECT_FALSE(decoder.decode_available(destination));
+    const uint32_t decoded_line_count{decoder.decoded_line_count()};
+    EXPECT_LT(0U, decoded_line_count);
+    EXPECT_GT(decoder.frame_info().height * 3U, decoded_line_count);
+    EXPECT_FALSE(decoder.decode_available(destination));
+    EXPECT_EQ(decoded_line_count, decoder.decoded_line_count());
+
+    decoder.append_source(source.data() + source.size() / 2, source.size() - (source.size() / 2));
+    EXPECT_TRUE(decoder.decode_available(destination));
+    EXPECT_EQ(decoder.frame_info().height * 3U, decoder.decoded_line_count());
+    EXPECT_EQ(decode_with_thread_count(source, 1), destination);
+}
+
+TEST(jpegls_decoder_test, read_header_incrementally_reports_need_more_data)
+{
+    const auto source{read_file("data/t8c0e0.jls")};
+
+    jpegls_decoder decoder;
+    decoder.append_source(source.data(), 20);
+    error_code ec;
+    decoder.read_header(ec);
+    EXPECT_EQ(jpegls_errc::need_more_data, static_cast<jpegls_errc>(ec.value()));
+
+    decoder.append_source(source.data() + 20, 100);
+    decoder.read_header(ec);
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(256U, decoder.frame_info().width);
+}
+
+TEST(jpegls_decoder_test, append_source_after_source_throws)
+{
+    const auto source{read_file("data/t8c0e0.jls")};
+
+    jpegls_decoder decoder{source, true};
+
+    assert_expect_exception(jpegls_errc::invalid_operation, [&decoder, &source] { decoder.append_source(source); });
+}
+
+TEST(jpegls_decoder_test, decode_available_without_append_source_throws)
+{
+    const auto source{read_file("data/t8c0e0.jls")};
+
+    jpegls_decoder decoder{source, true};
+    vector<byte> destination(decoder.get_destination_size());
+
+    assert_expect_exception(jpegls_errc::invalid_operation,
+                            [&decoder, &destination] { ignore = decoder.decode_available(destination); });
+}
+
+TEST(jpegls_decoder_test, decode_after_decode_available_throws)
+{
+    const auto source{read_file("data/t8c0e0.jls")};
+
+    jpegls_decoder decoder;
+    decoder.append_source(source.data(), source.size() / 2);
+    decoder.read_header();
+    vector<byte> destination(decoder.get_destination_size());
+    EXPECT_FALSE(decoder.decode_available(destination));
+
+    assert_expect_exception(jpegls_errc::invalid_operation, [&decoder, &destination] { decoder.decode(destination); });
+}
+
+TEST(jpegls_decoder_test, decode_available_with_too_small_buffer_throws)
+{
+    const auto source{read_file("data/t8c0e0.jls")};
+
+    jpegls_decoder decoder;
+    decoder.append_source(source);
+    decoder.read_header();
+    vector<byte> destination(decoder.get_destination_size() - 1);
+
+    assert_expect_exception(jpegls_errc::invalid_argument_size,
+                            [&decoder, &destination] { ignore = decoder.decode_available(destination); });
+}
+
+TEST(jpegls_decoder_test, decode_to_line_handler)
+{
+    decode_to_line_handler_and_compare("data/t8c0e0.jls");
+    decode_to_line_handler_and_compare("data/t8c1e0.jls");
+    decode_to_line_handler_and_compare("data/t8c2e0.jls");
+    decode_to_line_handler_and_compare("data/t8nde0.jls");
+    decode_to_line_handler_and_compare("data/t16e0.jls");
+    decode_to_line_handler_and_compare("data/banny-hp1.jls");
+    decode_to_line_handler_and_compare("data/test8_ilv_line_rm_7.jls");
+    decode_to_line_handler_and_compare("data/test16_rm_5.jls");
+}
+
+TEST(jpegls_decoder_test, decode_to_line_handler_that_throws)
+{
+    const auto source{read_file("data/t8c0e0.jls")};
+    jpegls_decoder decoder{source, true};
+
+    assert_expect_exception(jpegls_errc::callback_failed, [&decoder] {
+        decoder.decode([](const void*, size_t, uint32_t, uint32_t, uint32_t) { throw std::runtime_error("abort"); });
+    });
+}
+
+TEST(jpegls_decoder_test, decode_to_line_handler_twice_throws)
+{
+    const auto source{read_file("data/t8c0e0.jls")};
+    jpegls_decoder decoder{source, true};
+    decoder.decode([](const void*, size_t, uint32_t, uint32_t, uint32_t) noexcept {}, 16);
+
+    assert_expect_exception(jpegls_errc::invalid_operation, [&decoder] {
+        decoder.decode([](const void*, size_t, uint32_t, uint32_t, uint32_t) noexcept {}, 16);
+    });
+}
+
 TEST(jpegls_decoder_test, read_comment)
 {
     jpeg_test_stream_writer writer;
@@ -1594,4 +2229,130 @@ TEST(jpegls_decoder_test, read_header_interleave_mode_none_with_color_transforma
     assert_expect_exception(jpegls_errc::invalid_parameter_color_transformation, [&decoder] { decoder.read_header(); });
 }
 
+TEST(jpegls_decoder_test, reset_and_decode_other_image)
+{
+    const auto source1{read_file("data/t8c0e0.jls")};
+    const auto source2{read_file("data/t8c1e0.jls")};
+    const auto source3{read_file("data/t16e0.jls")};
+
+    jpegls_decoder decoder;
+    for (const auto* source : {&source1, &source1, &source2, &source3, &source1})
+    {
+        decoder.reset();
+        decoder.source(*source).read_header();
+        vector<byte> destination(decoder.get_destination_size());
+        decoder.decode(destination);
+
+        EXPECT_EQ(decode_with_thread_count(*source, 1), destination);
+    }
+}
+
+TEST(jpegls_decoder_test, reset_after_read_header)
+{
+    const auto source1{read_file("data/t8c0e0.jls")};
+    const auto source2{read_file("data/t8c2e0.jls")};
+
+    jpegls_decoder decoder{source1, true};
+    decoder.reset();
+    decoder.source(source2).read_header();
+    vector<byte> destination(decoder.get_destination_size());
+    decoder.decode(destination);
+
+    EXPECT_EQ(decode_with_thread_count(source2, 1), destination);
+}
+
+TEST(jpegls_decoder_test, reset_and_decode_incrementally)
+{
+    const auto source{read_file("data/t8c1e0.jls")};
+    const auto expected{decode_with_thread_count(source, 1)};
+
+    jpegls_decoder decoder;
+    for (int i{}; i < 2; ++i)
+    {
+        decoder.reset();
+        decoder.append_source(source.data(), source.size() / 2);
+        error_code ec;
+        decoder.read_header(ec);
+        ASSERT_FALSE(ec);
+
+        vector<byte> destination(decoder.get_destination_size());
+        EXPECT_FALSE(decoder.decode_available(destination));
+        decoder.append_source(source.data() + source.size() / 2, source.size() - source.size() / 2);
+        EXPECT_TRUE(decoder.decode_available(destination));
+        EXPECT_EQ(expected, destination);
+    }
+}
+
+TEST(jpegls_decoder_test, decode_with_allocator)
+{
+    const auto source{read_file("data/t8c1e0.jls")};
+    allocation_statistics statistics;
+    {
+        jpegls_decoder decoder{counting_allocate, counting_deallocate, &statistics};
+        decoder.source(source).read_header();
+        vector<byte> destination(decoder.get_destination_size());
+        decoder.decode(destination);
+
+        EXPECT_EQ(decode_with_thread_count(source, 1), destination);
+        EXPECT_GT(statistics.allocated_size, size_t{});
+    }
+
+    EXPECT_GT(statistics.allocation_count, size_t{2});
+    EXPECT_EQ(size_t{}, statistics.allocated_size);
+}
+
+TEST(jpegls_decoder_test, decode_incrementally_with_allocator)
+{
+    const auto source{read_file("data/t8c0e0.jls")};
+    allocation_statistics statistics;
+    {
+        jpegls_decoder decoder{counting_allocate, counting_deallocate, &statistics};
+        decoder.append_source(source.data(), source.size() / 2);
+        error_code ec;
+        decoder.read_header(ec);
+        ASSERT_FALSE(ec);
+
+        vector<byte> destination(decoder.get_destination_size());
+        EXPECT_FALSE(decoder.decode_available(destination));
+        decoder.append_source(source.data() + source.size() / 2, source.size() - source.size() / 2);
+        EXPECT_TRUE(decoder.decode_available(destination));
+        EXPECT_EQ(decode_with_thread_count(source, 1), destination);
+    }
+
+    EXPECT_EQ(size_t{}, statistics.allocated_size);
+}
+
+TEST(jpegls_decoder_test, decode_with_failing_allocator)
+{
+    const auto source{read_file("data/t8c1e0.jls")};
+
+    // Let every allocation fail once: the decoder should report it and not leak memory.
+    for (size_t allocation_limit{};; ++allocation_limit)
+    {
+        allocation_statistics statistics;
+        statistics.allocation_limit = allocation_limit;
+        bool decoded{};
+        try
+        {
+            jpegls_decoder decoder{counting_allocate, counting_deallocate, &statistics};
+            decoder.source(source).read_header();
+            vector<byte> destination(decoder.get_destination_size());
+            decoder.decode(destination);
+            decoded = true;
+        }
+        catch (const jpegls_error& error)
+        {
+            EXPECT_EQ(jpegls_errc::not_enough_memory, error.code());
+        }
+        catch (const std::bad_alloc&)
+        {
+            EXPECT_EQ(size_t{}, allocation_limit);
+        }
+
+        EXPECT_EQ(size_t{}, statistics.allocated_size);
+        if (decoded)
+            break;
+    }
+}
+
 } // namespace charls::test
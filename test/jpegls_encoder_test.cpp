@@ -11,8 +11,10 @@
 #include "../src/util.hpp"
 #include <charls/charls.hpp>
 
+#include <algorithm>
 #include <array>
 #include <limits>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -89,6 +91,216 @@ void encode_with_custom_preset_coding_parameters(const jpegls_pc_parameters& pc_
     test_by_decoding(destination, frame_info, source.data(), source.size(), interleave_mode::none);
 }
 
+[[nodiscard]]
+vector<byte> create_noise_image(const frame_info& frame_info)
+{
+    // Use a simple linear congruential generator: noisy data will produce many 0xFF bytes in the encoded bit stream.
+    // Only use a quarter of the sample range to remain within the estimated destination size.
+    vector<byte> image(static_cast<size_t>(frame_info.width) * frame_info.height * frame_info.component_count *
+                       ((static_cast<size_t>(frame_info.bits_per_sample) + 7) / 8));
+    const uint32_t mask{(1U << (frame_info.bits_per_sample - 2)) - 1};
+    uint32_t state{1234567};
+    if (frame_info.bits_per_sample <= 8)
+    {
+        for (auto& sample : image)
+        {
+            state = (state * 1103515245U) + 12345U;
+            sample = static_cast<byte>((state >> 16) & mask);
+        }
+    }
+    else
+    {
+        for (size_t i{}; i < image.size(); i += 2)
+        {
+            state = (state * 1103515245U) + 12345U;
+            const uint32_t value{(state >> 12) & mask};
+            image[i] = static_cast<byte>(value);
+            image[i + 1] = static_cast<byte>(value >> 8);
+        }
+    }
+
+    return image;
+}
+
+[[nodiscard]]
+size_t count_restart_markers(const vector<byte>& encoded_source)
+{
+    size_t count{};
+    for (size_t i{}; i + 1 < encoded_source.size(); ++i)
+    {
+        if (encoded_source[i] == byte{0xFF} && (encoded_source[i + 1] & byte{0xF8}) == byte{0xD0})
+        {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+void encode_with_restart_interval(const frame_info& frame_info, const charls::interleave_mode interleave_mode,
+                                  const uint32_t restart_interval, const int32_t near_lossless = 0)
+{
+    const vector<byte> source{create_noise_image(frame_info)};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info)
+        .interleave_mode(interleave_mode)
+        .near_lossless(near_lossless)
+        .restart_interval(restart_interval);
+    vector<byte> destination(encoder.estimated_destination_size());
+    encoder.destination(destination);
+
+    const size_t bytes_written{encoder.encode(source)};
+    destination.resize(bytes_written);
+
+    const size_t scan_count{interleave_mode == interleave_mode::none ? static_cast<size_t>(frame_info.component_count)
+                                                                      : 1U};
+    EXPECT_EQ(scan_count * ((frame_info.height - 1) / restart_interval), count_restart_markers(destination));
+
+    test_by_decoding(destination, frame_info, source.data(), source.size(), interleave_mode);
+}
+
+[[nodiscard]]
+vector<byte> encode_with_thread_count(const frame_info& frame_info, const charls::interleave_mode interleave_mode,
+                                      const vector<byte>& source, const uint32_t thread_count,
+                                      const uint32_t restart_interval = 0)
+{
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info)
+        .interleave_mode(interleave_mode)
+        .restart_interval(restart_interval)
+        .thread_count(thread_count);
+    vector<byte> destination(encoder.estimated_destination_size());
+    encoder.destination(destination);
+
+    destination.resize(encoder.encode(source));
+    return destination;
+}
+
+void encode_multi_threaded_and_compare(const frame_info& frame_info, const charls::interleave_mode interleave_mode,
+                                       const uint32_t restart_interval = 0)
+{
+    const vector<byte> source{create_noise_image(frame_info)};
+    const auto expected{encode_with_thread_count(frame_info, interleave_mode, source, 1, restart_interval)};
+
+    for (const uint32_t thread_count : {0U, 2U, 3U, 4U})
+    {
+        const auto encoded{encode_with_thread_count(frame_info, interleave_mode, source, thread_count, restart_interval)};
+        EXPECT_EQ(expected, encoded);
+    }
+
+    test_by_decoding(expected, frame_info, source.data(), source.size(), interleave_mode);
+}
+
+void encode_lines_and_compare(const frame_info& frame_info, const charls::interleave_mode interleave_mode,
+                              const uint32_t restart_interval = 0)
+{
+    const vector<byte> source{create_noise_image(frame_info)};
+    const auto expected{encode_with_thread_count(frame_info, interleave_mode, source, 1, restart_interval)};
+
+    const size_t stride{static_cast<size_t>(frame_info.width) * ((frame_info.bits_per_sample + 7) / 8) *
+                        (interleave_mode == interleave_mode::none ? 1 : frame_info.component_count)};
+    const uint32_t line_count{static_cast<uint32_t>(source.size() / stride)};
+    for (const uint32_t lines_per_call : {1U, 3U, frame_info.height + 1, line_count})
+    {
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info).interleave_mode(interleave_mode).restart_interval(restart_interval);
+        vector<byte> destination(encoder.estimated_destination_size());
+        encoder.destination(destination);
+
+        for (uint32_t line{}; line < line_count; line += lines_per_call)
+        {
+            const uint32_t count{std::min(lines_per_call, line_count - line)};
+            ignore = encoder.encode_lines(source.data() + (line * stride), count * stride, count);
+        }
+
+        destination.resize(encoder.bytes_written());
+        EXPECT_EQ(expected, destination);
+    }
+}
+
+vector<byte> encode_tiles(const frame_info& frame_info, const charls::interleave_mode interleave_mode,
+                          const vector<byte>& source, const uint32_t tile_width, const uint32_t tile_height,
+                          vector<tile_info>& tiles, const uint32_t thread_count)
+{
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info).interleave_mode(interleave_mode).thread_count(thread_count);
+    vector<byte> destination(encoder.estimated_tiles_destination_size(tile_width, tile_height));
+    encoder.destination(destination);
+    destination.resize(encoder.encode_tiles(source, tile_width, tile_height, tiles));
+    return destination;
+}
+
+void encode_tiles_and_compare(const frame_info& frame_info, const charls::interleave_mode interleave_mode,
+                              const uint32_t tile_width, const uint32_t tile_height)
+{
+    const vector<byte> source{create_noise_image(frame_info)};
+    const size_t tile_column_count{(frame_info.width + tile_width - 1) / tile_width};
+    const size_t tile_row_count{(frame_info.height + tile_height - 1) / tile_height};
+    vector<tile_info> tiles(tile_column_count * tile_row_count);
+    const auto encoded{encode_tiles(frame_info, interleave_mode, source, tile_width, tile_height, tiles, 1)};
+
+    const size_t bytes_per_sample{(static_cast<size_t>(frame_info.bits_per_sample) + 7) / 8};
+    const size_t pixel_size{interleave_mode == interleave_mode::none ? bytes_per_sample
+                                                                     : bytes_per_sample * frame_info.component_count};
+    const size_t stride{frame_info.width * pixel_size};
+    const int32_t plane_count{interleave_mode == interleave_mode::none ? frame_info.component_count : 1};
+    size_t expected_offset{};
+    for (const auto& tile : tiles)
+    {
+        EXPECT_EQ(expected_offset, tile.offset);
+        expected_offset += tile.size;
+
+        // Every tile must be an independent JPEG-LS byte stream that holds its part of the image.
+        const vector<byte> tile_source(encoded.cbegin() + static_cast<ptrdiff_t>(tile.offset),
+                                       encoded.cbegin() + static_cast<ptrdiff_t>(tile.offset + tile.size));
+        vector<byte> expected;
+        for (int32_t plane{}; plane != plane_count; ++plane)
+        {
+            for (uint32_t y{tile.y}; y != tile.y + tile.height; ++y)
+            {
+                const auto line{source.cbegin() +
+                                static_cast<ptrdiff_t>((plane * stride * frame_info.height) + (y * stride) +
+                                                       (tile.x * pixel_size))};
+                expected.insert(expected.end(), line, line + static_cast<ptrdiff_t>(tile.width * pixel_size));
+            }
+        }
+        test_by_decoding(tile_source,
+                         {tile.width, tile.height, frame_info.bits_per_sample, frame_info.component_count},
+                         expected.data(), expected.size(), interleave_mode);
+    }
+    EXPECT_EQ(expected_offset, encoded.size());
+
+    vector<tile_info> tiles_multi_threaded(tiles.size());
+    EXPECT_EQ(encoded,
+              encode_tiles(frame_info, interleave_mode, source, tile_width, tile_height, tiles_multi_threaded, 4));
+    for (size_t i{}; i != tiles.size(); ++i)
+    {
+        EXPECT_EQ(tiles[i].offset, tiles_multi_threaded[i].offset);
+        EXPECT_EQ(tiles[i].size, tiles_multi_threaded[i].size);
+    }
+}
+
+void encode_to_handler_and_compare(const frame_info& frame_info, const charls::interleave_mode interleave_mode,
+                                   const uint32_t restart_interval = 0)
+{
+    const vector<byte> source{create_noise_image(frame_info)};
+    const auto expected{encode_with_thread_count(frame_info, interleave_mode, source, 1, restart_interval)};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info).interleave_mode(interleave_mode).restart_interval(restart_interval).thread_count(0);
+    vector<byte> destination;
+    encoder.destination([&destination](const void* data, const size_t size) {
+        const auto* bytes{static_cast<const byte*>(data)};
+        destination.insert(destination.end(), bytes, bytes + size);
+    });
+
+    const size_t bytes_written{encoder.encode(source)};
+
+    EXPECT_EQ(expected.size(), bytes_written);
+    EXPECT_EQ(expected, destination);
+}
+
 // ReSharper disable CppPassValueParameterByConstReference (iterators are not simple pointers in debug builds)
 [[nodiscard]]
 vector<byte>::const_iterator find_first_lse_segment(const vector<byte>::const_iterator begin,
@@ -1779,6 +1991,41 @@ TEST(jpegls_encoder_test, rewind)
     ASSERT_TRUE(destination_backup == destination);
 }
 
+TEST(jpegls_encoder_test, rewind_and_encode_other_image)
+{
+    // After a rewind the scan encoder is reused when the parameters are identical: its state must be reset.
+    constexpr frame_info frame_info{33, 17, 8, 3};
+    const vector<byte> source1{create_noise_image(frame_info)};
+    const vector<byte> source2(source1.rbegin(), source1.rend());
+    const auto expected{encode_with_thread_count(frame_info, interleave_mode::sample, source2, 1, 4)};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info).interleave_mode(interleave_mode::sample).restart_interval(4).near_lossless(0);
+    vector<byte> destination(encoder.estimated_destination_size());
+    encoder.destination(destination);
+    ignore = encoder.encode(source1);
+
+    encoder.rewind();
+    destination.resize(encoder.encode(source2));
+    EXPECT_EQ(expected, destination);
+
+    // Other parameters require a new scan encoder.
+    jpegls_encoder near_lossless_encoder;
+    near_lossless_encoder.frame_info(frame_info)
+        .interleave_mode(interleave_mode::sample)
+        .restart_interval(4)
+        .near_lossless(2);
+    vector<byte> expected_near_lossless(near_lossless_encoder.estimated_destination_size());
+    near_lossless_encoder.destination(expected_near_lossless);
+    expected_near_lossless.resize(near_lossless_encoder.encode(source1));
+
+    destination.resize(encoder.estimated_destination_size());
+    encoder.rewind();
+    encoder.destination(destination).near_lossless(2);
+    destination.resize(encoder.encode(source1));
+    EXPECT_EQ(expected_near_lossless, destination);
+}
+
 TEST(jpegls_encoder_test, rewind_before_destination)
 {
     constexpr array source{byte{0}, byte{1}, byte{2}, byte{3}, byte{4}, byte{5}};
@@ -2095,6 +2342,276 @@ TEST(jpegls_encoder_test, encode_lossy_with_color_transformations_throws)
                             [&encoder, &source] { ignore = encoder.encode(source); });
 }
 
+TEST(jpegls_encoder_test, encode_with_restart_interval_writes_dri_segment)
+{
+    constexpr array source{byte{0}, byte{1}, byte{2}, byte{3}, byte{4}, byte{5}};
+    constexpr frame_info frame_info{2, 3, 8, 1};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info).restart_interval(1);
+    vector<byte> destination(encoder.estimated_destination_size());
+    encoder.destination(destination);
+
+    const size_t bytes_written{encoder.encode(source)};
+    destination.resize(bytes_written);
+
+    constexpr array dri_segment{byte{0xFF}, byte{0xDD}, byte{}, byte{4}, byte{}, byte{1}};
+    EXPECT_NE(destination.cend(),
+              std::search(destination.cbegin(), destination.cend(), dri_segment.cbegin(), dri_segment.cend()));
+    EXPECT_EQ(size_t{2}, count_restart_markers(destination));
+    test_by_decoding(destination, frame_info, source.data(), source.size(), interleave_mode::none);
+}
+
+TEST(jpegls_encoder_test, encode_without_restart_interval_writes_no_dri_segment)
+{
+    constexpr array source{byte{0}, byte{1}, byte{2}, byte{3}, byte{4}, byte{5}};
+    constexpr frame_info frame_info{2, 3, 8, 1};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info);
+    vector<byte> destination(encoder.estimated_destination_size());
+    encoder.destination(destination);
+
+    const size_t bytes_written{encoder.encode(source)};
+    destination.resize(bytes_written);
+
+    constexpr array dri_marker{byte{0xFF}, byte{0xDD}};
+    EXPECT_EQ(destination.cend(),
+              std::search(destination.cbegin(), destination.cend(), dri_marker.cbegin(), dri_marker.cend()));
+    EXPECT_EQ(size_t{}, count_restart_markers(destination));
+}
+
+TEST(jpegls_encoder_test, encode_monochrome_8_bit_with_restart_interval)
+{
+    encode_with_restart_interval({67, 45, 8, 1}, interleave_mode::none, 7);
+}
+
+TEST(jpegls_encoder_test, encode_monochrome_16_bit_with_restart_interval)
+{
+    encode_with_restart_interval({33, 40, 16, 1}, interleave_mode::none, 1);
+}
+
+TEST(jpegls_encoder_test, encode_monochrome_12_bit_near_lossless_with_restart_interval)
+{
+    encode_with_restart_interval({31, 40, 12, 1}, interleave_mode::none, 3, 2);
+}
+
+TEST(jpegls_encoder_test, encode_color_8_bit_interleave_none_with_restart_interval)
+{
+    encode_with_restart_interval({32, 32, 8, 3}, interleave_mode::none, 5);
+}
+
+TEST(jpegls_encoder_test, encode_color_8_bit_interleave_line_with_restart_interval)
+{
+    encode_with_restart_interval({32, 32, 8, 3}, interleave_mode::line, 4);
+}
+
+TEST(jpegls_encoder_test, encode_color_16_bit_interleave_sample_with_restart_interval)
+{
+    encode_with_restart_interval({19, 32, 16, 3}, interleave_mode::sample, 6);
+}
+
+TEST(jpegls_encoder_test, encode_4_components_10_bit_interleave_sample_with_restart_interval)
+{
+    encode_with_restart_interval({19, 32, 10, 4}, interleave_mode::sample, 2);
+}
+
+TEST(jpegls_encoder_test, encode_with_restart_interval_larger_than_height)
+{
+    encode_with_restart_interval({20, 10, 8, 1}, interleave_mode::none, 100'000);
+}
+
+TEST(jpegls_encoder_test, estimated_destination_size_includes_restart_markers)
+{
+    constexpr frame_info frame_info{1, 1000, 8, 1};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info);
+    const size_t size_without_restart_interval{encoder.estimated_destination_size()};
+    encoder.restart_interval(1);
+
+    EXPECT_GE(encoder.estimated_destination_size(), size_without_restart_interval + (frame_info.height * 4));
+}
+
+TEST(jpegls_encoder_test, encode_interleave_none_multi_threaded)
+{
+    encode_multi_threaded_and_compare({64, 48, 16, 4}, interleave_mode::none);
+    encode_multi_threaded_and_compare({33, 17, 8, 3}, interleave_mode::none);
+    encode_multi_threaded_and_compare({33, 17, 12, 2}, interleave_mode::none, 5);
+}
+
+TEST(jpegls_encoder_test, encode_interleave_sample_multi_threaded)
+{
+    encode_multi_threaded_and_compare({33, 17, 8, 3}, interleave_mode::sample);
+}
+
+TEST(jpegls_encoder_test, encode_interleaved_with_conversion_thread)
+{
+    encode_multi_threaded_and_compare({33, 17, 8, 3}, interleave_mode::line);
+    encode_multi_threaded_and_compare({64, 48, 8, 3}, interleave_mode::line, 7);
+    encode_multi_threaded_and_compare({64, 48, 16, 4}, interleave_mode::sample, 5);
+    encode_multi_threaded_and_compare({17, 2, 12, 2}, interleave_mode::sample, 1);
+}
+
+TEST(jpegls_encoder_test, encode_restart_intervals_multi_threaded)
+{
+    encode_multi_threaded_and_compare({64, 100, 16, 1}, interleave_mode::none, 8);
+    encode_multi_threaded_and_compare({64, 100, 16, 1}, interleave_mode::none, 99);
+    encode_multi_threaded_and_compare({31, 77, 8, 1}, interleave_mode::none, 3);
+    encode_multi_threaded_and_compare({31, 40, 12, 2}, interleave_mode::none, 1);
+    encode_multi_threaded_and_compare({33, 40, 8, 3}, interleave_mode::line, 6);
+    encode_multi_threaded_and_compare({33, 40, 8, 3}, interleave_mode::sample, 11);
+}
+
+TEST(jpegls_encoder_test, encode_restart_intervals_multi_threaded_with_color_transformation_and_near_lossless)
+{
+    constexpr frame_info frame_info{100, 60, 8, 3};
+    const vector<byte> source{create_noise_image(frame_info)};
+
+    const auto encode{[&frame_info, &source](const uint32_t thread_count) {
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info)
+            .interleave_mode(interleave_mode::sample)
+            .color_transformation(color_transformation::hp1)
+            .restart_interval(9)
+            .thread_count(thread_count);
+        vector<byte> destination(encoder.estimated_destination_size());
+        encoder.destination(destination);
+        destination.resize(encoder.encode(source));
+        return destination;
+    }};
+
+    const auto expected{encode(1)};
+    EXPECT_EQ(expected, encode(3));
+    EXPECT_EQ(expected, encode(8));
+    test_by_decoding(expected, frame_info, source.data(), source.size(), interleave_mode::sample,
+                     color_transformation::hp1);
+
+    jpegls_encoder encoder;
+    encoder.frame_info({100, 60, 16, 1}).near_lossless(2).restart_interval(4);
+    const vector<byte> source16{create_noise_image({100, 60, 16, 1})};
+    vector<byte> expected_near_lossless(encoder.estimated_destination_size());
+    encoder.destination(expected_near_lossless);
+    expected_near_lossless.resize(encoder.encode(source16));
+
+    encoder.rewind();
+    encoder.thread_count(4);
+    vector<byte> destination(encoder.estimated_destination_size());
+    encoder.destination(destination);
+    destination.resize(encoder.encode(source16));
+    EXPECT_EQ(expected_near_lossless, destination);
+}
+
+TEST(jpegls_encoder_test, encode_restart_intervals_multi_threaded_with_small_destination)
+{
+    // A flat image compresses very well: the encoded intervals are much smaller than the parts used to encode them
+    // concurrently. The encoder should fall back to encode the scan sequentially.
+    constexpr frame_info frame_info{100, 100, 16, 1};
+    const vector<byte> source(static_cast<size_t>(frame_info.width) * frame_info.height * 2);
+    const auto expected{encode_with_thread_count(frame_info, interleave_mode::none, source, 1, 10)};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info).restart_interval(10).thread_count(4);
+    vector<byte> destination(expected.size() + 64);
+    encoder.destination(destination);
+    destination.resize(encoder.encode(source));
+
+    EXPECT_EQ(expected, destination);
+}
+
+TEST(jpegls_encoder_test, encode_restart_intervals_with_very_large_thread_count)
+{
+    // The number of created threads is limited to the number of hardware threads.
+    constexpr frame_info frame_info{100, 1000, 8, 1};
+    const vector<byte> source{create_noise_image(frame_info)};
+    const auto expected{encode_with_thread_count(frame_info, interleave_mode::none, source, 1, 1)};
+
+    EXPECT_EQ(expected, encode_with_thread_count(frame_info, interleave_mode::none, source, 100000, 1));
+}
+
+TEST(jpegls_encoder_test, encode_color_transformation_with_conversion_thread)
+{
+    constexpr frame_info frame_info{100, 60, 8, 3};
+    const vector<byte> source{create_noise_image(frame_info)};
+
+    const auto encode{[&frame_info, &source](const uint32_t thread_count) {
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info)
+            .interleave_mode(interleave_mode::line)
+            .color_transformation(color_transformation::hp2)
+            .thread_count(thread_count);
+        vector<byte> destination(encoder.estimated_destination_size());
+        encoder.destination(destination);
+        destination.resize(encoder.encode(source));
+        return destination;
+    }};
+
+    const auto expected{encode(1)};
+    EXPECT_EQ(expected, encode(2));
+    EXPECT_EQ(expected, encode(0));
+    test_by_decoding(expected, frame_info, source.data(), source.size(), interleave_mode::line, color_transformation::hp2);
+}
+
+TEST(jpegls_encoder_test, encode_interleave_none_multi_threaded_with_small_destination)
+{
+    // A flat image compresses very well: the exact encoded size is much smaller than the space needed to encode
+    // the scans concurrently. The encoder should fall back to encode the scans sequentially.
+    constexpr frame_info frame_info{100, 100, 8, 3};
+    const vector<byte> source(static_cast<size_t>(frame_info.width) * frame_info.height * frame_info.component_count);
+    const auto expected{encode_with_thread_count(frame_info, interleave_mode::none, source, 1)};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info).interleave_mode(interleave_mode::none).thread_count(4);
+    vector<byte> destination(expected.size() + 64);
+    encoder.destination(destination);
+    destination.resize(encoder.encode(source));
+
+    EXPECT_EQ(expected, destination);
+}
+
+TEST(jpegls_encoder_test, encode_components_multi_threaded)
+{
+    constexpr frame_info frame_info{37, 11, 8, 4};
+    const vector<byte> source{create_noise_image(frame_info)};
+    const auto expected{encode_with_thread_count(frame_info, interleave_mode::none, source, 1)};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info).interleave_mode(interleave_mode::none).thread_count(2);
+    vector<byte> destination(encoder.estimated_destination_size());
+    encoder.destination(destination);
+    const size_t plane_size{static_cast<size_t>(frame_info.width) * frame_info.height};
+    encoder.encode_components(source.data(), 3 * plane_size, 3);
+    encoder.encode_components(source.data() + (3 * plane_size), plane_size, 1);
+    destination.resize(encoder.bytes_written());
+
+    EXPECT_EQ(expected, destination);
+}
+
+TEST(jpegls_encoder_test, estimated_destination_size_multi_threaded_interleave_none)
+{
+    constexpr frame_info frame_info{100, 100, 16, 4};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info).interleave_mode(interleave_mode::none);
+    const size_t size_single_threaded{encoder.estimated_destination_size()};
+    encoder.thread_count(4);
+
+    EXPECT_GT(encoder.estimated_destination_size(), size_single_threaded);
+}
+
+TEST(jpegls_encoder_test, estimated_destination_size_thread_count_0_matches_hardware_concurrency)
+{
+    constexpr frame_info frame_info{100, 100, 16, 4};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info).interleave_mode(interleave_mode::none).restart_interval(10);
+    encoder.thread_count(std::max(std::thread::hardware_concurrency(), 1U));
+    const size_t size_hardware_concurrency{encoder.estimated_destination_size()};
+    encoder.thread_count(0);
+
+    EXPECT_EQ(size_hardware_concurrency, encoder.estimated_destination_size());
+}
+
 TEST(jpegls_encoder_test, encode_planar_with_color_transformations_throws)
 {
     constexpr frame_info frame_info{2, 1, 8, 3};
@@ -2107,6 +2624,439 @@ TEST(jpegls_encoder_test, encode_planar_with_color_transformations_throws)
                             [&encoder, &source] { ignore = encoder.encode(source); });
 }
 
+TEST(jpegls_encoder_test, encode_lines)
+{
+    encode_lines_and_compare({33, 17, 8, 1}, interleave_mode::none);
+    encode_lines_and_compare({33, 17, 16, 3}, interleave_mode::none);
+    encode_lines_and_compare({33, 17, 8, 3}, interleave_mode::line);
+    encode_lines_and_compare({33, 17, 12, 3}, interleave_mode::sample);
+}
+
+TEST(jpegls_encoder_test, encode_lines_with_restart_interval)
+{
+    encode_lines_and_compare({33, 17, 8, 3}, interleave_mode::none, 4);
+    encode_lines_and_compare({33, 17, 8, 3}, interleave_mode::line, 1);
+    encode_lines_and_compare({33, 17, 10, 4}, interleave_mode::sample, 5);
+}
+
+TEST(jpegls_encoder_test, encode_tiles)
+{
+    encode_tiles_and_compare({64, 64, 8, 1}, interleave_mode::none, 32, 32);
+    encode_tiles_and_compare({70, 45, 8, 1}, interleave_mode::none, 32, 16);
+    encode_tiles_and_compare({70, 45, 16, 3}, interleave_mode::none, 16, 32);
+    encode_tiles_and_compare({70, 45, 8, 3}, interleave_mode::line, 32, 20);
+    encode_tiles_and_compare({70, 45, 12, 4}, interleave_mode::sample, 25, 45);
+    encode_tiles_and_compare({70, 45, 8, 3}, interleave_mode::sample, 100, 100);
+}
+
+TEST(jpegls_encoder_test, encode_tiles_with_mapping_table_ids)
+{
+    constexpr frame_info frame_info{64, 64, 8, 3};
+    const vector<byte> source{create_noise_image(frame_info)};
+
+    for (const uint32_t thread_count : {1U, 2U})
+    {
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info).thread_count(thread_count);
+        encoder.set_mapping_table_id(0, 3).set_mapping_table_id(2, 7);
+        vector<byte> destination(encoder.estimated_tiles_destination_size(32, 32));
+        encoder.destination(destination);
+        vector<tile_info> tiles(4);
+        destination.resize(encoder.encode_tiles(source, 32, 32, tiles));
+
+        for (const auto& tile : tiles)
+        {
+            jpegls_decoder decoder{destination.data() + tile.offset, tile.size};
+            vector<byte> decoded(decoder.get_destination_size());
+            decoder.decode(decoded);
+            EXPECT_EQ(3, decoder.get_mapping_table_id(0));
+            EXPECT_EQ(0, decoder.get_mapping_table_id(1));
+            EXPECT_EQ(7, decoder.get_mapping_table_id(2));
+        }
+    }
+}
+
+TEST(jpegls_encoder_test, encode_tiles_with_too_small_tiles_array_throws)
+{
+    constexpr frame_info frame_info{64, 64, 8, 1};
+    const vector<byte> source(static_cast<size_t>(frame_info.width) * frame_info.height);
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info);
+    vector<byte> destination(encoder.estimated_tiles_destination_size(32, 32));
+    encoder.destination(destination);
+    vector<tile_info> tiles(3);
+
+    assert_expect_exception(jpegls_errc::invalid_argument_size,
+                            [&encoder, &source, &tiles] { ignore = encoder.encode_tiles(source, 32, 32, tiles); });
+}
+
+TEST(jpegls_encoder_test, encode_tiles_with_zero_tile_width_throws)
+{
+    constexpr frame_info frame_info{64, 64, 8, 1};
+    const vector<byte> source(static_cast<size_t>(frame_info.width) * frame_info.height);
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info);
+    vector<byte> destination(1000);
+    encoder.destination(destination);
+    vector<tile_info> tiles(4);
+
+    assert_expect_exception(jpegls_errc::invalid_argument,
+                            [&encoder, &source, &tiles] { ignore = encoder.encode_tiles(source, 0, 32, tiles); });
+    assert_expect_exception(jpegls_errc::invalid_argument,
+                            [&encoder] { ignore = encoder.estimated_tiles_destination_size(32, 0); });
+}
+
+TEST(jpegls_encoder_test, encode_tiles_to_handler_throws)
+{
+    constexpr frame_info frame_info{64, 64, 8, 1};
+    const vector<byte> source(static_cast<size_t>(frame_info.width) * frame_info.height);
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info).destination([](const void*, size_t) noexcept {});
+    vector<tile_info> tiles(4);
+
+    assert_expect_exception(jpegls_errc::invalid_operation,
+                            [&encoder, &source, &tiles] { ignore = encoder.encode_tiles(source, 32, 32, tiles); });
+}
+
+TEST(jpegls_encoder_test, encode_tiles_multi_threaded_with_small_destination)
+{
+    // A flat image compresses very well: the encoded tiles don't fit in the parts used to encode them concurrently.
+    constexpr frame_info frame_info{100, 100, 8, 3};
+    const vector<byte> source(static_cast<size_t>(frame_info.width) * frame_info.height * frame_info.component_count);
+    vector<tile_info> tiles(4);
+    const auto expected{encode_tiles(frame_info, interleave_mode::sample, source, 50, 50, tiles, 1)};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info).interleave_mode(interleave_mode::sample).thread_count(4);
+    vector<byte> destination(expected.size() + 64);
+    encoder.destination(destination);
+    destination.resize(encoder.encode_tiles(source, 50, 50, tiles));
+
+    EXPECT_EQ(expected, destination);
+}
+
+TEST(jpegls_encoder_test, encode_batch)
+{
+    const array<frame_info, 4> frame_infos{{{64, 64, 8, 3}, {33, 17, 16, 3}, {64, 64, 8, 3}, {70, 45, 12, 3}}};
+    vector<vector<byte>> sources;
+    vector<vector<byte>> destinations;
+    for (const auto& frame_info : frame_infos)
+    {
+        sources.push_back(create_noise_image(frame_info));
+    }
+
+    for (const uint32_t thread_count : {1U, 0U, 3U, 100000U})
+    {
+        jpegls_encoder encoder;
+        encoder.interleave_mode(interleave_mode::sample).near_lossless(2).thread_count(thread_count);
+
+        vector<batch_item> items(frame_infos.size());
+        destinations.resize(frame_infos.size());
+        for (size_t i{}; i < items.size(); ++i)
+        {
+            destinations[i].assign(sources[i].size() + 1024, byte{});
+            items[i].source = sources[i].data();
+            items[i].source_size = sources[i].size();
+            items[i].destination = destinations[i].data();
+            items[i].destination_size = destinations[i].size();
+            items[i].frame_info = frame_infos[i];
+        }
+
+        encoder.encode_batch(items);
+
+        for (size_t i{}; i < items.size(); ++i)
+        {
+            ASSERT_EQ(jpegls_errc::success, items[i].error);
+            destinations[i].resize(items[i].bytes_written);
+
+            jpegls_encoder expected_encoder;
+            expected_encoder.frame_info(frame_infos[i]).interleave_mode(interleave_mode::sample).near_lossless(2);
+            vector<byte> expected(expected_encoder.estimated_destination_size());
+            expected_encoder.destination(expected);
+            expected.resize(expected_encoder.encode(sources[i]));
+            EXPECT_EQ(expected, destinations[i]);
+        }
+    }
+}
+
+TEST(jpegls_encoder_test, encode_batch_reports_error_per_item)
+{
+    constexpr frame_info frame_info{64, 64, 8, 1};
+    const vector<byte> source{create_noise_image(frame_info)};
+    vector<byte> destination1(10000);
+    vector<byte> destination2(100);
+    vector<byte> destination3(10000);
+
+    array<batch_item, 3> items{};
+    items[0] = {source.data(), source.size(), destination1.data(), destination1.size(), 0, frame_info, 0, {}};
+    items[1] = {source.data(), source.size(), destination2.data(), destination2.size(), 0, frame_info, 0, {}};
+    items[2] = {source.data(), source.size() - 1, destination3.data(), destination3.size(), 0, frame_info, 0, {}};
+
+    const jpegls_encoder encoder;
+    encoder.encode_batch(items);
+
+    EXPECT_EQ(jpegls_errc::success, items[0].error);
+    test_by_decoding({destination1.cbegin(), destination1.cbegin() + static_cast<ptrdiff_t>(items[0].bytes_written)},
+                     frame_info, source.data(), source.size(), interleave_mode::none);
+    EXPECT_EQ(jpegls_errc::destination_too_small, items[1].error);
+    EXPECT_EQ(0U, items[1].bytes_written);
+    EXPECT_EQ(jpegls_errc::invalid_argument_size, items[2].error);
+    EXPECT_EQ(0U, items[2].bytes_written);
+}
+
+TEST(jpegls_encoder_test, encode_empty_batch)
+{
+    const jpegls_encoder encoder;
+    encoder.encode_batch(nullptr, 0);
+
+    vector<batch_item> items;
+    encoder.encode_batch(items);
+}
+
+TEST(jpegls_encoder_test, encode_lines_writes_bytes_progressively)
+{
+    constexpr frame_info frame_info{64, 64, 8, 1};
+    const vector<byte> source{create_noise_image(frame_info)};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info);
+    vector<byte> destination(encoder.estimated_destination_size());
+    encoder.destination(destination);
+
+    size_t previous_bytes_written{};
+    for (uint32_t line{}; line < frame_info.height; line += 16)
+    {
+        const size_t bytes_written{encoder.encode_lines(source.data() + (line * size_t{frame_info.width}),
+                                                        16 * size_t{frame_info.width}, 16)};
+        EXPECT_GT(bytes_written, previous_bytes_written);
+        previous_bytes_written = bytes_written;
+    }
+
+    destination.resize(previous_bytes_written);
+    test_by_decoding(destination, frame_info, source.data(), source.size(), interleave_mode::none);
+}
+
+TEST(jpegls_encoder_test, encode_lines_with_too_many_lines_throws)
+{
+    constexpr frame_info frame_info{4, 4, 8, 1};
+    const vector<byte> source(20);
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info);
+    vector<byte> destination(encoder.estimated_destination_size());
+    encoder.destination(destination);
+
+    ignore = encoder.encode_lines(source.data(), 8, 2);
+    assert_expect_exception(jpegls_errc::invalid_argument,
+                            [&encoder, &source] { ignore = encoder.encode_lines(source, 3); });
+    assert_expect_exception(jpegls_errc::invalid_argument,
+                            [&encoder, &source] { ignore = encoder.encode_lines(source, 0); });
+}
+
+TEST(jpegls_encoder_test, encode_lines_with_too_small_source_throws)
+{
+    constexpr frame_info frame_info{4, 4, 8, 1};
+    const vector<byte> source(7);
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info);
+    vector<byte> destination(encoder.estimated_destination_size());
+    encoder.destination(destination);
+
+    assert_expect_exception(jpegls_errc::invalid_argument_size,
+                            [&encoder, &source] { ignore = encoder.encode_lines(source, 2); });
+}
+
+TEST(jpegls_encoder_test, encode_after_encode_lines_throws)
+{
+    constexpr frame_info frame_info{4, 4, 8, 1};
+    const vector<byte> source(16);
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info);
+    vector<byte> destination(encoder.estimated_destination_size());
+    encoder.destination(destination);
+
+    ignore = encoder.encode_lines(source, 1);
+    assert_expect_exception(jpegls_errc::invalid_operation, [&encoder, &source] { ignore = encoder.encode(source); });
+}
+
+TEST(jpegls_encoder_test, encode_to_handler)
+{
+    encode_to_handler_and_compare({33, 17, 8, 1}, interleave_mode::none);
+    encode_to_handler_and_compare({512, 256, 8, 3}, interleave_mode::none);
+    encode_to_handler_and_compare({256, 256, 16, 3}, interleave_mode::line);
+    encode_to_handler_and_compare({300, 200, 12, 4}, interleave_mode::sample);
+}
+
+TEST(jpegls_encoder_test, encode_to_handler_with_restart_interval)
+{
+    encode_to_handler_and_compare({512, 256, 8, 3}, interleave_mode::none, 7);
+    encode_to_handler_and_compare({300, 200, 8, 3}, interleave_mode::sample, 1);
+}
+
+TEST(jpegls_encoder_test, encode_to_handler_with_wide_image)
+{
+    // A single encoded line can be larger than the default buffer: the buffer should be enlarged.
+    encode_to_handler_and_compare({20'000, 2, 16, 4}, interleave_mode::sample);
+}
+
+TEST(jpegls_encoder_test, encode_lines_to_handler)
+{
+    constexpr frame_info frame_info{1024, 256, 8, 1};
+    const vector<byte> source{create_noise_image(frame_info)};
+    const auto expected{encode_with_thread_count(frame_info, interleave_mode::none, source, 1)};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info);
+    vector<byte> destination;
+    encoder.destination([&destination](const void* data, const size_t size) {
+        const auto* bytes{static_cast<const byte*>(data)};
+        destination.insert(destination.end(), bytes, bytes + size);
+    });
+
+    for (uint32_t line{}; line < frame_info.height; ++line)
+    {
+        ignore = encoder.encode_lines(source.data() + (line * size_t{frame_info.width}), frame_info.width, 1);
+
+        // The handler should receive the encoded bytes while the image is encoded.
+        if (line == frame_info.height / 2)
+        {
+            EXPECT_FALSE(destination.empty());
+        }
+    }
+
+    EXPECT_EQ(expected, destination);
+}
+
+TEST(jpegls_encoder_test, encode_to_handler_with_even_destination_size)
+{
+    constexpr frame_info frame_info{1, 1, 8, 1};
+    const vector<byte> source{byte{}};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info).encoding_options(encoding_options::even_destination_size);
+    vector<byte> destination;
+    encoder.destination([&destination](const void* data, const size_t size) {
+        const auto* bytes{static_cast<const byte*>(data)};
+        destination.insert(destination.end(), bytes, bytes + size);
+    });
+    ignore = encoder.encode(source);
+
+    EXPECT_EQ(0U, destination.size() % 2);
+    EXPECT_EQ(destination.size(), encoder.bytes_written());
+}
+
+TEST(jpegls_encoder_test, encode_to_handler_that_throws)
+{
+    constexpr frame_info frame_info{512, 256, 8, 1};
+    const vector<byte> source{create_noise_image(frame_info)};
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info);
+    encoder.destination([](const void*, size_t) { throw std::runtime_error("something failed"); });
+
+    assert_expect_exception(jpegls_errc::callback_failed, [&encoder, &source] { ignore = encoder.encode(source); });
+}
+
+TEST(jpegls_encoder_test, set_destination_handler_after_encode_throws)
+{
+    constexpr frame_info frame_info{4, 4, 8, 1};
+    const vector<byte> source(16);
+
+    jpegls_encoder encoder;
+    encoder.frame_info(frame_info);
+    vector<byte> destination(encoder.estimated_destination_size());
+    encoder.destination(destination);
+    ignore = encoder.encode(source);
+
+    assert_expect_exception(jpegls_errc::invalid_operation,
+                            [&encoder] { ignore = encoder.destination([](const void*, size_t) noexcept {}); });
+}
+
+TEST(jpegls_encoder_test, encode_with_allocator)
+{
+    constexpr frame_info frame_info{33, 17, 8, 3};
+    const vector<byte> source{create_noise_image(frame_info)};
+    const auto expected{encode_with_thread_count(frame_info, interleave_mode::line, source, 1, 0)};
+
+    allocation_statistics statistics;
+    {
+        jpegls_encoder encoder{counting_allocate, counting_deallocate, &statistics};
+        encoder.frame_info(frame_info).interleave_mode(interleave_mode::line);
+        vector<byte> destination(encoder.estimated_destination_size());
+        encoder.destination(destination);
+        destination.resize(encoder.encode(source));
+
+        EXPECT_EQ(expected, destination);
+        EXPECT_GT(statistics.allocated_size, size_t{});
+    }
+
+    EXPECT_GT(statistics.allocation_count, size_t{1});
+    EXPECT_EQ(size_t{}, statistics.allocated_size);
+}
+
+TEST(jpegls_encoder_test, encode_to_handler_with_allocator)
+{
+    constexpr frame_info frame_info{33, 17, 8, 3};
+    const vector<byte> source{create_noise_image(frame_info)};
+    const auto expected{encode_with_thread_count(frame_info, interleave_mode::sample, source, 1, 0)};
+
+    allocation_statistics statistics;
+    {
+        jpegls_encoder encoder{counting_allocate, counting_deallocate, &statistics};
+        vector<byte> destination;
+        encoder.frame_info(frame_info).interleave_mode(interleave_mode::sample);
+        encoder.destination([&destination](const void* data, const size_t size) {
+            const auto* bytes{static_cast<const byte*>(data)};
+            destination.insert(destination.end(), bytes, bytes + size);
+        });
+        ignore = encoder.encode(source);
+
+        EXPECT_EQ(expected, destination);
+    }
+
+    EXPECT_EQ(size_t{}, statistics.allocated_size);
+}
+
+TEST(jpegls_encoder_test, encode_with_failing_allocator)
+{
+    constexpr frame_info frame_info{33, 17, 8, 3};
+    const vector<byte> source{create_noise_image(frame_info)};
+
+    // Let every allocation fail once: the encoder should report it and not leak memory.
+    for (size_t allocation_limit{};; ++allocation_limit)
+    {
+        allocation_statistics statistics;
+        statistics.allocation_limit = allocation_limit;
+        bool encoded{};
+        try
+        {
+            jpegls_encoder encoder{counting_allocate, counting_deallocate, &statistics};
+            encoder.frame_info(frame_info).interleave_mode(interleave_mode::none);
+            vector<byte> destination(encoder.estimated_destination_size());
+            encoder.destination(destination);
+            ignore = encoder.encode(source);
+            encoded = true;
+        }
+        catch (const jpegls_error& error)
+        {
+            EXPECT_EQ(jpegls_errc::not_enough_memory, error.code());
+        }
+        catch (const std::bad_alloc&)
+        {
+            EXPECT_EQ(size_t{}, allocation_limit);
+        }
+
+        EXPECT_EQ(size_t{}, statistics.allocated_size);
+        if (encoded)
+            break;
+    }
+}
+
 } // namespace charls::test
 
 #ifdef __GNUC__
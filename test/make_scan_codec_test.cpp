@@ -0,0 +1,233 @@
+// SPDX-FileCopyrightText: © 2026 Team CharLS
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "pch.hpp"
+
+#include "../src/default_traits.hpp"
+#include "../src/jpegls_preset_coding_parameters.hpp"
+#include "../src/make_scan_codec.hpp"
+#include "../src/scan_decoder_impl.hpp"
+#include "../src/scan_encoder_impl.hpp"
+
+#include <random>
+#include <vector>
+
+using std::byte;
+using std::vector;
+
+namespace charls::test {
+
+namespace {
+
+struct codec_configuration final
+{
+    frame_info frame;
+    coding_parameters parameters;
+};
+
+vector<byte> create_test_image(const frame_info& frame)
+{
+    const size_t sample_size{frame.bits_per_sample > 8 ? size_t{2} : size_t{1}};
+    vector<byte> image(static_cast<size_t>(frame.width) * frame.height * frame.component_count * sample_size);
+
+    // Smooth gradients with noise, which exercises both the regular and the run mode.
+    std::mt19937 generator(static_cast<std::mt19937::result_type>(frame.bits_per_sample));
+    std::uniform_int_distribution<uint32_t> noise(0, 3);
+    const uint32_t maximum_sample_value{(1U << frame.bits_per_sample) - 1};
+    for (size_t i{}; i != image.size() / sample_size; ++i)
+    {
+        const uint32_t sample{i % 97 < 40 ? 0U : static_cast<uint32_t>((i * 13) + noise(generator)) & maximum_sample_value};
+        if (sample_size == 2)
+        {
+            image[i * 2] = static_cast<byte>(sample);
+            image[(i * 2) + 1] = static_cast<byte>(sample >> 8);
+        }
+        else
+        {
+            image[i] = static_cast<byte>(sample);
+        }
+    }
+
+    return image;
+}
+
+vector<byte> encode(const codec_configuration& configuration, const vector<byte>& source, const instruction_set isa)
+{
+    const auto& [frame, parameters]{configuration};
+    const auto pc_parameters{compute_default(calculate_maximum_bit_sample_value(frame.bits_per_sample),
+                                             parameters.near_lossless)};
+    const auto encoder{make_scan_codec<scan_encoder>(frame, pc_parameters, parameters, default_memory_resource(), isa)};
+
+    vector<byte> destination(source.size() * 2 + 1024);
+    const size_t stride{source.size() / frame.height};
+    destination.resize(encoder->encode_scan(source.data(), stride, {destination.data(), destination.size()}));
+    return destination;
+}
+
+vector<byte> decode(const codec_configuration& configuration, vector<byte> source, const size_t size,
+                    const instruction_set isa, const bool conversion_thread = false)
+{
+    const auto& [frame, parameters]{configuration};
+    const auto pc_parameters{compute_default(calculate_maximum_bit_sample_value(frame.bits_per_sample),
+                                             parameters.near_lossless)};
+    const auto decoder{make_scan_codec<scan_decoder>(frame, pc_parameters, parameters, default_memory_resource(), isa)};
+    decoder->use_conversion_thread(conversion_thread);
+
+    // The decoder requires the marker that follows the scan.
+    source.push_back(byte{0xFF});
+    source.push_back(byte{0xD9});
+
+    vector<byte> destination(size);
+    std::ignore = decoder->decode_scan({source.data(), source.size()}, destination.data(), size / frame.height);
+    return destination;
+}
+
+void check_codecs_are_equivalent(const codec_configuration& configuration)
+{
+    const vector<byte> image{create_test_image(configuration.frame)};
+
+    const vector<byte> baseline_encoded{encode(configuration, image, instruction_set::baseline)};
+    const vector<byte> x86_64_v3_encoded{encode(configuration, image, instruction_set::x86_64_v3)};
+    ASSERT_EQ(baseline_encoded, x86_64_v3_encoded);
+
+    const vector<byte> baseline_decoded{decode(configuration, baseline_encoded, image.size(), instruction_set::baseline)};
+    const vector<byte> x86_64_v3_decoded{
+        decode(configuration, baseline_encoded, image.size(), instruction_set::x86_64_v3)};
+    ASSERT_EQ(baseline_decoded, x86_64_v3_decoded);
+    if (configuration.parameters.near_lossless == 0)
+    {
+        ASSERT_EQ(image, baseline_decoded);
+    }
+}
+
+/// <summary>
+/// Verifies that the codec created by make_scan_codec (a lossless_traits or near_lossless_traits fast path) gives
+/// the same results as the generic default_traits codec.
+/// </summary>
+template<typename SampleType, typename PixelType>
+void check_codec_matches_default_traits(const codec_configuration& configuration)
+{
+    const auto& [frame, parameters]{configuration};
+    const vector<byte> image{create_test_image(frame)};
+    const auto maximum_sample_value{calculate_maximum_bit_sample_value(frame.bits_per_sample)};
+    const auto pc_parameters{compute_default(maximum_sample_value, parameters.near_lossless)};
+    const default_traits<SampleType, PixelType> traits{maximum_sample_value, parameters.near_lossless};
+    const size_t stride{image.size() / frame.height};
+
+    scan_encoder_impl<default_traits<SampleType, PixelType>> encoder{frame, pc_parameters, parameters, traits,
+                                                                    default_memory_resource()};
+    vector<byte> expected(image.size() * 2 + 1024);
+    expected.resize(encoder.encode_scan(image.data(), stride, {expected.data(), expected.size()}));
+    ASSERT_EQ(expected, encode(configuration, image, instruction_set::baseline));
+
+    vector<byte> source{expected};
+    source.push_back(byte{0xFF});
+    source.push_back(byte{0xD9});
+    scan_decoder_impl<default_traits<SampleType, PixelType>> decoder{frame, pc_parameters, parameters, traits,
+                                                                    default_memory_resource()};
+    vector<byte> expected_decoded(image.size());
+    std::ignore = decoder.decode_scan({source.data(), source.size()}, expected_decoded.data(), stride);
+    ASSERT_EQ(expected_decoded, decode(configuration, expected, image.size(), instruction_set::baseline));
+    if (parameters.near_lossless == 0)
+    {
+        ASSERT_EQ(image, expected_decoded);
+    }
+}
+
+void check_decode_with_conversion_thread(const codec_configuration& configuration)
+{
+    const vector<byte> image{create_test_image(configuration.frame)};
+    const vector<byte> encoded{encode(configuration, image, instruction_set::baseline)};
+
+    ASSERT_EQ(image, decode(configuration, encoded, image.size(), instruction_set::baseline, true));
+}
+
+} // namespace
+
+
+TEST(make_scan_codec_test, supported_instruction_set_can_create_codecs)
+{
+    const codec_configuration configuration{{64, 8, 8, 1}, {0, 0, interleave_mode::none, color_transformation::none}};
+    const auto pc_parameters{compute_default(255, 0)};
+
+    EXPECT_NE(nullptr, make_scan_codec<scan_encoder>(configuration.frame, pc_parameters, configuration.parameters,
+                                                     default_memory_resource()));
+    EXPECT_NE(nullptr, make_scan_codec<scan_decoder>(configuration.frame, pc_parameters, configuration.parameters,
+                                                     default_memory_resource()));
+}
+
+TEST(make_scan_codec_test, instruction_sets_give_identical_results_lossless)
+{
+    if (supported_instruction_set() != instruction_set::x86_64_v3)
+        GTEST_SKIP() << "CPU doesn't support the x86-64-v3 instruction set";
+
+    check_codecs_are_equivalent({{97, 31, 8, 1}, {0, 0, interleave_mode::none, color_transformation::none}});
+    check_codecs_are_equivalent({{97, 31, 12, 1}, {0, 0, interleave_mode::none, color_transformation::none}});
+    check_codecs_are_equivalent({{97, 31, 16, 1}, {0, 0, interleave_mode::none, color_transformation::none}});
+    check_codecs_are_equivalent({{97, 31, 8, 3}, {0, 0, interleave_mode::line, color_transformation::none}});
+    check_codecs_are_equivalent({{97, 31, 8, 3}, {0, 0, interleave_mode::sample, color_transformation::hp1}});
+    check_codecs_are_equivalent({{97, 31, 16, 4}, {0, 0, interleave_mode::sample, color_transformation::none}});
+    check_codecs_are_equivalent({{97, 31, 10, 1}, {0, 0, interleave_mode::none, color_transformation::none}});
+    check_codecs_are_equivalent({{97, 31, 10, 3}, {0, 0, interleave_mode::sample, color_transformation::none}});
+    check_codecs_are_equivalent({{97, 31, 12, 2}, {0, 0, interleave_mode::sample, color_transformation::none}});
+}
+
+TEST(make_scan_codec_test, lossless_10_and_12_bit_fast_paths_match_default_traits)
+{
+    check_codec_matches_default_traits<uint16_t, uint16_t>(
+        {{97, 31, 10, 1}, {0, 0, interleave_mode::none, color_transformation::none}});
+    check_codec_matches_default_traits<uint16_t, uint16_t>(
+        {{97, 31, 12, 1}, {0, 0, interleave_mode::none, color_transformation::none}});
+    check_codec_matches_default_traits<uint16_t, pair<uint16_t>>(
+        {{97, 31, 10, 2}, {0, 0, interleave_mode::sample, color_transformation::none}});
+    check_codec_matches_default_traits<uint16_t, triplet<uint16_t>>(
+        {{97, 31, 10, 3}, {0, 0, interleave_mode::sample, color_transformation::none}});
+    check_codec_matches_default_traits<uint16_t, quad<uint16_t>>(
+        {{97, 31, 10, 4}, {0, 0, interleave_mode::sample, color_transformation::none}});
+    check_codec_matches_default_traits<uint16_t, pair<uint16_t>>(
+        {{97, 31, 12, 2}, {0, 0, interleave_mode::sample, color_transformation::none}});
+    check_codec_matches_default_traits<uint16_t, triplet<uint16_t>>(
+        {{97, 31, 12, 3}, {0, 0, interleave_mode::sample, color_transformation::none}});
+    check_codec_matches_default_traits<uint16_t, quad<uint16_t>>(
+        {{97, 31, 12, 4}, {0, 0, interleave_mode::sample, color_transformation::none}});
+}
+
+TEST(make_scan_codec_test, decode_restart_intervals_with_conversion_thread)
+{
+    // The lines of the previous restart interval may still be waiting to be copied when the next interval starts.
+    for (int i{}; i != 10; ++i)
+    {
+        check_decode_with_conversion_thread({{97, 300, 8, 3}, {0, 1, interleave_mode::line, color_transformation::none}});
+        check_decode_with_conversion_thread({{97, 300, 8, 3}, {0, 3, interleave_mode::sample, color_transformation::hp1}});
+        check_decode_with_conversion_thread({{97, 300, 16, 4}, {0, 2, interleave_mode::sample, color_transformation::none}});
+    }
+}
+
+TEST(make_scan_codec_test, instruction_sets_give_identical_results_near_lossless)
+{
+    if (supported_instruction_set() != instruction_set::x86_64_v3)
+        GTEST_SKIP() << "CPU doesn't support the x86-64-v3 instruction set";
+
+    check_codecs_are_equivalent({{97, 31, 8, 1}, {3, 0, interleave_mode::none, color_transformation::none}});
+    check_codecs_are_equivalent({{97, 31, 10, 3}, {2, 0, interleave_mode::sample, color_transformation::none}});
+    check_codecs_are_equivalent({{97, 31, 16, 1}, {1, 8, interleave_mode::none, color_transformation::none}});
+}
+
+TEST(make_scan_codec_test, near_lossless_fast_paths_match_default_traits)
+{
+    for (int32_t near_lossless{1}; near_lossless <= 3; ++near_lossless)
+    {
+        check_codec_matches_default_traits<uint8_t, uint8_t>(
+            {{97, 31, 8, 1}, {near_lossless, 0, interleave_mode::none, color_transformation::none}});
+        check_codec_matches_default_traits<uint8_t, uint8_t>(
+            {{97, 31, 8, 3}, {near_lossless, 0, interleave_mode::line, color_transformation::none}});
+        check_codec_matches_default_traits<uint8_t, triplet<uint8_t>>(
+            {{97, 31, 8, 3}, {near_lossless, 0, interleave_mode::sample, color_transformation::none}});
+        check_codec_matches_default_traits<uint16_t, uint16_t>(
+            {{97, 31, 16, 1}, {near_lossless, 0, interleave_mode::none, color_transformation::none}});
+        check_codec_matches_default_traits<uint16_t, triplet<uint16_t>>(
+            {{97, 31, 16, 3}, {near_lossless, 0, interleave_mode::sample, color_transformation::none}});
+    }
+}
+
+} // namespace charls::test
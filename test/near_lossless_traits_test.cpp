@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: © 2026 Team CharLS
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "pch.hpp"
+
+#include "../src/default_traits.hpp"
+#include "../src/near_lossless_traits.hpp"
+
+
+namespace charls::test {
+
+namespace {
+
+template<int32_t Divisor>
+void check_reciprocal_divider()
+{
+    for (int32_t i{}; i <= 65535 + 2 * 3; ++i)
+    {
+        ASSERT_EQ(i / Divisor, reciprocal_divider<Divisor>::divide(i));
+    }
+}
+
+template<typename SampleType, int32_t Near>
+void check_traits_match_default_traits()
+{
+    using near_lossless_traits = near_lossless_traits<SampleType, SampleType, Near>;
+    const auto traits1{
+        default_traits<SampleType, SampleType>(near_lossless_traits::maximum_sample_value, Near)};
+
+    EXPECT_EQ(traits1.limit, near_lossless_traits::limit);
+    EXPECT_EQ(traits1.maximum_sample_value, near_lossless_traits::maximum_sample_value);
+    EXPECT_EQ(traits1.near_lossless, near_lossless_traits::near_lossless);
+    EXPECT_EQ(traits1.range, near_lossless_traits::range);
+    EXPECT_EQ(traits1.bits_per_sample, near_lossless_traits::bits_per_sample);
+    EXPECT_EQ(traits1.quantized_bits_per_sample, near_lossless_traits::quantized_bits_per_sample);
+
+    constexpr int32_t maximum_sample_value{near_lossless_traits::maximum_sample_value};
+    for (int32_t i{-maximum_sample_value}; i <= maximum_sample_value; ++i)
+    {
+        ASSERT_EQ(traits1.compute_error_value(i), near_lossless_traits::compute_error_value(i));
+        ASSERT_EQ(traits1.correct_prediction(i), near_lossless_traits::correct_prediction(i));
+        ASSERT_EQ(traits1.is_near(i, 2), near_lossless_traits::is_near(i, 2));
+    }
+
+    for (int32_t i{-near_lossless_traits::range}; i <= near_lossless_traits::range; ++i)
+    {
+        ASSERT_EQ(traits1.modulo_range(i), near_lossless_traits::modulo_range(i));
+    }
+
+    for (const int32_t predicted_value : {0, 1, maximum_sample_value / 2, maximum_sample_value - 1, maximum_sample_value})
+    {
+        for (int32_t error_value{-near_lossless_traits::range / 2}; error_value <= near_lossless_traits::range / 2;
+             ++error_value)
+        {
+            ASSERT_EQ(traits1.compute_reconstructed_sample(predicted_value, error_value),
+                      near_lossless_traits::compute_reconstructed_sample(predicted_value, error_value));
+        }
+    }
+}
+
+} // namespace
+
+
+TEST(near_lossless_traits_test, reciprocal_divider_is_exact)
+{
+    check_reciprocal_divider<3>();
+    check_reciprocal_divider<5>();
+    check_reciprocal_divider<7>();
+}
+
+TEST(near_lossless_traits_test, test_traits_8_bit)
+{
+    check_traits_match_default_traits<uint8_t, 1>();
+    check_traits_match_default_traits<uint8_t, 2>();
+    check_traits_match_default_traits<uint8_t, 3>();
+}
+
+TEST(near_lossless_traits_test, test_traits_16_bit)
+{
+    check_traits_match_default_traits<uint16_t, 1>();
+    check_traits_match_default_traits<uint16_t, 2>();
+    check_traits_match_default_traits<uint16_t, 3>();
+}
+
+} // namespace charls::test
@@ -34,6 +34,8 @@ TEST(sample_traits_test, basics)
     static_assert(std::is_same_v<sample_traits_t<lossless_traits<pair<uint16_t>, 16>>, lossless_traits<uint16_t, 16>>);
     static_assert(std::is_same_v<sample_traits_t<lossless_traits<triplet<uint16_t>, 16>>, lossless_traits<uint16_t, 16>>);
     static_assert(std::is_same_v<sample_traits_t<lossless_traits<quad<uint16_t>, 16>>, lossless_traits<uint16_t, 16>>);
+    static_assert(std::is_same_v<sample_traits_t<lossless_traits<triplet<uint16_t>, 10>>, lossless_traits<uint16_t, 10>>);
+    static_assert(std::is_same_v<sample_traits_t<lossless_traits<quad<uint16_t>, 12>>, lossless_traits<uint16_t, 12>>);
 
     // sample_traits_t: default_traits<S, S> is identity.
     static_assert(std::is_same_v<sample_traits_t<default_traits<uint8_t, uint8_t>>, default_traits<uint8_t, uint8_t>>);
@@ -51,6 +53,14 @@ TEST(sample_traits_test, basics)
     static_assert(
         std::is_same_v<sample_traits_t<default_traits<uint16_t, quad<uint16_t>>>, default_traits<uint16_t, uint16_t>>);
 
+    // near_lossless_traits: compound pixel types map to the scalar sample type with the same NEAR.
+    static_assert(std::is_same_v<sample_traits_t<near_lossless_traits<uint8_t, uint8_t, 2>>,
+                                 near_lossless_traits<uint8_t, uint8_t, 2>>);
+    static_assert(std::is_same_v<sample_traits_t<near_lossless_traits<uint8_t, triplet<uint8_t>, 1>>,
+                                 near_lossless_traits<uint8_t, uint8_t, 1>>);
+    static_assert(std::is_same_v<sample_traits_t<near_lossless_traits<uint16_t, triplet<uint16_t>, 3>>,
+                                 near_lossless_traits<uint16_t, uint16_t, 3>>);
+
     // make_sample_traits: scalar lossless_traits returns the same instance (identity).
     {
         constexpr lossless_traits<uint8_t, 8> traits;
@@ -84,6 +94,14 @@ TEST(sample_traits_test, basics)
         EXPECT_TRUE(sample_traits.maximum_sample_value == 4095);
         EXPECT_TRUE(sample_traits.near_lossless == 0);
     }
+
+    // make_sample_traits: compound near_lossless_traits returns default-constructed scalar instance.
+    {
+        constexpr near_lossless_traits<uint8_t, triplet<uint8_t>, 2> traits;
+        [[maybe_unused]]
+        const auto sample_traits{make_sample_traits(traits)};
+        static_assert(std::is_same_v<decltype(sample_traits), const near_lossless_traits<uint8_t, uint8_t, 2>>);
+    }
 }
 
 } // namespace charls::test
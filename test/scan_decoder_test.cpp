@@ -5,11 +5,14 @@
 
 #include "support.hpp"
 
+#include "../src/jpeg_marker_scanner.hpp"
 #include "../src/scan_decoder.hpp"
 
 #include "scan_encoder_tester.hpp"
 
 #include <array>
+#include <random>
+#include <vector>
 
 using std::array;
 using std::byte;
@@ -23,14 +26,17 @@ class scan_decoder_tester final : public scan_decoder
 public:
     scan_decoder_tester(const charls::frame_info& frame_info, const coding_parameters& parameters, byte* const destination,
                         const size_t count) :
-        scan_decoder(frame_info, {}, parameters)
+        scan_decoder(frame_info, {}, parameters, default_memory_resource())
     {
         initialize({destination, count});
     }
 
-    size_t decode_scan(span<const byte> /*source*/, byte* /*destination*/, size_t /*stride*/) noexcept(false) override
+    void decode_lines(byte* /*destination*/, size_t /*stride*/, uint32_t /*line_count*/) noexcept(false) override
+    {
+    }
+
+    void use_conversion_thread(bool /*enable*/) noexcept(false) override
     {
-        return {};
     }
 
     [[nodiscard]]
@@ -170,4 +176,40 @@ TEST(scan_decoder_test, initialize_with_empty_buffer_throws_invalid_data)
     });
 }
 
+TEST(scan_decoder_test, ff_byte_index_finds_all_ff_bytes)
+{
+    // Use more than 1 block (64 KiB) and regions with more 0xFF bytes than fit in the index at once.
+    std::vector<byte> source(200'003);
+    std::mt19937 generator(7);
+    for (size_t i{}; i != source.size(); ++i)
+    {
+        const bool dense_region{i >= 70'000 && i < 80'000};
+        source[i] = dense_region || generator() % 64 == 0 ? byte{0xFF} : static_cast<byte>(generator() % 255);
+    }
+
+    ff_byte_index index;
+    index.reset({source.data(), source.size()});
+
+    const byte* position{source.data()};
+    for (size_t i{}; i != source.size(); ++i)
+    {
+        if (source[i] != byte{0xFF})
+            continue;
+
+        const byte* ff_position{index.find(position)};
+        ASSERT_EQ(static_cast<ptrdiff_t>(i), ff_position - source.data());
+        position = ff_position + 1;
+    }
+
+    EXPECT_EQ(source.data() + source.size(), index.find(position));
+}
+
+TEST(scan_decoder_test, ff_byte_index_empty_source)
+{
+    ff_byte_index index;
+    index.reset({});
+
+    EXPECT_EQ(nullptr, index.find(nullptr));
+}
+
 } // namespace charls::test
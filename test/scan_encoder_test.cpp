@@ -7,12 +7,46 @@
 #include "support.hpp"
 
 #include <array>
+#include <random>
+#include <vector>
 
 using std::array;
 using std::byte;
+using std::vector;
 
 namespace charls::test {
 
+namespace {
+
+/// <summary>
+/// Reference implementation of the bit stuffing: packs the bits in bytes and after every 0xFF byte
+/// the next byte only contains 7 bits (its most significant bit is 0). The last byte is padded with 0 bits.
+/// </summary>
+vector<byte> create_stuffed_bytes(const vector<bool>& bits)
+{
+    vector<byte> result;
+    for (size_t i{}; i < bits.size();)
+    {
+        const int bit_count{!result.empty() && result.back() == byte{0xFF} ? 7 : 8};
+        uint32_t value{};
+        for (int j{}; j != bit_count; ++j, ++i)
+        {
+            value = (value << 1) | (i < bits.size() && bits[i] ? 1U : 0U);
+        }
+        result.push_back(static_cast<byte>(value));
+    }
+
+    if (!result.empty() && result.back() == byte{0xFF})
+    {
+        result.push_back(byte{});
+    }
+
+    return result;
+}
+
+} // namespace
+
+
 TEST(scan_encoder_test, append_to_bit_stream_zero_length)
 {
     constexpr frame_info frame_info{1, 1, 8, 1};
@@ -72,4 +106,38 @@ TEST(scan_encoder_test, append_to_bit_stream_ff_pattern)
     EXPECT_EQ(byte{0x77}, destination[13]);
 }
 
+TEST(scan_encoder_test, append_to_bit_stream_matches_reference_bit_stuffing)
+{
+    constexpr frame_info frame_info{1, 1, 8, 1};
+    constexpr coding_parameters parameters{};
+
+    std::mt19937_64 generator(42);
+    for (int run{}; run != 20; ++run)
+    {
+        scan_encoder_tester scan_encoder(frame_info, parameters);
+        vector<byte> destination(4096);
+        scan_encoder.initialize_forward({destination.data(), destination.size()});
+
+        // Use many set bits to create 0xFF bytes at all positions of the 64 bit buffer.
+        vector<bool> bits;
+        while (bits.size() < 20000)
+        {
+            const auto bit_count{static_cast<int32_t>(1 + generator() % 56)};
+            const uint64_t mask{(uint64_t{1} << bit_count) - 1};
+            const uint64_t value{(generator() % 4 == 0 ? generator() : ~uint64_t{}) & mask};
+            scan_encoder.append_to_bit_stream_forward(value, bit_count);
+            for (int32_t i{bit_count - 1}; i >= 0; --i)
+            {
+                bits.push_back(((value >> i) & 1) != 0);
+            }
+        }
+        scan_encoder.end_scan_forward();
+
+        const vector<byte> expected{create_stuffed_bytes(bits)};
+        ASSERT_EQ(expected.size(), scan_encoder.get_length_forward());
+        destination.resize(expected.size());
+        ASSERT_EQ(expected, destination);
+    }
+}
+
 } // namespace charls::test
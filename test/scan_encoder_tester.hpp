@@ -11,13 +11,16 @@ class scan_encoder_tester final : public scan_encoder
 {
 public:
     explicit scan_encoder_tester(const charls::frame_info& frame_info, const coding_parameters& parameters) noexcept :
-        scan_encoder(frame_info, {}, parameters, nullptr)
+        scan_encoder(frame_info, {}, parameters, nullptr, default_memory_resource())
     {
     }
 
-    size_t encode_scan(const std::byte* /*source*/, size_t /*stride*/, span<std::byte>) noexcept(false) override
+    void encode_lines(const std::byte* /*source*/, size_t /*stride*/, uint32_t /*line_count*/) noexcept(false) override
+    {
+    }
+
+    void use_conversion_thread(bool /*enable*/) noexcept(false) override
     {
-        return 0;
     }
 
     void initialize_forward(const span<std::byte> destination) noexcept
@@ -25,7 +28,7 @@ public:
         initialize(destination);
     }
 
-    void append_to_bit_stream_forward(const uint32_t bits, const int32_t bit_count)
+    void append_to_bit_stream_forward(const uint64_t bits, const int32_t bit_count)
     {
         append_to_bit_stream(bits, bit_count);
     }
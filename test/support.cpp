@@ -249,5 +249,23 @@ void test_compliance(const vector<byte>& encoded_source, const vector<byte>& unc
     }
 }
 
+void* CHARLS_API_CALLING_CONVENTION counting_allocate(const size_t size, size_t /*alignment*/,
+                                                     void* user_context) noexcept
+{
+    auto& statistics{*static_cast<allocation_statistics*>(user_context)};
+    if (statistics.allocation_count == statistics.allocation_limit)
+        return nullptr;
+
+    ++statistics.allocation_count;
+    statistics.allocated_size += size;
+    return ::operator new(size, std::nothrow);
+}
+
+void CHARLS_API_CALLING_CONVENTION counting_deallocate(void* pointer, const size_t size, void* user_context) noexcept
+{
+    static_cast<allocation_statistics*>(user_context)->allocated_size -= size;
+    ::operator delete(pointer);
+}
+
 
 } // namespace charls::test
@@ -10,6 +10,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <vector>
 
 namespace charls::test {
@@ -36,6 +37,24 @@ void test_compliance(const std::vector<std::byte>& encoded_source, const std::ve
 
 void decode_encode_file(const char* encoded_filename, const char* raw_filename, bool check_encode = true);
 
+/// <summary>
+/// Tracks the memory that is allocated with counting_allocate and released with counting_deallocate.
+/// </summary>
+struct allocation_statistics final
+{
+    size_t allocation_count{};
+    size_t allocated_size{};
+    size_t allocation_limit{std::numeric_limits<size_t>::max()};
+};
+
+/// <summary>
+/// Allocation function for the allocator API; user_context must point to an allocation_statistics instance.
+/// Returns nullptr when the allocation limit has been reached.
+/// </summary>
+void* CHARLS_API_CALLING_CONVENTION counting_allocate(size_t size, size_t alignment, void* user_context) noexcept;
+
+void CHARLS_API_CALLING_CONVENTION counting_deallocate(void* pointer, size_t size, void* user_context) noexcept;
+
 template<typename Functor>
 void assert_expect_exception(const jpegls_errc error_value, Functor functor)
 {